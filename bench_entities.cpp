@@ -0,0 +1,190 @@
+#include "gameengine.h"
+#include "entity_store.h"
+#include "character.h"
+#include "mob.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float DELTA_TIME = 1.0f / 60.0f;
+
+// Adding entities to an engine logs each one, and mobs log every tick.
+// Without a buffer the stream fails every write before formatting anything.
+struct QuietConsole {
+    std::streambuf* previous;
+    QuietConsole() : previous(std::cout.rdbuf(nullptr)) {}
+    ~QuietConsole() { std::cout.rdbuf(previous); }
+};
+
+// Same seed, same population: positions and velocities in a 1 km square, a
+// tenth of them rooted and every character a little short of mana
+template <typename Entity>
+void scatter(Entity& entity, std::mt19937& rng, int index) {
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    std::uniform_real_distribution<double> speed(-5.0, 5.0);
+    entity.setPosition(coordinate(rng), coordinate(rng), 0.0);
+    entity.setVelocity(Position(speed(rng), speed(rng), 0.0));
+    entity.setRooted(index % 10 == 0);
+    entity.consumeMana(1);
+}
+
+std::vector<Character> makeCharacters(int count) {
+    std::vector<Character> characters;
+    characters.reserve(count);
+    std::mt19937 rng(7);
+    for (int i = 0; i < count; i++) {
+        characters.emplace_back("Hero" + std::to_string(i), Race::createHuman(), Class::createMage());
+        scatter(characters.back(), rng, i);
+    }
+    return characters;
+}
+
+std::vector<Mob> makeMobs(int count) {
+    std::vector<Mob> mobs;
+    mobs.reserve(count);
+    std::mt19937 rng(11);
+    for (int i = 0; i < count; i++) {
+        mobs.emplace_back(Race::createGoblin());
+        scatter(mobs.back(), rng, i);
+    }
+    return mobs;
+}
+
+// The per-object pass: every entity is visited through its class, dragging
+// names, stat blocks, ability lists and inventories through the cache
+template <typename Entity>
+void objectPass(std::vector<Entity>& entities, float deltaTime) {
+    for (Entity& entity : entities) {
+        if (!entity.getIsStunned() && !entity.getIsRooted()) {
+            Position velocity = entity.getVelocity();
+            entity.move(velocity.getX() * deltaTime, velocity.getY() * deltaTime, velocity.getZ() * deltaTime);
+        }
+        entity.restoreMana(1);
+    }
+}
+
+// The same work over the store's columns
+void storePass(EntityStore& store, float deltaTime) {
+    const uint8_t immobile = StatusFlag::STUNNED | StatusFlag::ROOTED;
+    store.forEachArchetype(Component::TRANSFORM | Component::VELOCITY | Component::STATUS,
+                           [deltaTime, immobile](Archetype& archetype) {
+        for (size_t row = 0; row < archetype.size(); ++row) {
+            if (archetype.status[row] & immobile) continue;
+            const Position& velocity = archetype.velocities[row];
+            archetype.positions[row].move(velocity.getX() * deltaTime, velocity.getY() * deltaTime,
+                                          velocity.getZ() * deltaTime);
+        }
+    });
+    store.forEachArchetype(Component::VITALS, [](Archetype& archetype) {
+        for (Vitals& vitals : archetype.vitals) {
+            vitals.mana = std::min<welltype>(vitals.mana + 1, vitals.maxMana);
+        }
+    });
+}
+
+template <typename Entity>
+double checksum(const std::vector<Entity>& entities) {
+    double sum = 0.0;
+    for (const Entity& entity : entities) {
+        Position position = entity.getPosition();
+        sum += position.getX() * 3.0 + position.getY() * 7.0 + entity.getStats().getMana();
+    }
+    return sum;
+}
+
+template <typename Pass>
+double nanosecondsPerEntity(Pass pass, int passes, size_t entities) {
+    pass();  // Warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < passes; i++) {
+        pass();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(passes) * entities);
+}
+
+void benchmarkLayouts(int charactersCount, int mobsCount, int passes) {
+    size_t total = static_cast<size_t>(charactersCount + mobsCount);
+    double objectNs = 0.0, storeNs = 0.0;
+    double objectSum = 0.0, storeSum = 0.0;
+
+    {
+        auto characters = makeCharacters(charactersCount);
+        auto mobs = makeMobs(mobsCount);
+        objectNs = nanosecondsPerEntity([&]() {
+            objectPass(characters, DELTA_TIME);
+            objectPass(mobs, DELTA_TIME);
+        }, passes, total);
+        objectSum = checksum(characters) + checksum(mobs);
+    }
+    {
+        EntityStore store;  // Outlives the entities attached to it
+        auto characters = makeCharacters(charactersCount);
+        auto mobs = makeMobs(mobsCount);
+        for (Character& character : characters) character.attachToStore(store);
+        for (Mob& mob : mobs) mob.attachToStore(store);
+        storeNs = nanosecondsPerEntity([&]() { storePass(store, DELTA_TIME); }, passes, total);
+        storeSum = checksum(characters) + checksum(mobs);
+    }
+
+    std::cout << std::setw(16) << "object loop" << std::setw(14) << std::fixed << std::setprecision(2)
+              << objectNs << std::setw(16) << std::setprecision(2) << objectNs * total / 1e6 << std::endl;
+    std::cout << std::setw(16) << "entity store" << std::setw(14) << storeNs
+              << std::setw(16) << storeNs * total / 1e6 << std::endl;
+    std::cout << "speedup " << std::setprecision(1) << objectNs / storeNs << "x, same result: "
+              << (objectSum == storeSum ? "yes" : "NO") << std::endl;
+}
+
+// A full headless engine tick over the same population, broken down by system
+void benchmarkEngine(int charactersCount, int mobsCount, int ticks) {
+    std::vector<SystemTiming> timings;
+    double ticksPerSecond = 0.0;
+    {
+        QuietConsole quiet;
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        std::mt19937 rng(7);
+        for (int i = 0; i < charactersCount; i++) {
+            Character character("Hero" + std::to_string(i), Race::createHuman(), Class::createMage());
+            scatter(character, rng, i);
+            engine.addCharacter(character);
+        }
+        for (int i = 0; i < mobsCount; i++) {
+            Mob mob(Race::createGoblin());
+            scatter(mob, rng, i);
+            engine.addMob(mob);
+        }
+
+        engine.runTicks(2);  // Warm up
+        ticksPerSecond = engine.runTicks(ticks);
+        timings = engine.getSystemTimings();
+    }
+
+    std::cout << "tick: " << std::setprecision(3) << 1000.0 / ticksPerSecond << " ms ("
+              << std::setprecision(0) << ticksPerSecond << " ticks/s)" << std::endl;
+    for (const SystemTiming& timing : timings) {
+        std::cout << std::setw(28) << timing.name << std::setw(10) << std::setprecision(3)
+                  << timing.milliseconds << " ms" << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    const int charactersCount = 50000;
+    const int mobsCount = 50000;
+
+    std::cout << "\n=== Movement and mana regen: " << charactersCount << " characters, " << mobsCount
+              << " mobs ===" << std::endl;
+    std::cout << std::setw(16) << "layout" << std::setw(14) << "ns/entity" << std::setw(16) << "ms/pass" << std::endl;
+    benchmarkLayouts(charactersCount, mobsCount, 100);
+
+    std::cout << "\n=== Headless engine tick: " << charactersCount + mobsCount << " entities ===" << std::endl;
+    benchmarkEngine(charactersCount, mobsCount, 60);
+    return 0;
+}
@@ -0,0 +1,811 @@
+#include "physics_system.h"
+#include "job_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Scatters bodies at a constant density over a world that grows with the count
+std::vector<std::shared_ptr<PhysicsBody>> populate(PhysicsSystem& physics, int count, unsigned seed) {
+    const double height = 20.0;
+    const double extent = std::sqrt(count * 5.0);
+
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f, Position(extent, extent, height));
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> horizontal(0.0, extent);
+    std::uniform_real_distribution<double> vertical(0.0, height);
+    std::uniform_real_distribution<double> speed(-2.0, 2.0);
+
+    std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    bodies.reserve(count);
+    for (int i = 0; i < count; i++) {
+        auto body = physics.createBody(Position(horizontal(rng), horizontal(rng), vertical(rng)));
+        body->velocity = Position(speed(rng), speed(rng), 0.0);
+        bodies.push_back(body);
+    }
+    return bodies;
+}
+
+void benchmarkBroadphase(int count) {
+    PhysicsSystem physics;
+    auto bodies = populate(physics, count, 42);
+
+    const int steps = 20;
+    physics.update(1.0f / 60.0f);  // Warm up
+
+    auto start = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        physics.update(1.0f / 60.0f);
+    }
+    double stepMs = elapsedMs(start) / steps;
+    const PhysicsStepStats& stats = physics.getLastStepStats();
+
+    size_t bruteForceTests = static_cast<size_t>(count) * (count - 1) / 2;
+    std::cout << std::setw(7) << count
+              << std::setw(14) << stats.narrowphaseTests
+              << std::setw(16) << bruteForceTests
+              << std::setw(10) << stats.contacts
+              << std::setw(12) << std::fixed << std::setprecision(3) << stepMs;
+
+    // The quadratic loop is only timed where it finishes in reasonable time
+    if (count <= 10000) {
+        auto bruteStart = Clock::now();
+        size_t contacts = 0;
+        for (size_t i = 0; i < bodies.size(); i++) {
+            for (size_t j = i + 1; j < bodies.size(); j++) {
+                if (physics.checkCollision(bodies[i].get(), bodies[j].get())) contacts++;
+            }
+        }
+        std::cout << std::setw(16) << elapsedMs(bruteStart);
+        if (contacts != stats.contacts) std::cout << "  (contact mismatch: " << contacts << ")";
+    } else {
+        std::cout << std::setw(16) << "skipped";
+    }
+    std::cout << std::endl;
+}
+
+// Bodies of mixed size, either spread evenly or packed into a few dense
+// clusters, with some of them outside the grid bounds
+std::vector<std::shared_ptr<PhysicsBody>> populateMixed(PhysicsSystem& physics, int count, bool clustered, unsigned seed) {
+    const double extent = 400.0;
+
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f, Position(extent, extent, 20.0));
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> horizontal(-50.0, extent + 50.0);
+    std::uniform_real_distribution<double> vertical(0.0, 20.0);
+    std::normal_distribution<double> spread(0.0, 12.0);
+    std::uniform_real_distribution<double> speed(-2.0, 2.0);
+    std::uniform_int_distribution<int> sizeRoll(0, 99);
+
+    std::vector<Position> clusterCenters;
+    for (int i = 0; i < 8; i++) {
+        clusterCenters.emplace_back(horizontal(rng), horizontal(rng), 10.0);
+    }
+
+    std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    bodies.reserve(count);
+    for (int i = 0; i < count; i++) {
+        Position position(horizontal(rng), horizontal(rng), vertical(rng));
+        if (clustered) {
+            const Position& center = clusterCenters[i % clusterCenters.size()];
+            position = Position(center.getX() + spread(rng), center.getY() + spread(rng), vertical(rng));
+        }
+
+        // Mostly kobold-sized bodies with the occasional dragon
+        float radius = sizeRoll(rng) < 2 ? 6.0f : 0.5f;
+
+        auto body = physics.createBody(position);
+        physics.setBodyCollider(body, std::make_shared<SphereCollider>(position, radius));
+        body->velocity = Position(speed(rng), speed(rng), 0.0);
+        bodies.push_back(body);
+    }
+    return bodies;
+}
+
+void benchmarkBroadphaseType(BroadphaseType type, const char* layout, bool clustered, int count) {
+    PhysicsSystem physics(type);
+    auto bodies = populateMixed(physics, count, clustered, 7);
+
+    const int steps = 20;
+    physics.update(1.0f / 60.0f);  // Warm up
+
+    auto start = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        physics.update(1.0f / 60.0f);
+    }
+    double stepMs = elapsedMs(start) / steps;
+    const PhysicsStepStats& stats = physics.getLastStepStats();
+
+    std::cout << std::setw(11) << layout
+              << std::setw(16) << (type == BroadphaseType::UNIFORM_GRID ? "uniform grid" : "sort and sweep")
+              << std::setw(14) << stats.narrowphaseTests
+              << std::setw(10) << stats.contacts
+              << std::setw(12) << std::fixed << std::setprecision(3) << stepMs << std::endl;
+}
+
+void benchmarkOpenWorld(int count, double zoneSize) {
+    PhysicsSystem physics;
+    physics.setGravity(0.0f);
+    physics.setGridParameters(10.0f);
+
+    // A handful of camps in a mostly empty zone
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> zone(0.0, zoneSize);
+    std::normal_distribution<double> camp(0.0, 15.0);
+    std::vector<Position> camps;
+    for (int i = 0; i < 40; i++) {
+        camps.emplace_back(zone(rng), zone(rng), 0.0);
+    }
+    for (int i = 0; i < count; i++) {
+        const Position& center = camps[i % camps.size()];
+        physics.createBody(Position(center.getX() + camp(rng), center.getY() + camp(rng), 0.0));
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < 20; i++) {
+        physics.update(1.0f / 60.0f);
+    }
+    double stepMs = elapsedMs(start) / 20;
+
+    const SpatialHash& hash = physics.getSpatialHash();
+    double denseCells = (zoneSize / 10.0) * (zoneSize / 10.0) * 3.0;
+    std::cout << "Zone: " << static_cast<int>(zoneSize / 1000.0) << " km square, " << count << " bodies" << std::endl;
+    std::cout << "  occupied cells: " << hash.getOccupiedCellCount()
+              << " (dense grid would allocate " << static_cast<size_t>(denseCells) << ")" << std::endl;
+    std::cout << "  hash memory: " << hash.getMemoryUsage() / 1024 << " KiB (dense grid cells alone: "
+              << static_cast<size_t>(denseCells * sizeof(std::vector<size_t>) / 1024) << " KiB)" << std::endl;
+    std::cout << "  step ms: " << std::fixed << std::setprecision(3) << stepMs << std::endl;
+}
+
+// A dungeon where most mobs idle in packs and a few wander
+void benchmarkSleeping(int count, bool sleeping) {
+    PhysicsSystem physics;
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f);
+    physics.setSleepingEnabled(sleeping);
+    
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> room(0.0, 600.0);
+    std::uniform_real_distribution<double> offset(-1.5, 1.5);
+    std::uniform_real_distribution<double> speed(-3.0, 3.0);
+    
+    std::vector<BodyHandle> wanderers;
+    for (int i = 0; i < count; i += 4) {
+        Position den(room(rng), room(rng), 0.0);
+        for (int j = 0; j < 4 && i + j < count; j++) {
+            BodyHandle handle = physics.spawnBody(den + Position(offset(rng), offset(rng), 0.0));
+            if ((i + j) % 20 == 0) wanderers.push_back(handle);
+        }
+    }
+    
+    // Let the idle packs settle, then time steps with the wanderers moving
+    for (int i = 0; i < 60; i++) {
+        physics.update(1.0f / 60.0f);
+    }
+    const int steps = 20;
+    auto start = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        for (BodyHandle handle : wanderers) {
+            physics.applyImpulse(handle, Position(speed(rng), speed(rng), 0.0) * 0.1);
+        }
+        physics.update(1.0f / 60.0f);
+    }
+    double stepMs = elapsedMs(start) / steps;
+    const PhysicsStepStats& stats = physics.getLastStepStats();
+    
+    std::cout << std::setw(10) << (sleeping ? "on" : "off")
+              << std::setw(10) << stats.sleepingBodies
+              << std::setw(14) << stats.narrowphaseTests
+              << std::setw(12) << std::fixed << std::setprecision(3) << stepMs << std::endl;
+}
+
+// Body as it was before pooling, with its collider in a separate heap block
+struct SharedBody : PhysicsBody {
+    std::shared_ptr<Collider> collider;
+};
+
+// Replica of the integration loop before bodies were pooled: one heap block per
+// body, reached through a vector of shared_ptr and passed by value to each helper
+struct SharedBodyLoop {
+    std::vector<std::shared_ptr<SharedBody>> bodies;
+    
+    static void applyForces(std::shared_ptr<SharedBody> body, float deltaTime) {
+        body->acceleration = body->force * body->invMass;
+        body->velocity = body->velocity + body->acceleration * deltaTime;
+        body->force = Position(0, 0, 0);
+    }
+    
+    static void integrateVelocity(std::shared_ptr<SharedBody> body, float deltaTime) {
+        body->position = body->position + body->velocity * deltaTime;
+        body->velocity = body->velocity * (1.0f - body->linearDamping * deltaTime);
+    }
+    
+    static void clampVelocity(std::shared_ptr<SharedBody> body) {
+        float velocityMagnitude = body->velocity.length();
+        if (velocityMagnitude > 50.0f) {
+            body->velocity = body->velocity.normalize() * 50.0f;
+        }
+        if (velocityMagnitude < 0.01f) {
+            body->velocity = Position(0, 0, 0);
+        }
+    }
+    
+    static void updateBodyTransform(std::shared_ptr<SharedBody> body) {
+        if (body->collider) body->collider->updateTransform(body->position);
+    }
+    
+    void step(float deltaTime) {
+        for (auto& body : bodies) {
+            if (!body->isActive || body->bodyType == BodyType::STATIC) continue;
+            applyForces(body, deltaTime);
+            integrateVelocity(body, deltaTime);
+            clampVelocity(body);
+            updateBodyTransform(body);
+        }
+    }
+};
+
+void benchmarkBodyStorage(int count) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+    std::uniform_real_distribution<double> speed(-2.0, 2.0);
+    
+    // Spawn and despawn in between, the way a live zone fragments the heap
+    SharedBodyLoop shared;
+    std::vector<std::shared_ptr<std::vector<char>>> churn;
+    for (int i = 0; i < count; i++) {
+        auto body = std::make_shared<SharedBody>();
+        body->position = Position(coord(rng), coord(rng), 0.0);
+        body->velocity = Position(speed(rng), speed(rng), 0.0);
+        body->collider = std::make_shared<SphereCollider>(body->position, 1.0f);
+        shared.bodies.push_back(body);
+        churn.push_back(std::make_shared<std::vector<char>>(64 + i % 512));
+    }
+    churn.clear();
+    std::shuffle(shared.bodies.begin(), shared.bodies.end(), rng);
+    
+    PhysicsSystem physics;
+    physics.setGravity(0.0f);
+    for (const auto& body : shared.bodies) {
+        BodyHandle handle = physics.spawnBody(body->position);
+        physics.getBody(handle)->velocity = body->velocity;
+    }
+    
+    const int steps = 50;
+    auto sharedStart = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        shared.step(1.0f / 60.0f);
+    }
+    double sharedMs = elapsedMs(sharedStart) / steps;
+    
+    auto pooledStart = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        physics.simulatePhysics(1.0f / 60.0f);
+    }
+    double pooledMs = elapsedMs(pooledStart) / steps;
+    
+    std::cout << std::setw(7) << count
+              << std::setw(16) << std::fixed << std::setprecision(3) << sharedMs
+              << std::setw(14) << pooledMs
+              << std::setw(10) << std::setprecision(2) << sharedMs / pooledMs << "x" << std::endl;
+}
+
+// Replica of the narrowphase before shapes were stored inline: a virtual call
+// per pair that then discovers the other collider's type with dynamic_cast
+class LegacyCollider {
+public:
+    Position center;
+    explicit LegacyCollider(const Position& c) : center(c) {}
+    virtual ~LegacyCollider() = default;
+    virtual bool checkCollision(const LegacyCollider* other) const = 0;
+};
+
+class LegacyBox;
+
+class LegacySphere : public LegacyCollider {
+public:
+    float radius;
+    LegacySphere(const Position& c, float r) : LegacyCollider(c), radius(r) {}
+    bool checkCollision(const LegacyCollider* other) const override;
+};
+
+class LegacyBox : public LegacyCollider {
+public:
+    Position halfExtents;
+    LegacyBox(const Position& c, const Position& h) : LegacyCollider(c), halfExtents(h) {}
+    bool checkCollision(const LegacyCollider* other) const override {
+        if (const LegacyBox* box = dynamic_cast<const LegacyBox*>(other)) {
+            return testAABBAABB(center, ColliderShape::box(halfExtents), box->center, ColliderShape::box(box->halfExtents));
+        } else if (const LegacySphere* sphere = dynamic_cast<const LegacySphere*>(other)) {
+            return sphere->checkCollision(this);
+        }
+        return false;
+    }
+};
+
+bool LegacySphere::checkCollision(const LegacyCollider* other) const {
+    if (const LegacySphere* sphere = dynamic_cast<const LegacySphere*>(other)) {
+        return center.distanceTo(sphere->center) < radius + sphere->radius;
+    } else if (const LegacyBox* box = dynamic_cast<const LegacyBox*>(other)) {
+        return testSphereAABB(center, ColliderShape::sphere(radius), box->center, ColliderShape::box(box->halfExtents));
+    }
+    return false;
+}
+
+void benchmarkNarrowphase(int count) {
+    PhysicsSystem physics;
+    auto bodies = populateMixed(physics, count, true, 9);
+    
+    // Every fourth body becomes a crate
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (i % 4 == 0) {
+            physics.setBodyShape(bodies[i]->handle, ColliderShape::box(Position(0.5, 0.5, 1.0)));
+        }
+    }
+    physics.update(1.0f / 60.0f);
+    physics.updateSpatialGrid();
+    physics.buildCandidatePairs();
+    
+    // Legacy colliders for exactly the same candidate pairs
+    std::vector<std::pair<const LegacyCollider*, const LegacyCollider*>> legacyPairs;
+    std::unordered_map<const PhysicsBody*, std::unique_ptr<LegacyCollider>> owned;
+    auto legacyFor = [&owned](const PhysicsBody* body) -> const LegacyCollider* {
+        std::unique_ptr<LegacyCollider>& collider = owned[body];
+        if (!collider) {
+            if (body->shape.type == ShapeType::AABB) {
+                collider.reset(new LegacyBox(body->position, body->shape.halfExtents));
+            } else {
+                collider.reset(new LegacySphere(body->position, body->shape.radius));
+            }
+        }
+        return collider.get();
+    };
+    for (const BodyPair& pair : physics.getCandidatePairs()) {
+        legacyPairs.emplace_back(legacyFor(pair.first), legacyFor(pair.second));
+    }
+    
+    const int rounds = 20;
+    auto legacyStart = Clock::now();
+    size_t legacyContacts = 0;
+    for (int round = 0; round < rounds; round++) {
+        legacyContacts = 0;
+        for (const auto& pair : legacyPairs) {
+            if (pair.first->checkCollision(pair.second)) legacyContacts++;
+        }
+    }
+    double legacyMs = elapsedMs(legacyStart) / rounds;
+    
+    auto tableStart = Clock::now();
+    for (int round = 0; round < rounds; round++) {
+        physics.detectCollisions();
+    }
+    double tableMs = elapsedMs(tableStart) / rounds;
+    
+    std::cout << std::setw(11) << legacyPairs.size()
+              << std::setw(10) << physics.getLastStepStats().contacts
+              << std::setw(18) << std::fixed << std::setprecision(3) << legacyMs
+              << std::setw(16) << tableMs;
+    if (legacyContacts != physics.getLastStepStats().contacts) {
+        std::cout << "  (contact mismatch: " << legacyContacts << ")";
+    }
+    std::cout << std::endl;
+}
+
+// The raycast this replaced: every body in pool order, first bounding-sphere hit wins
+bool legacyRaycast(const std::vector<const PhysicsBody*>& bodies, const Position& start, const Position& direction,
+                   float maxDistance, Position& hitPoint) {
+    for (const PhysicsBody* body : bodies) {
+        if (!body->isActive || body->shape.type == ShapeType::NONE) continue;
+        
+        Position toCenter = body->position - start;
+        double projection = toCenter.dot(direction);
+        if (projection < 0) continue;
+        
+        double closestApproach = toCenter.dot(toCenter) - projection * projection;
+        double radiusSquared = body->shape.radius * body->shape.radius;
+        if (closestApproach > radiusSquared) continue;
+        
+        double distance = projection - std::sqrt(radiusSquared - closestApproach);
+        if (distance > 0 && distance <= maxDistance) {
+            hitPoint = start + direction.normalize() * distance;
+            return true;
+        }
+    }
+    return false;
+}
+
+// AI line-of-sight checks: rays from mobs toward points up to 30 units away
+void benchmarkRaycast(int count, int rayCount) {
+    PhysicsSystem physics;
+    auto bodies = populate(physics, count, 13);
+    physics.update(1.0f / 60.0f);
+    
+    std::vector<const PhysicsBody*> pool;
+    for (const auto& body : bodies) {
+        pool.push_back(body.get());
+    }
+    
+    std::mt19937 rng(29);
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    std::uniform_real_distribution<double> offset(-30.0, 30.0);
+    std::vector<Ray> rays;
+    for (int i = 0; i < rayCount; i++) {
+        Position from = bodies[pick(rng)]->position + Position(0.0, 0.0, 1.5);
+        Position to = from + Position(offset(rng), offset(rng), 0.0);
+        rays.emplace_back(from, to - from, static_cast<float>(from.distanceTo(to)));
+    }
+    
+    int legacyHits = 0;
+    auto start = Clock::now();
+    for (const Ray& ray : rays) {
+        Position point;
+        if (legacyRaycast(pool, ray.origin, ray.direction.normalize(), ray.maxDistance, point)) legacyHits++;
+    }
+    double legacyMs = elapsedMs(start);
+    
+    // The first query after a step refreshes the grid; keep that out of both timings
+    RayHit warmUp;
+    physics.raycast(rays[0], warmUp);
+    
+    int gridHits = 0;
+    start = Clock::now();
+    for (const Ray& ray : rays) {
+        RayHit hit;
+        if (physics.raycast(ray, hit)) gridHits++;
+    }
+    double gridMs = elapsedMs(start);
+    
+    std::vector<RayHit> hits;
+    start = Clock::now();
+    physics.raycastBatch(rays, hits);
+    double batchMs = elapsedMs(start);
+    
+    auto raysPerSecond = [rayCount](double ms) { return rayCount / (ms / 1000.0); };
+    std::cout << std::setw(7) << count
+              << std::setw(7) << rayCount
+              << std::setw(14) << std::fixed << std::setprecision(0) << raysPerSecond(legacyMs)
+              << std::setw(14) << raysPerSecond(gridMs)
+              << std::setw(14) << raysPerSecond(batchMs)
+              << std::setw(9) << std::setprecision(1) << legacyMs / batchMs << "x"
+              << std::setw(11) << legacyHits << " / " << gridHits << std::endl;
+}
+
+// Ability and AI area checks: radius queries around random bodies
+void benchmarkAreaQueries(int count, int queryCount, float radius) {
+    PhysicsSystem physics;
+    auto bodies = populate(physics, count, 19);
+    physics.update(1.0f / 60.0f);
+    
+    std::mt19937 rng(37);
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    std::vector<Position> centers;
+    for (int i = 0; i < queryCount; i++) {
+        centers.push_back(bodies[pick(rng)]->position);
+    }
+    // The query this replaced: a full scan into a fresh vector of shared_ptrs
+    size_t legacyFound = 0;
+    auto start = Clock::now();
+    for (const Position& center : centers) {
+        std::vector<std::shared_ptr<PhysicsBody>> nearby;
+        for (const auto& body : bodies) {
+            if (body->isActive && center.distanceTo(body->position) <= radius) nearby.push_back(body);
+        }
+        legacyFound += nearby.size();
+    }
+    double legacyMs = elapsedMs(start);
+    
+    size_t viewFound = 0;
+    start = Clock::now();
+    for (const Position& center : centers) {
+        viewFound += physics.getBodiesInRadius(center, radius).size();
+    }
+    double viewMs = elapsedMs(start);
+    
+    std::vector<BodyHandle> found;
+    size_t bufferFound = 0;
+    start = Clock::now();
+    for (const Position& center : centers) {
+        bufferFound += physics.queryBodiesInRadius(center, radius, found);
+    }
+    double bufferMs = elapsedMs(start);
+    
+    size_t visitorFound = 0;
+    start = Clock::now();
+    for (const Position& center : centers) {
+        physics.forEachBodyInRadius(center, radius, [&visitorFound](PhysicsBody&) { visitorFound++; });
+    }
+    double visitorMs = elapsedMs(start);
+    
+    bool agree = legacyFound == viewFound && viewFound == bufferFound && bufferFound == visitorFound;
+    auto perSecond = [queryCount](double ms) { return queryCount / (ms / 1000.0); };
+    std::cout << std::setw(7) << count
+              << std::setw(14) << std::fixed << std::setprecision(0) << perSecond(legacyMs)
+              << std::setw(14) << perSecond(viewMs)
+              << std::setw(14) << perSecond(bufferMs)
+              << std::setw(14) << perSecond(visitorMs)
+              << std::setw(8) << (agree ? "yes" : "NO") << std::endl;
+}
+
+// Arrows fired at thin palisade walls above a crowd. Reports milliseconds
+// per simulated second and the arrows that ended behind their wall.
+void benchmarkProjectiles(int count, int arrowCount, int tickRate, bool continuous) {
+    PhysicsSystem physics;
+    auto bodies = populate(physics, count, 41);
+    physics.setMaxVelocity(200.0f);
+    
+    const double extent = std::sqrt(count * 5.0);
+    std::mt19937 rng(43);
+    std::uniform_real_distribution<double> place(20.0, extent - 20.0);
+    std::uniform_real_distribution<double> range(6.0, 10.0);
+    std::vector<BodyHandle> arrows;
+    std::vector<double> wallX;
+    for (int i = 0; i < arrowCount; i++) {
+        Position spot(place(rng), place(rng), 30.0);  // Above the crowd, so nothing deflects them
+        double wallDistance = range(rng);
+        BodyHandle wall = physics.spawnBody(spot + Position(wallDistance, 0.0, 0.0));
+        physics.setBodyType(wall, BodyType::STATIC);
+        physics.setBodyShape(wall, ColliderShape::box(Position(0.1, 1.5, 1.5)));
+        
+        BodyHandle arrow = physics.spawnBody(spot);
+        physics.setBodyShape(arrow, ColliderShape::sphere(0.1f));
+        physics.getBody(arrow)->velocity = Position(120.0, 0.0, 0.0);
+        physics.setBodyFastMoving(arrow, continuous);
+        arrows.push_back(arrow);
+        wallX.push_back(spot.getX() + wallDistance);
+    }
+    
+    auto start = Clock::now();
+    for (int step = 0; step < tickRate; step++) {
+        physics.update(1.0f / tickRate);
+    }
+    double msPerSecond = elapsedMs(start);
+    
+    int tunnelled = 0;
+    for (size_t i = 0; i < arrows.size(); i++) {
+        if (physics.getBody(arrows[i])->position.getX() > wallX[i]) tunnelled++;
+    }
+    
+    std::cout << std::setw(9) << tickRate
+              << std::setw(8) << (continuous ? "on" : "off")
+              << std::setw(12) << tunnelled << " / " << arrowCount
+              << std::setw(14) << std::fixed << std::setprecision(1) << msPerSecond << std::endl;
+}
+
+// A crowd of mobs pressing in on one player, the case the solver has to settle
+void benchmarkCrowdSolver(int count, int iterations, bool warmStarting) {
+    PhysicsSystem physics;
+    physics.setGravity(0.0f);
+    physics.setGridParameters(2.0f);
+    physics.setSleepingEnabled(false);
+    physics.setSolverIterations(iterations);
+    physics.setWarmStartingEnabled(warmStarting);
+    
+    BodyHandle player = physics.spawnBody(Position(0.0, 0.0, 0.0));
+    physics.setBodyType(player, BodyType::STATIC);
+    physics.setBodyShape(player, ColliderShape::sphere(2.0f));
+    
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+    std::uniform_real_distribution<double> distance(3.0, 40.0);
+    std::vector<BodyHandle> mobs;
+    for (int i = 0; i < count; i++) {
+        double theta = angle(rng);
+        double radius = distance(rng);
+        BodyHandle handle = physics.spawnBody(Position(std::cos(theta) * radius, std::sin(theta) * radius, 0.0));
+        physics.setBodyShape(handle, ColliderShape::sphere(0.5f));
+        mobs.push_back(handle);
+    }
+    
+    // Each mob walks toward the player every step; a settled crowd stands still
+    const int steps = 600;
+    const double settledSpeed = 0.2;
+    int settledAt = -1;
+    double meanSpeed = 0.0;
+    auto start = Clock::now();
+    for (int step = 0; step < steps; step++) {
+        for (BodyHandle handle : mobs) {
+            PhysicsBody* mob = physics.getBody(handle);
+            mob->force = (Position(0, 0, 0) - mob->position).normalize() * 20.0;
+        }
+        physics.update(1.0f / 60.0f);
+        
+        meanSpeed = 0.0;
+        for (BodyHandle handle : mobs) {
+            meanSpeed += physics.getBody(handle)->velocity.length();
+        }
+        meanSpeed /= count;
+        if (meanSpeed < settledSpeed && settledAt < 0) settledAt = step;
+        if (meanSpeed >= settledSpeed) settledAt = -1;
+    }
+    double stepMs = elapsedMs(start) / steps;
+    
+    std::cout << std::setw(11) << iterations
+              << std::setw(13) << (warmStarting ? "on" : "off")
+              << std::setw(14) << (settledAt < 0 ? std::string("never") : std::to_string(settledAt))
+              << std::setw(13) << std::fixed << std::setprecision(4) << meanSpeed
+              << std::setw(16) << physics.getLastStepStats().maxPenetration
+              << std::setw(12) << std::setprecision(3) << stepMs << std::endl;
+}
+
+struct ScalingResult {
+    double stepMs;
+    size_t contacts;
+    double positionSum;  // Compared across thread counts, must match exactly
+};
+
+ScalingResult runThreadScaling(int count, size_t threads) {
+    PhysicsSystem physics;
+    auto bodies = populate(physics, count, 11);
+
+    // One thread is the caller alone, without a pool
+    std::unique_ptr<JobPool> pool;
+    if (threads > 1) {
+        pool.reset(new JobPool(threads - 1));
+        physics.setJobPool(pool.get());
+    }
+
+    const int steps = 20;
+    physics.update(1.0f / 60.0f);  // Warm up
+
+    auto start = Clock::now();
+    for (int i = 0; i < steps; i++) {
+        physics.update(1.0f / 60.0f);
+    }
+    double stepMs = elapsedMs(start) / steps;
+
+    double positionSum = 0.0;
+    for (const auto& body : bodies) {
+        positionSum += body->position.getX() + body->position.getY() + body->position.getZ();
+    }
+    return ScalingResult{stepMs, physics.getLastStepStats().contacts, positionSum};
+}
+
+void benchmarkThreadScaling(int count) {
+    size_t hardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    ScalingResult baseline = runThreadScaling(count, 1);
+    for (size_t threads : threadCounts) {
+        ScalingResult result = threads == 1 ? baseline : runThreadScaling(count, threads);
+        bool matches = result.contacts == baseline.contacts && result.positionSum == baseline.positionSum;
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(10) << result.contacts
+                  << std::setw(12) << std::fixed << std::setprecision(3) << result.stepMs
+                  << std::setw(11) << std::setprecision(2) << baseline.stepMs / result.stepMs << "x"
+                  << std::setw(13) << (matches ? "yes" : "NO") << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Physics Broadphase Benchmark ===" << std::endl;
+    std::cout << std::setw(7) << "bodies"
+              << std::setw(14) << "pair tests"
+              << std::setw(16) << "brute tests"
+              << std::setw(10) << "contacts"
+              << std::setw(12) << "step ms"
+              << std::setw(16) << "brute pass ms" << std::endl;
+
+    for (int count : {1000, 10000, 50000}) {
+        benchmarkBroadphase(count);
+    }
+
+    std::cout << "\n=== Grid vs Sort and Sweep (20000 mixed-size bodies) ===" << std::endl;
+    std::cout << std::setw(11) << "layout"
+              << std::setw(16) << "broadphase"
+              << std::setw(14) << "pair tests"
+              << std::setw(10) << "contacts"
+              << std::setw(12) << "step ms" << std::endl;
+
+    for (bool clustered : {false, true}) {
+        const char* layout = clustered ? "clustered" : "uniform";
+        benchmarkBroadphaseType(BroadphaseType::UNIFORM_GRID, layout, clustered, 20000);
+        benchmarkBroadphaseType(BroadphaseType::SORT_AND_SWEEP, layout, clustered, 20000);
+    }
+
+    std::cout << "\n=== Sparse Grid in Open-World Zones ===" << std::endl;
+    benchmarkOpenWorld(10000, 4000.0);
+    benchmarkOpenWorld(10000, 16000.0);
+    
+    std::cout << "\n=== Narrowphase: virtual colliders vs shape batches (clustered, 1 in 4 boxes) ===" << std::endl;
+    std::cout << std::setw(11) << "pair tests"
+              << std::setw(10) << "contacts"
+              << std::setw(18) << "virtual ms"
+              << std::setw(16) << "batched ms" << std::endl;
+    std::cout << "(batched time includes the contact event diff)" << std::endl;
+    benchmarkNarrowphase(20000);
+    
+    std::cout << "\n=== Sleeping: 20000 mobs in packs, 1 in 20 wandering ===" << std::endl;
+    std::cout << std::setw(10) << "sleeping"
+              << std::setw(10) << "asleep"
+              << std::setw(14) << "pair tests"
+              << std::setw(12) << "step ms" << std::endl;
+    benchmarkSleeping(20000, false);
+    benchmarkSleeping(20000, true);
+    
+    std::cout << "\n=== Body Storage: integration step ===" << std::endl;
+    std::cout << std::setw(7) << "bodies"
+              << std::setw(16) << "shared_ptr ms"
+              << std::setw(14) << "pooled ms"
+              << std::setw(11) << "speedup" << std::endl;
+    for (int count : {10000, 100000}) {
+        benchmarkBodyStorage(count);
+    }
+    
+    std::cout << "\n=== Raycast: rays per second ===" << std::endl;
+    std::cout << std::setw(7) << "bodies"
+              << std::setw(7) << "rays"
+              << std::setw(14) << "full scan"
+              << std::setw(14) << "grid DDA"
+              << std::setw(14) << "batched"
+              << std::setw(10) << "speedup"
+              << std::setw(18) << "hits (scan/DDA)" << std::endl;
+    std::cout << "(the full scan stops at the first hit in pool order, not the nearest)" << std::endl;
+    for (int count : {1000, 20000}) {
+        benchmarkRaycast(count, 2000);
+    }
+    
+    std::cout << "\n=== Area Queries: radius 8, queries per second ===" << std::endl;
+    std::cout << std::setw(7) << "bodies"
+              << std::setw(14) << "full scan"
+              << std::setw(14) << "grid views"
+              << std::setw(14) << "grid buffer"
+              << std::setw(14) << "grid visitor"
+              << std::setw(8) << "agree" << std::endl;
+    for (int count : {1000, 20000}) {
+        benchmarkAreaQueries(count, 5000, 8.0f);
+    }
+    
+    std::cout << "\n=== Continuous Collision: 200 arrows at 120 u/s among 10000 bodies ===" << std::endl;
+    std::cout << std::setw(9) << "tick Hz"
+              << std::setw(8) << "swept"
+              << std::setw(18) << "tunnelled"
+              << std::setw(14) << "ms per sim s" << std::endl;
+    benchmarkProjectiles(10000, 200, 60, false);
+    benchmarkProjectiles(10000, 200, 30, false);
+    benchmarkProjectiles(10000, 200, 30, true);
+    
+    std::cout << "\n=== Contact Solver: 2000 mobs crowding a player ===" << std::endl;
+    std::cout << std::setw(11) << "iterations"
+              << std::setw(13) << "warm start"
+              << std::setw(14) << "settled at"
+              << std::setw(13) << "mean speed"
+              << std::setw(16) << "penetration"
+              << std::setw(12) << "step ms" << std::endl;
+    for (int iterations : {2, 4, 8}) {
+        benchmarkCrowdSolver(2000, iterations, false);
+        benchmarkCrowdSolver(2000, iterations, true);
+    }
+    
+    std::cout << "\n=== Thread Scaling: 20000 bodies, uniform grid ===" << std::endl;
+    std::cout << std::setw(8) << "threads"
+              << std::setw(10) << "contacts"
+              << std::setw(12) << "step ms"
+              << std::setw(12) << "speedup"
+              << std::setw(13) << "same result" << std::endl;
+    benchmarkThreadScaling(20000);
+    return 0;
+}
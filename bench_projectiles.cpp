@@ -0,0 +1,530 @@
+#include "projectile_pool.h"
+#include "projectile_sweep.h"
+#include "gameengine.h"
+#include "job_pool.h"
+#include "ability.h"
+#include "character.h"
+#include "mob.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float DELTA_TIME = 1.0f / 60.0f;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// A boss pattern: bolts fanning out at head height, a quarter of them
+// physical arrows under gravity and drag, each living half a second to two
+class Emitter {
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> angle;
+    std::uniform_real_distribution<double> speed;
+    std::uniform_real_distribution<float> lifetime;
+    int emitted;
+
+public:
+    Emitter() : rng(33), angle(0.0, 6.283185307179586), speed(10.0, 40.0), lifetime(0.5f, 2.0f), emitted(0) {}
+
+    ProjectileInstance next() {
+        double theta = angle(rng);
+        double v = speed(rng);
+        ProjectileInstance projectile(Position(500.0, 500.0, 2.0),
+                                      Position(std::cos(theta) * v, std::sin(theta) * v, 3.0),
+                                      nullptr, nullptr, lifetime(rng));
+        if (emitted++ % 4 == 0) {
+            projectile.gravity = 9.8f;
+            projectile.drag = 0.1f;
+        }
+        return projectile;
+    }
+};
+
+// The previous layout: one struct per projectile in a vector, stepped one at
+// a time with semi-implicit Euler and compacted with remove_if every frame
+void stepVector(std::vector<ProjectileInstance>& projectiles, float deltaTime) {
+    for (auto& projectile : projectiles) {
+        projectile.timeAlive += deltaTime;
+        if (projectile.timeAlive >= projectile.maxLifetime) {
+            projectile.isActive = false;
+            continue;
+        }
+
+        Position acceleration(0.0, 0.0, -projectile.gravity);
+        if (projectile.drag > 0.0f) {
+            Position dragForce = projectile.velocity * (-projectile.drag);
+            acceleration = acceleration + dragForce;
+        }
+        projectile.velocity = projectile.velocity + acceleration * deltaTime;
+        projectile.currentPos = projectile.currentPos + projectile.velocity * deltaTime;
+
+        if (projectile.currentPos.getZ() <= 0.0 && projectile.velocity.getZ() < 0.0) {
+            projectile.isActive = false;
+        }
+    }
+    projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(),
+                                     [](const ProjectileInstance& p) { return !p.isActive; }),
+                      projectiles.end());
+}
+
+struct Result {
+    double frameMs;
+    double spawnedPerFrame;
+};
+
+// Holds live projectiles at count: every frame steps them all, drops the
+// spent ones and emits replacements
+Result runVector(size_t count, int frames) {
+    Emitter emitter;
+    std::vector<ProjectileInstance> projectiles;
+    for (size_t i = 0; i < count; i++) projectiles.push_back(emitter.next());
+
+    size_t spawned = 0;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        stepVector(projectiles, DELTA_TIME);
+        while (projectiles.size() < count) {
+            projectiles.push_back(emitter.next());
+            spawned++;
+        }
+    }
+    double ms = elapsedMs(start);
+
+    return Result{ms / frames, static_cast<double>(spawned) / frames};
+}
+
+Result runPool(size_t count, int frames) {
+    Emitter emitter;
+    ProjectilePool pool(count);
+    for (size_t i = 0; i < count; i++) pool.spawn(emitter.next());
+
+    size_t spawned = 0;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        pool.integrate(DELTA_TIME);
+        pool.removeDead();
+        while (!pool.isFull()) {
+            pool.spawn(emitter.next());
+            spawned++;
+        }
+    }
+    double ms = elapsedMs(start);
+
+    return Result{ms / frames, static_cast<double>(spawned) / frames};
+}
+
+// integrate() alone over a full pool, nothing expiring
+double kernelMs(size_t count, int frames) {
+    Emitter emitter;
+    ProjectilePool pool(count);
+    for (size_t i = 0; i < count; i++) {
+        ProjectileInstance projectile = emitter.next();
+        projectile.maxLifetime = 1e9f;
+        projectile.gravity = 0.0f;
+        pool.spawn(projectile);
+    }
+
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        pool.integrate(DELTA_TIME);
+    }
+    return elapsedMs(start) / frames;
+}
+
+// Hits print a line each
+struct QuietConsole {
+    std::ostringstream sink;
+    std::streambuf* previous;
+    QuietConsole() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietConsole() { std::cout.rdbuf(previous); }
+};
+
+// The manager's swept hit test, run for every projectile against every target
+bool allPairsHit(const ProjectileInstance& projectile, const Position& end, const Position& target) {
+    const Ability* ability = projectile.sourceAbility;
+    const Position& start = projectile.currentPos;
+    Position direction = projectile.velocity.normalize();
+    double spacing = std::max<double>(ability->getEffectRadius() * 0.5, 1.0);
+    switch (ability->getShape()) {
+        case CONE:
+            return sweepSampled(start, end, spacing, [&](const Position& position) {
+                return position.distanceTo(target) <= ability->getEffectRadius() + 1.0 &&
+                       ability->isTargetInCone(position, target, direction, 45.0f);
+            }) != NO_SWEEP_HIT;
+        case LINE:
+            return sweepSampled(start, end, spacing, [&](const Position& position) {
+                return ability->isTargetInLine(position, target, direction, ability->getEffectRadius());
+            }) != NO_SWEEP_HIT;
+        default:
+            return sweepSphere(start, end, target, projectile.radius + 1.0) != NO_SWEEP_HIT;
+    }
+}
+
+// A boss volley over a field of mobs: projectiles scattered over the field
+// flying level, mostly single-target bolts with some area shapes mixed in.
+// Returns the ms per frame of the all-pairs test and of updateProjectiles.
+std::vector<Ability> volleyAbilities() {
+    return {
+        Ability("Bolt", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, SINGLE_TARGET, 30.0f, 0.0f),
+        Ability("Nova", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, CIRCLE, 30.0f, 2.0f),
+        Ability("Breath", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, CONE, 30.0f, 3.0f),
+        Ability("Lance", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, LINE, 30.0f, 4.0f),
+    };
+}
+
+void benchmarkHits(int projectileCount, int mobCount, int frames) {
+    const double fieldSize = 1000.0;
+    std::vector<Ability> abilities = volleyAbilities();
+
+    SlotMap<Character> characters;
+    SlotMap<Mob> mobs;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(0.0, fieldSize);
+    std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+    std::uniform_int_distribution<int> pick(0, 9);
+
+    CharacterHandle boss = characters.emplace("Boss", Race::createHuman(), Class::createMage());
+    characters.get(boss)->setPosition(-100.0, -100.0, 1.0);
+    for (int i = 0; i < mobCount; i++) {
+        Mob mob(Race::createGoblin());
+        mob.setPosition(coordinate(rng), coordinate(rng), 1.0);
+        mobs.insert(mob);
+    }
+
+    ProjectileManager manager;
+    manager.setCapacity(projectileCount);
+
+    double allPairsMs = 0.0, gridMs = 0.0;
+    size_t allPairsHits = 0, gridHits = 0;
+    QuietConsole quiet;
+    for (int frame = 0; frame <= frames; frame++) {
+        while (manager.getProjectileCount() < static_cast<size_t>(projectileCount)) {
+            int roll = pick(rng);
+            const Ability& ability = abilities[roll < 7 ? 0 : roll - 6];
+            double theta = angle(rng);
+            ProjectileInstance projectile(Position(coordinate(rng), coordinate(rng), 1.0),
+                                          Position(std::cos(theta) * 30.0, std::sin(theta) * 30.0, 0.0),
+                                          &ability, characters.get(boss), 1e6f);
+            manager.spawnProjectile(projectile);
+        }
+
+        // Projectiles with any target in reach after this frame's move
+        const ProjectilePool& pool = manager.getPool();
+        auto start = Clock::now();
+        size_t hits = 0;
+        for (size_t i = 0; i < pool.size(); i++) {
+            ProjectileInstance projectile = pool.get(i);
+            Position end = projectile.currentPos + projectile.velocity * DELTA_TIME;
+            bool hit = false;
+            for (size_t m = 0; m < mobs.size(); m++) {
+                if (allPairsHit(projectile, end, mobs[m].getPosition())) hit = true;
+            }
+            hits += hit;
+        }
+        double bruteMs = elapsedMs(start);
+
+        size_t before = manager.getProjectileCount();
+        start = Clock::now();
+        manager.updateProjectiles(DELTA_TIME, characters, mobs);
+        double updateMs = elapsedMs(start);
+
+        if (frame == 0) continue;  // Warm up
+        allPairsMs += bruteMs;
+        gridMs += updateMs;
+        allPairsHits += hits;
+        gridHits += before - manager.getProjectileCount();
+    }
+
+    std::cout.rdbuf(quiet.previous);
+    std::cout << std::setw(12) << projectileCount
+              << std::setw(8) << mobCount
+              << std::setw(14) << std::setprecision(0) << static_cast<double>(gridHits) / frames
+              << std::setw(14) << std::setprecision(3) << allPairsMs / frames
+              << std::setw(14) << gridMs / frames
+              << std::setw(13) << (allPairsHits == gridHits ? "yes" : "NO") << std::endl;
+    std::cout.rdbuf(quiet.sink.rdbuf());
+}
+
+// The volley of benchmarkHits, packed tighter, with updates run on a job
+// pool. Returns the ms per update; record gets every hit and the mobs'
+// final health, which must not depend on the thread count.
+double runVolley(int projectileCount, int mobCount, int frames, JobPool* jobPool, std::string& record) {
+    const double fieldSize = 300.0;
+    std::vector<Ability> abilities = volleyAbilities();
+
+    SlotMap<Character> characters;
+    SlotMap<Mob> mobs;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coordinate(0.0, fieldSize);
+    std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+    std::uniform_int_distribution<int> pick(0, 3);
+
+    CharacterHandle boss = characters.emplace("Boss", Race::createHuman(), Class::createMage());
+    characters.get(boss)->setPosition(-100.0, -100.0, 1.0);
+    for (int i = 0; i < mobCount; i++) {
+        Mob mob(Race::createGoblin());
+        mob.setPosition(coordinate(rng), coordinate(rng), 1.0);
+        mobs.insert(mob);
+    }
+
+    ProjectileManager manager;
+    manager.setCapacity(projectileCount);
+    manager.setJobPool(jobPool);
+
+    std::ostringstream hits;
+    double updateMs = 0.0;
+    QuietConsole quiet;
+    for (int frame = 0; frame < frames; frame++) {
+        while (manager.getProjectileCount() < static_cast<size_t>(projectileCount)) {
+            double theta = angle(rng);
+            ProjectileInstance projectile(Position(coordinate(rng), coordinate(rng), 1.0),
+                                          Position(std::cos(theta) * 60.0, std::sin(theta) * 60.0, 0.0),
+                                          &abilities[pick(rng)], characters.get(boss), 1e6f);
+            manager.spawnProjectile(projectile);
+        }
+
+        auto start = Clock::now();
+        manager.updateProjectiles(1.0f / 20.0f, characters, mobs);
+        updateMs += elapsedMs(start);
+
+        for (const ProjectileHit& hit : manager.getLastHits()) {
+            hits << hit.projectile.index << ' ' << hit.isMob << ' ' << (hit.isMob ? hit.mob.index : hit.character.index)
+                 << ' ' << hit.time << '\n';
+        }
+    }
+    for (size_t i = 0; i < mobs.size(); i++) {
+        hits << mobs[i].getStats().getHealth() << '\n';
+    }
+    record = hits.str() + quiet.sink.str();
+    return updateMs / frames;
+}
+
+void benchmarkThreads(int projectileCount, int mobCount, int frames) {
+    std::string serial;
+    double serialMs = runVolley(projectileCount, mobCount, frames, nullptr, serial);
+    std::cout << std::setw(10) << "none" << std::setw(14) << std::setprecision(3) << serialMs
+              << std::setw(13) << "-" << std::endl;
+
+    for (size_t workers : {size_t(1), size_t(3), JobPool::defaultWorkerCount()}) {
+        JobPool jobPool(workers);
+        std::string threaded;
+        double ms = runVolley(projectileCount, mobCount, frames, &jobPool, threaded);
+        std::cout << std::setw(10) << jobPool.getThreadCount() << std::setw(14) << ms
+                  << std::setw(13) << (threaded == serial ? "yes" : "NO") << std::endl;
+    }
+}
+
+// One bolt at each of a field of mobs, fired from SWEEP_RANGE away and
+// offset sideways by up to nearly the contact reach, stepped at tickRate.
+// Every bolt should strike its own mob. Compares an end-of-step distance
+// check, simulated here, with the manager's swept test, and the reported
+// impact times against the exact ones.
+const double SWEEP_RANGE = 12.7;
+const double SWEEP_SPEED = 60.0;
+const double CONTACT_REACH = 1.5;  // Bolt radius plus target radius
+
+void benchmarkSweep(float tickRate) {
+    const float deltaTime = 1.0f / tickRate;
+    const int columns = 40, rows = 25;
+    Ability bolt("Bolt", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, SINGLE_TARGET, 30.0f, 0.0f);
+
+    SlotMap<Character> characters;
+    SlotMap<Mob> mobs;
+    CharacterHandle boss = characters.emplace("Boss", Race::createHuman(), Class::createMage());
+    characters.get(boss)->setPosition(-100.0, -100.0, 1.0);
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+    std::uniform_real_distribution<double> offset(-0.95 * CONTACT_REACH, 0.95 * CONTACT_REACH);
+
+    ProjectileManager manager;
+    manager.setCapacity(columns * rows);
+    std::vector<ProjectileId> ids;
+    std::vector<MobHandle> targets;
+    std::vector<double> impactTime;  // Exact first contact, seconds after launch
+    size_t endOfStepHits = 0;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            Position target(column * 20.0, row * 20.0, 1.0);
+            Mob mob(Race::createGoblin());
+            mob.setPosition(target.getX(), target.getY(), target.getZ());
+            targets.push_back(mobs.insert(mob));
+
+            double theta = angle(rng);
+            double side = offset(rng);
+            Position forward(std::cos(theta), std::sin(theta), 0.0);
+            Position across(-forward.getY(), forward.getX(), 0.0);
+            Position start = target - forward * SWEEP_RANGE + across * side;
+            ids.push_back(manager.spawnProjectile(ProjectileInstance(start, forward * SWEEP_SPEED, &bolt,
+                                                                     characters.get(boss), 1.0f)));
+            impactTime.push_back((SWEEP_RANGE - std::sqrt(CONTACT_REACH * CONTACT_REACH - side * side)) / SWEEP_SPEED);
+
+            // The old test: distance at the end of each step only
+            for (int step = 1; step * deltaTime <= 1.0f; step++) {
+                Position position = start + forward * (SWEEP_SPEED * step * deltaTime);
+                if (position.distanceTo(target) <= CONTACT_REACH) {
+                    endOfStepHits++;
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t sweptHits = 0;
+    double timeError = 0.0;
+    QuietConsole quiet;
+    for (int frame = 0; manager.getProjectileCount() > 0; frame++) {
+        manager.updateProjectiles(deltaTime, characters, mobs);
+        for (const ProjectileHit& hit : manager.getLastHits()) {
+            size_t bolt = std::find(ids.begin(), ids.end(), hit.projectile) - ids.begin();
+            if (!hit.isMob || hit.mob != targets[bolt]) continue;
+            sweptHits++;
+            timeError += std::abs(frame * deltaTime + hit.time - impactTime[bolt]);
+        }
+    }
+
+    std::cout.rdbuf(quiet.previous);
+    double total = static_cast<double>(ids.size());
+    std::cout << std::setw(10) << std::setprecision(0) << tickRate
+              << std::setw(8) << std::setprecision(1) << SWEEP_SPEED / tickRate
+              << std::setw(14) << 100.0 * endOfStepHits / total
+              << std::setw(14) << 100.0 * sweptHits / total
+              << std::setw(16) << std::setprecision(4) << 1000.0 * timeError / std::max<size_t>(sweptHits, 1)
+              << std::endl;
+    std::cout.rdbuf(quiet.sink.rdbuf());
+}
+
+// Arrows lobbed under gravity and drag. Reports how far the stepped arc is
+// from the true one one second after launch, for semi-implicit Euler (the
+// pool's old step) and for the pool, and how many arrows the pool flags as
+// grounded on exactly the tick their stepped arc crosses z = 0.
+void benchmarkArcs(float tickRate) {
+    const float deltaTime = 1.0f / tickRate;
+    const int arrows = 1000;
+    const int ticks = static_cast<int>(tickRate);  // One second
+
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> pitch(0.2, 1.2);
+    std::uniform_real_distribution<double> speed(15.0, 40.0);
+
+    ProjectilePool pool(arrows);
+    std::vector<Position> eulerPosition, eulerVelocity;
+    for (int i = 0; i < arrows; i++) {
+        double theta = pitch(rng);
+        double v = speed(rng);
+        ProjectileInstance arrow(Position(0.0, 0.0, 2.0), Position(std::cos(theta) * v, 0.0, std::sin(theta) * v),
+                                 nullptr, nullptr, 1e6f);
+        arrow.gravity = 9.8f;
+        arrow.drag = 0.1f;
+        pool.spawn(arrow);
+        eulerPosition.push_back(arrow.currentPos);
+        eulerVelocity.push_back(arrow.velocity);
+    }
+    std::vector<Position> exact;
+    for (int i = 0; i < arrows; i++) exact.push_back(pool.predictPosition(i, ticks * static_cast<double>(deltaTime)));
+
+    // Nothing is removed, so indices stay put and grounded arrows fly on underground
+    size_t onTime = 0, grounded = 0;
+    std::vector<bool> down(arrows, false);
+    for (int tick = 0; grounded < static_cast<size_t>(arrows); tick++) {
+        pool.integrate(deltaTime);
+        for (int i = 0; i < arrows; i++) {
+            if (down[i] || !(pool.flags[i] & ProjectileFlag::GROUNDED)) continue;
+            down[i] = true;
+            grounded++;
+            onTime += pool.positionZ[i] <= 0.0 && pool.previousZ[i] > 0.0;
+        }
+
+        if (tick >= ticks) continue;
+        for (int i = 0; i < arrows; i++) {
+            Position acceleration = Position(0.0, 0.0, -9.8) + eulerVelocity[i] * -0.1;
+            eulerVelocity[i] = eulerVelocity[i] + acceleration * deltaTime;
+            eulerPosition[i] = eulerPosition[i] + eulerVelocity[i] * deltaTime;
+        }
+        if (tick + 1 == ticks) {
+            double eulerError = 0.0, poolError = 0.0;
+            for (int i = 0; i < arrows; i++) {
+                eulerError += eulerPosition[i].distanceTo(exact[i]);
+                poolError += Position(pool.positionX[i], pool.positionY[i], pool.positionZ[i]).distanceTo(exact[i]);
+            }
+            std::cout << std::setw(10) << std::setprecision(0) << tickRate
+                      << std::setw(16) << std::setprecision(4) << eulerError / arrows
+                      << std::setw(16) << std::scientific << std::setprecision(1) << poolError / arrows
+                      << std::fixed;
+        }
+    }
+    std::cout << std::setw(16) << std::setprecision(1) << 100.0 * onTime / arrows << std::endl;
+}
+
+} // namespace
+
+int main() {
+    const int frames = 240;
+
+    std::cout << "=== Projectile churn at a steady live count (ms per frame) ===" << std::endl;
+    std::cout << std::setw(8) << "live"
+              << std::setw(12) << "spawn/frame"
+              << std::setw(14) << "vector"
+              << std::setw(14) << "pool"
+              << std::setw(14) << "pool kernel" << std::endl;
+
+    for (size_t count : {1000, 10000, 100000}) {
+        Result vector = runVector(count, frames);
+        Result pool = runPool(count, frames);
+        double kernel = kernelMs(count, frames);
+
+        std::cout << std::setw(8) << count
+                  << std::fixed << std::setprecision(0) << std::setw(12) << pool.spawnedPerFrame
+                  << std::setprecision(3)
+                  << std::setw(14) << vector.frameMs
+                  << std::setw(14) << pool.frameMs
+                  << std::setw(14) << kernel << std::endl;
+    }
+
+    std::cout << "\n=== Projectile hit detection (ms per frame) ===" << std::endl;
+    std::cout << std::setw(12) << "projectiles"
+              << std::setw(8) << "mobs"
+              << std::setw(14) << "hits/frame"
+              << std::setw(14) << "all pairs"
+              << std::setw(14) << "update"
+              << std::setw(13) << "same hits" << std::endl;
+    benchmarkHits(1000, 500, 20);
+    benchmarkHits(10000, 5000, 20);
+
+    std::cout << "\n=== Fast bolts at lower tick rates (each aimed to hit) ===" << std::endl;
+    std::cout << std::setw(10) << "tick Hz"
+              << std::setw(8) << "step"
+              << std::setw(14) << "end-of-step %"
+              << std::setw(14) << "swept %"
+              << std::setw(16) << "impact err ms" << std::endl;
+    for (float tickRate : {60.0f, 30.0f, 20.0f}) {
+        benchmarkSweep(tickRate);
+    }
+
+    std::cout << "\n=== Lobbed arrows: distance from the true arc after 1 s ===" << std::endl;
+    std::cout << std::setw(10) << "tick Hz"
+              << std::setw(16) << "Euler"
+              << std::setw(16) << "pool"
+              << std::setw(16) << "landed on time" << std::endl;
+    for (float tickRate : {60.0f, 20.0f}) {
+        benchmarkArcs(tickRate);
+    }
+
+    std::cout << "\n=== Volley of 10000 on a job pool, 20 Hz (ms per update) ===" << std::endl;
+    std::cout << std::setw(10) << "threads"
+              << std::setw(14) << "update"
+              << std::setw(13) << "same hits" << std::endl;
+    benchmarkThreads(10000, 5000, 20);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "world_host.h"
+#include "character.h"
+#include "mob.h"
+#include "job_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const float TICK_RATE = 60.0f;
+
+// Engines log the construction and shutdown of every subsystem, which with
+// hundreds of worlds would bury the table
+struct QuietConsole {
+    std::ostringstream sink;
+    std::streambuf* previous;
+    QuietConsole() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietConsole() { std::cout.rdbuf(previous); }
+};
+
+// A small dungeon instance: one player, a few mobs and some loose physics bodies
+void populateWorld(GameEngine& world, int bodies, unsigned seed,
+                   std::vector<std::shared_ptr<PhysicsBody>>& created) {
+    PhysicsSystem& physics = world.getPhysicsSystem();
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f, Position(40.0, 40.0, 10.0));
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> horizontal(0.0, 40.0);
+    std::uniform_real_distribution<double> speed(-2.0, 2.0);
+    for (int i = 0; i < bodies; i++) {
+        auto body = physics.createBody(Position(horizontal(rng), horizontal(rng), 1.0));
+        body->velocity = Position(speed(rng), speed(rng), 0.0);
+        created.push_back(body);
+    }
+
+    Character player("Instance", Race::createHuman(), Class::createWarrior());
+    player.setPosition(20.0, 20.0, 0.0);
+    world.addCharacter(player);
+    for (int i = 0; i < 4; i++) {
+        Mob mob(Race::createGoblin());
+        mob.setPosition(horizontal(rng), horizontal(rng), 0.0);
+        world.addMob(mob);
+    }
+}
+
+// Sum of body positions, to check that ticking on more threads changes nothing
+double worldChecksum(const std::vector<std::shared_ptr<PhysicsBody>>& bodies) {
+    double sum = 0.0;
+    for (const auto& body : bodies) {
+        sum += body->position.getX() * 3.0 + body->position.getY() * 7.0 + body->position.getZ();
+    }
+    return sum;
+}
+
+std::vector<std::shared_ptr<PhysicsBody>> buildWorlds(WorldHost& host, int worldCount, int bodiesPerWorld) {
+    std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    for (int i = 0; i < worldCount; i++) {
+        size_t index = host.createWorld(TICK_RATE);
+        populateWorld(host.getWorld(index), bodiesPerWorld, 1000 + i, bodies);
+    }
+    return bodies;
+}
+
+void benchmarkWorlds(int worldCount, int bodiesPerWorld, int ticks, size_t threads,
+                     double serialChecksum, double& checksum) {
+    double worldTicksPerSecond = 0.0;
+    {
+        QuietConsole quiet;
+        std::unique_ptr<JobPool> pool;
+        if (threads > 1) pool = std::make_unique<JobPool>(threads - 1);
+
+        WorldHost host(pool.get(), TICK_RATE);
+        auto bodies = buildWorlds(host, worldCount, bodiesPerWorld);
+
+        host.runTicks(2);  // Warm up
+        worldTicksPerSecond = host.runTicks(ticks);
+        checksum = worldChecksum(bodies);
+    }
+
+    // Worlds one core keeps at the full tick rate
+    double instancesPerCore = worldTicksPerSecond / TICK_RATE / threads;
+    double hostTickMs = 1000.0 * worldCount / worldTicksPerSecond;
+    std::cout << std::setw(8) << threads
+              << std::setw(18) << std::fixed << std::setprecision(0) << worldTicksPerSecond
+              << std::setw(14) << std::setprecision(3) << hostTickMs
+              << std::setw(20) << std::setprecision(1) << instancesPerCore
+              << std::setw(13) << (serialChecksum == checksum || threads == 1 ? "yes" : "NO") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    const int worldCount = 256;
+    const int ticks = 120;
+
+    size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts = {1};
+    for (size_t threads = 2; threads <= hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    if (threadCounts.back() != hardwareThreads) threadCounts.push_back(hardwareThreads);
+
+    for (int bodiesPerWorld : {32, 128}) {
+        std::cout << "\n=== World Host: " << worldCount << " instances, " << bodiesPerWorld
+                  << " bodies each, " << static_cast<int>(TICK_RATE) << " Hz ===" << std::endl;
+        std::cout << std::setw(8) << "threads"
+                  << std::setw(18) << "world ticks/s"
+                  << std::setw(14) << "host tick ms"
+                  << std::setw(20) << "instances/core"
+                  << std::setw(13) << "same result" << std::endl;
+
+        double serialChecksum = 0.0;
+        for (size_t threads : threadCounts) {
+            double checksum = 0.0;
+            benchmarkWorlds(worldCount, bodiesPerWorld, ticks, threads, serialChecksum, checksum);
+            if (threads == 1) serialChecksum = checksum;
+        }
+    }
+    return 0;
+}
@@ -4,24 +4,44 @@ echo Building RPG C++ Project...
 REM Set compiler and flags
 set CXX=g++
 set CXXFLAGS=-std=c++17 -Wall -Wextra -g
+set BENCH_CXXFLAGS=-std=c++17 -Wall -Wextra -O2 -DNDEBUG
+set LDFLAGS=-pthread
 
 REM Source files
-set SOURCES=main.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set SOURCES=main.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Test source files
-set TEST_SOURCES=test_statuseffects.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set TEST_SOURCES=test_statuseffects.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Status effects test source files
-set STATUS_EFFECTS_TEST_SOURCES=test_status_effects.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set STATUS_EFFECTS_TEST_SOURCES=test_status_effects.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Movement integration test source files
-set MOVEMENT_INTEGRATION_TEST_SOURCES=test_movement_integration.cpp ability.cpp character.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set MOVEMENT_INTEGRATION_TEST_SOURCES=test_movement_integration.cpp ability.cpp character.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Inventory test source files
-set INVENTORY_TEST_SOURCES=test_inventory.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set INVENTORY_TEST_SOURCES=test_inventory.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Live movement test source files
-set LIVE_MOVEMENT_SOURCES=test_livemovement.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp position.cpp item.cpp inventory.cpp
+set LIVE_MOVEMENT_SOURCES=test_livemovement.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
+
+REM Physics system test source files
+set PHYSICS_TEST_SOURCES=test_physics_system.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp
+
+REM Game engine test source files
+set ENGINE_TEST_SOURCES=test_game_engine.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp world_host.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
+
+REM Physics benchmark source files
+set PHYSICS_BENCH_SOURCES=bench_physics.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp
+
+REM World host benchmark source files
+set WORLDS_BENCH_SOURCES=bench_worlds.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp world_host.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
+
+REM Entity storage benchmark source files
+set ENTITIES_BENCH_SOURCES=bench_entities.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
+
+REM Projectile benchmark source files
+set PROJECTILES_BENCH_SOURCES=bench_projectiles.cpp ability.cpp character.cpp class.cpp race.cpp mob.cpp statblock.cpp statuseffect.cpp gameengine.cpp frame_pacer.cpp system_scheduler.cpp entity_store.cpp projectile_pool.cpp target_grid.cpp player_controller.cpp camera.cpp input_manager.cpp physics_system.cpp spatial_hash.cpp collider_shape.cpp contact_manager.cpp job_pool.cpp contact_solver.cpp ray_kernel.cpp position.cpp item.cpp inventory.cpp
 
 REM Clean previous build
 echo Cleaning previous build...
@@ -31,41 +51,83 @@ del /Q test_statuseffects.exe 2>nul
 del /Q test_livemovement.exe 2>nul
 del /Q test_status_effects.exe 2>nul
 del /Q test_movement_integration.exe 2>nul
+del /Q test_physics_system.exe 2>nul
+del /Q test_game_engine.exe 2>nul
+del /Q bench_physics.exe 2>nul
+del /Q bench_worlds.exe 2>nul
+del /Q bench_entities.exe 2>nul
+del /Q bench_projectiles.exe 2>nul
 
 REM Build main game
 echo Building main game...
 %CXX% %CXXFLAGS% -c %SOURCES%
-%CXX% *.o -o rpg_game.exe
+%CXX% *.o %LDFLAGS% -o rpg_game.exe
 
 REM Build live movement test
 echo Building live movement test...
 del /Q *.o 2>nul
 %CXX% %CXXFLAGS% -c %LIVE_MOVEMENT_SOURCES%
-%CXX% *.o -o test_livemovement.exe
+%CXX% *.o %LDFLAGS% -o test_livemovement.exe
 
 REM Build test
 echo Building test executable...
 del /Q *.o 2>nul
 %CXX% %CXXFLAGS% -c %TEST_SOURCES%
-%CXX% *.o -o test_statuseffects.exe
+%CXX% *.o %LDFLAGS% -o test_statuseffects.exe
 
 REM Build status effects test
 echo Building status effects test executable...
 del /Q *.o 2>nul
 %CXX% %CXXFLAGS% -c %STATUS_EFFECTS_TEST_SOURCES%
-%CXX% *.o -o test_status_effects.exe
+%CXX% *.o %LDFLAGS% -o test_status_effects.exe
 
 REM Build movement integration test
 echo Building movement integration test executable...
 del /Q *.o 2>nul
 %CXX% %CXXFLAGS% -c %MOVEMENT_INTEGRATION_TEST_SOURCES%
-%CXX% *.o -o test_movement_integration.exe
+%CXX% *.o %LDFLAGS% -o test_movement_integration.exe
 
 REM Build inventory test
 echo Building inventory test executable...
 del /Q *.o 2>nul
 %CXX% %CXXFLAGS% -c %INVENTORY_TEST_SOURCES%
-%CXX% *.o -o test_inventory.exe
+%CXX% *.o %LDFLAGS% -o test_inventory.exe
+
+REM Build physics system test
+echo Building physics system test executable...
+del /Q *.o 2>nul
+%CXX% %CXXFLAGS% -c %PHYSICS_TEST_SOURCES%
+%CXX% *.o %LDFLAGS% -o test_physics_system.exe
+
+REM Build game engine test
+echo Building game engine test executable...
+del /Q *.o 2>nul
+%CXX% %CXXFLAGS% -c %ENGINE_TEST_SOURCES%
+%CXX% *.o %LDFLAGS% -o test_game_engine.exe
+
+REM Build physics benchmark (optimized)
+echo Building physics benchmark executable...
+del /Q *.o 2>nul
+%CXX% %BENCH_CXXFLAGS% -c %PHYSICS_BENCH_SOURCES%
+%CXX% *.o %LDFLAGS% -o bench_physics.exe
+
+REM Build world host benchmark (optimized)
+echo Building world host benchmark executable...
+del /Q *.o 2>nul
+%CXX% %BENCH_CXXFLAGS% -c %WORLDS_BENCH_SOURCES%
+%CXX% *.o %LDFLAGS% -o bench_worlds.exe
+
+REM Build entity storage benchmark (optimized)
+echo Building entity storage benchmark executable...
+del /Q *.o 2>nul
+%CXX% %BENCH_CXXFLAGS% -c %ENTITIES_BENCH_SOURCES%
+%CXX% *.o %LDFLAGS% -o bench_entities.exe
+
+REM Build projectile benchmark (optimized)
+echo Building projectile benchmark executable...
+del /Q *.o 2>nul
+%CXX% %BENCH_CXXFLAGS% -c %PROJECTILES_BENCH_SOURCES%
+%CXX% *.o %LDFLAGS% -o bench_projectiles.exe
 
 REM Clean up object files
 del /Q *.o 2>nul
@@ -79,8 +141,18 @@ echo - test_statuseffects.exe (status effect test)
 echo - test_status_effects.exe (new status effects test)
 echo - test_movement_integration.exe (movement integration test)
 echo - test_inventory.exe (inventory system test)
+echo - test_physics_system.exe (physics system test)
+echo - test_game_engine.exe (engine loop, scheduler and projectile test)
+echo - bench_physics.exe (physics broadphase benchmark)
+echo - bench_worlds.exe (world instances per core benchmark)
+echo - bench_entities.exe (entity storage benchmark)
+echo - bench_projectiles.exe (projectile pool and hit detection benchmark)
 echo.
 echo To test live movement: test_livemovement.exe
 echo To run main game: rpg_game.exe
 echo To test new status effects: test_status_effects.exe
 echo To test movement integration: test_movement_integration.exe
+echo To benchmark physics: bench_physics.exe
+echo To benchmark world hosting: bench_worlds.exe
+echo To benchmark entity storage: bench_entities.exe
+echo To benchmark projectiles: bench_projectiles.exe
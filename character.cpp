@@ -5,7 +5,8 @@
 
 // Constructor implementation
 Character::Character(std::string name, Race race, Class characterClass)
-    : name(name), race(race), characterClass(characterClass), isStunned(false), isSilenced(false), isRooted(false) {
+    : name(name), race(race), characterClass(characterClass), isStunned(false), isSilenced(false), isRooted(false),
+      entityStore(nullptr) {
     
     // Calculate final stats by combining class base stats with race bonuses
     stattype finalStrength = characterClass.getBaseStrength() + race.getStrengthBonus();
@@ -25,38 +26,172 @@ Character::Character(std::string name, Race race, Class characterClass)
 }
 
 // Default constructor
-Character::Character() : name(""), race(Race()), characterClass(Class()), isStunned(false), isSilenced(false), isRooted(false) {
+Character::Character() : name(""), race(Race()), characterClass(Class()), isStunned(false), isSilenced(false), isRooted(false),
+                         entityStore(nullptr) {
     // Creates a default character with no name, default race/class, and default stats
 }
 
+Character::Character(const Character& other)
+    : name(other.name), race(other.race), characterClass(other.characterClass), finalStats(other.getStats()),
+      abilities(other.abilities), position(other.getPosition()), statusEffects(other.statusEffects),
+      inventory(other.inventory), isStunned(other.getIsStunned()), isSilenced(other.getIsSilenced()),
+      isRooted(other.getIsRooted()), velocity(other.getVelocity()), entityStore(nullptr) {
+}
+
+Character& Character::operator=(const Character& other) {
+    if (this == &other) return *this;
+    
+    name = other.name;
+    race = other.race;
+    characterClass = other.characterClass;
+    finalStats = other.getStats();
+    abilities = other.abilities;
+    statusEffects = other.statusEffects;
+    inventory = other.inventory;
+    
+    // An attached character keeps its entity and takes the new values into it
+    setPosition(other.getPosition());
+    setVelocity(other.getVelocity());
+    setStunned(other.getIsStunned());
+    setSilenced(other.getIsSilenced());
+    setRooted(other.getIsRooted());
+    pushVitals();
+    return *this;
+}
+
+Character::~Character() {
+    if (entityStore) {
+        entityStore->destroy(entity);
+    }
+}
+
+// Entity store façade
+void Character::attachToStore(EntityStore& store) {
+    if (entityStore == &store) return;
+    detachFromStore();
+    
+    entity = store.create(Component::TRANSFORM | Component::VELOCITY | Component::VITALS |
+                          Component::STATUS | Component::CHARACTER);
+    entityStore = &store;
+    *store.getPosition(entity) = position;
+    *store.getVelocity(entity) = velocity;
+    setStunned(isStunned);
+    setSilenced(isSilenced);
+    setRooted(isRooted);
+    pushVitals();
+}
+
+void Character::detachFromStore() {
+    if (!entityStore) return;
+    
+    pullVitals();
+    position = getPosition();
+    velocity = getVelocity();
+    isStunned = getIsStunned();
+    isSilenced = getIsSilenced();
+    isRooted = getIsRooted();
+    
+    entityStore->destroy(entity);
+    entityStore = nullptr;
+    entity = EntityId();
+}
+
+void Character::pullVitals() {
+    if (!entityStore) return;
+    const Vitals& vitals = *entityStore->getVitals(entity);
+    finalStats.setMaxHealth(vitals.maxHealth);
+    finalStats.setHealth(vitals.health);
+    finalStats.setMaxMana(vitals.maxMana);
+    finalStats.setMana(vitals.mana);
+}
+
+void Character::pushVitals() {
+    if (!entityStore) return;
+    Vitals& vitals = *entityStore->getVitals(entity);
+    vitals.health = finalStats.getHealth();
+    vitals.maxHealth = finalStats.getMaxHealth();
+    vitals.mana = finalStats.getMana();
+    vitals.maxMana = finalStats.getMaxMana();
+}
+
+void Character::setStatusFlag(uint8_t flag, bool set) {
+    uint8_t& status = *entityStore->getStatus(entity);
+    status = set ? (status | flag) : (status & ~flag);
+}
+
 // Getter implementations
 std::string Character::getName() const { return name; }
 Race Character::getRace() const { return race; }
 Class Character::getCharacterClass() const { return characterClass; }
-StatBlock Character::getStats() const { return finalStats; }
-StatBlock& Character::getStatsRef() { return finalStats; }
+StatBlock Character::getStats() const {
+    if (!entityStore) return finalStats;
+    
+    StatBlock stats = finalStats;
+    const Vitals& vitals = *entityStore->getVitals(entity);
+    stats.setMaxHealth(vitals.maxHealth);
+    stats.setHealth(vitals.health);
+    stats.setMaxMana(vitals.maxMana);
+    stats.setMana(vitals.mana);
+    return stats;
+}
+
+StatBlock& Character::getStatsRef() {
+    pullVitals();
+    return finalStats;
+}
+
+bool Character::getIsStunned() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::STUNNED) != 0 : isStunned;
+}
+
+bool Character::getIsSilenced() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::SILENCED) != 0 : isSilenced;
+}
+
+bool Character::getIsRooted() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::ROOTED) != 0 : isRooted;
+}
 
 // Position method implementations
-Position Character::getPosition() const { return position; }
+Position Character::getPosition() const {
+    return entityStore ? *entityStore->getPosition(entity) : position;
+}
 
 void Character::setPosition(const Position& pos) {
-    position = pos;
+    if (entityStore) {
+        *entityStore->getPosition(entity) = pos;
+    } else {
+        position = pos;
+    }
 }
 
 void Character::setPosition(double x, double y, double z) {
-    position.set(x, y, z);
+    setPosition(Position(x, y, z));
 }
 
 void Character::move(double deltaX, double deltaY, double deltaZ) {
-    position.move(deltaX, deltaY, deltaZ);
+    Position& target = entityStore ? *entityStore->getPosition(entity) : position;
+    target.move(deltaX, deltaY, deltaZ);
 }
 
 double Character::distanceTo(const Character& other) const {
-    return position.distanceTo(other.getPosition());
+    return getPosition().distanceTo(other.getPosition());
 }
 
 double Character::distanceTo(const Position& pos) const {
-    return position.distanceTo(pos);
+    return getPosition().distanceTo(pos);
+}
+
+Position Character::getVelocity() const {
+    return entityStore ? *entityStore->getVelocity(entity) : velocity;
+}
+
+void Character::setVelocity(const Position& newVelocity) {
+    if (entityStore) {
+        *entityStore->getVelocity(entity) = newVelocity;
+    } else {
+        velocity = newVelocity;
+    }
 }
 
 // Ability methods
@@ -95,24 +230,34 @@ void Character::levelUp() {
         }
         
         // Apply class-specific growth
+        pullVitals();
         characterClass.applyLevelUpGrowth(finalStats);
+        pushVitals();
     }
 }
 
 void Character::heal(welltype amount) {
+    pullVitals();
     finalStats.heal(amount);
+    pushVitals();
 }
 
 void Character::damage(welltype amount) {
+    pullVitals();
     finalStats.damage(amount);
+    pushVitals();
 }
 
 void Character::restoreMana(welltype amount) {
+    pullVitals();
     finalStats.restoreMana(amount);
+    pushVitals();
 }
 
 void Character::consumeMana(welltype amount) {
+    pullVitals();
     finalStats.consumeMana(amount);
+    pushVitals();
 }
 
 // Character info
@@ -178,6 +323,12 @@ bool Character::hasStatusEffect(const std::string& effectName) const {
     return false;
 }
 
+void Character::rebindStatusEffects() {
+    for (auto& effect : statusEffects) {
+        effect.setCharacterTarget(this);
+    }
+}
+
 // Ability usage methods
 bool Character::useAbility(const Ability& ability, Character& target) {
     // Check if we have this ability
@@ -237,24 +388,76 @@ void Character::modifyIntelligence(stattype amount) {
 }
 
 void Character::modifyMaxHealth(welltype amount) {
+    pullVitals();
     finalStats.setMaxHealth(finalStats.getMaxHealth() + amount);
+    pushVitals();
 }
 
 void Character::modifyMaxMana(welltype amount) {
+    pullVitals();
     finalStats.setMaxMana(finalStats.getMaxMana() + amount);
+    pushVitals();
+}
+
+void Character::setStrength(stattype value) {
+    finalStats.setStrength(value);
+}
+
+void Character::setDexterity(stattype value) {
+    finalStats.setDexterity(value);
+}
+
+void Character::setIntelligence(stattype value) {
+    finalStats.setIntelligence(value);
+}
+
+void Character::setMaxHealth(welltype value) {
+    pullVitals();
+    finalStats.setMaxHealth(value);
+    pushVitals();
+}
+
+void Character::setMaxMana(welltype value) {
+    pullVitals();
+    finalStats.setMaxMana(value);
+    pushVitals();
+}
+
+void Character::setMovementSpeed(float speed) {
+    finalStats.setMovementSpeed(speed);
+}
+
+void Character::setAttackSpeed(float speed) {
+    finalStats.setAttackSpeed(speed);
+}
+
+void Character::setDamageMultiplier(float multiplier) {
+    finalStats.setDamageMultiplier(multiplier);
 }
 
 // Crowd control methods for status effects
 void Character::setStunned(bool stunned) {
-    isStunned = stunned;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::STUNNED, stunned);
+    } else {
+        isStunned = stunned;
+    }
 }
 
 void Character::setSilenced(bool silenced) {
-    isSilenced = silenced;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::SILENCED, silenced);
+    } else {
+        isSilenced = silenced;
+    }
 }
 
 void Character::setRooted(bool rooted) {
-    isRooted = rooted;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::ROOTED, rooted);
+    } else {
+        isRooted = rooted;
+    }
 }
 
 // Inventory methods
@@ -319,5 +522,7 @@ void Character::updateStatsFromEquipment() {
     baseStats.setMaxMana(baseStats.getMaxMana() + inventory.getTotalManaBonus());
     
     // Update final stats
+    pullVitals();
     finalStats = baseStats;
+    pushVitals();
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "position.h"
 #include "statuseffect.h"
 #include "inventory.h"
+#include "entity_store.h"
 #include <string>
 #include <vector>
 
@@ -29,10 +30,32 @@ class Character {
         bool isStunned;        // Cannot act
         bool isSilenced;       // Cannot cast spells
         bool isRooted;         // Cannot move
+        
+        Position velocity;     // Units per second
+        
+        // While attached to an entity store, position, velocity, crowd control
+        // flags, health and mana live there and the fields above are unused
+        EntityStore* entityStore;
+        EntityId entity;
+        
+        void pullVitals();     // Store health and mana into finalStats
+        void pushVitals();     // finalStats health and mana into the store
+        void setStatusFlag(uint8_t flag, bool set);
 
     public:
         Character(std::string name, Race race, Class characterClass);
         Character(); // Default constructor
+        
+        // Copies start detached, holding the source's current hot state
+        Character(const Character& other);
+        Character& operator=(const Character& other);
+        ~Character();
+        
+        // Entity store façade
+        void attachToStore(EntityStore& store);
+        void detachFromStore();
+        bool isAttached() const { return entityStore != nullptr; }
+        EntityId getEntityId() const { return entity; }
 
         // Getters
         std::string getName() const;
@@ -41,12 +64,16 @@ class Character {
         
         // Get final calculated stats
         StatBlock getStats() const;
-        StatBlock& getStatsRef(); // Non-const reference for modifications
+        // Non-const reference for modifications. While attached, health, mana
+        // and their maximums live in the store: they are current in the
+        // reference, but change them with heal, damage, restoreMana,
+        // consumeMana, setMaxHealth and setMaxMana
+        StatBlock& getStatsRef();
         
         // Crowd control getters
-        bool getIsStunned() const { return isStunned; }
-        bool getIsSilenced() const { return isSilenced; }
-        bool getIsRooted() const { return isRooted; }
+        bool getIsStunned() const;
+        bool getIsSilenced() const;
+        bool getIsRooted() const;
         
         // Position methods
         Position getPosition() const;
@@ -55,6 +82,8 @@ class Character {
         void move(double deltaX, double deltaY, double deltaZ);
         double distanceTo(const Character& other) const;
         double distanceTo(const Position& pos) const;
+        Position getVelocity() const;
+        void setVelocity(const Position& newVelocity);
         
         // Ability methods
         const std::vector<Ability>& getAbilities() const;
@@ -67,6 +96,7 @@ class Character {
         void updateStatusEffects(float deltaTime);
         const std::vector<StatusEffect>& getStatusEffects() const;
         bool hasStatusEffect(const std::string& effectName) const;
+        void rebindStatusEffects();  // Points copied effects at this character
         
         // Stat modification methods (for status effects)
         void modifyStrength(stattype amount);
@@ -74,6 +104,14 @@ class Character {
         void modifyIntelligence(stattype amount);
         void modifyMaxHealth(welltype amount);
         void modifyMaxMana(welltype amount);
+        void setStrength(stattype value);
+        void setDexterity(stattype value);
+        void setIntelligence(stattype value);
+        void setMaxHealth(welltype value);
+        void setMaxMana(welltype value);
+        void setMovementSpeed(float speed);
+        void setAttackSpeed(float speed);
+        void setDamageMultiplier(float multiplier);
         
         // Crowd control methods (for status effects)
         void setStunned(bool stunned);
@@ -0,0 +1,124 @@
+#include "collider_shape.h"
+#include <cmath>
+
+namespace {
+    bool testNever(const Position&, const ColliderShape&, const Position&, const ColliderShape&) {
+        return false;
+    }
+
+    double component(const Position& position, int axis) {
+        return axis == 0 ? position.getX() : (axis == 1 ? position.getY() : position.getZ());
+    }
+
+    Position axisVector(int axis, double sign) {
+        return Position(axis == 0 ? sign : 0.0, axis == 1 ? sign : 0.0, axis == 2 ? sign : 0.0);
+    }
+
+    bool contactSphereSphere(const Position& centerA, const ColliderShape& a,
+                             const Position& centerB, const ColliderShape& b, ShapeContact& contact) {
+        Position offset = centerB - centerA;
+        double distance = offset.length();
+        double reach = static_cast<double>(a.radius) + b.radius;
+        if (distance >= reach) return false;
+
+        // Coincident centers have no direction; push apart vertically
+        contact.normal = distance > 0.0 ? offset * (1.0 / distance) : Position(0, 0, 1);
+        contact.depth = reach - distance;
+        return true;
+    }
+
+    bool contactSphereAABB(const Position& sphereCenter, const ColliderShape& sphere,
+                           const Position& boxCenter, const ColliderShape& box, ShapeContact& contact) {
+        Position local = sphereCenter - boxCenter;
+        double closest[3];
+        bool inside = true;
+        for (int axis = 0; axis < 3; ++axis) {
+            double extent = component(box.halfExtents, axis);
+            double value = component(local, axis);
+            closest[axis] = std::max(-extent, std::min(value, extent));
+            if (closest[axis] != value) inside = false;
+        }
+
+        if (!inside) {
+            Position toBox = Position(closest[0], closest[1], closest[2]) - local;
+            double distance = toBox.length();
+            if (distance >= sphere.radius) return false;
+
+            contact.normal = toBox * (1.0 / distance);
+            contact.depth = sphere.radius - distance;
+            return true;
+        }
+
+        // Center inside the box: leave through the nearest face
+        int bestAxis = 0;
+        double bestGap = component(box.halfExtents, 0) - std::abs(component(local, 0));
+        for (int axis = 1; axis < 3; ++axis) {
+            double gap = component(box.halfExtents, axis) - std::abs(component(local, axis));
+            if (gap < bestGap) {
+                bestGap = gap;
+                bestAxis = axis;
+            }
+        }
+        double side = component(local, bestAxis) < 0.0 ? -1.0 : 1.0;
+        contact.normal = axisVector(bestAxis, -side);
+        contact.depth = bestGap + sphere.radius;
+        return true;
+    }
+
+    bool contactAABBSphere(const Position& boxCenter, const ColliderShape& box,
+                           const Position& sphereCenter, const ColliderShape& sphere, ShapeContact& contact) {
+        if (!contactSphereAABB(sphereCenter, sphere, boxCenter, box, contact)) return false;
+        contact.normal = contact.normal * -1.0;
+        return true;
+    }
+
+    bool contactAABBAABB(const Position& centerA, const ColliderShape& a,
+                         const Position& centerB, const ColliderShape& b, ShapeContact& contact) {
+        // Separate along the axis of least overlap
+        Position offset = centerB - centerA;
+        int bestAxis = -1;
+        double bestOverlap = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            double overlap = component(a.halfExtents, axis) + component(b.halfExtents, axis) - std::abs(component(offset, axis));
+            if (overlap <= 0.0) return false;
+            if (bestAxis < 0 || overlap < bestOverlap) {
+                bestOverlap = overlap;
+                bestAxis = axis;
+            }
+        }
+        contact.normal = axisVector(bestAxis, component(offset, bestAxis) < 0.0 ? -1.0 : 1.0);
+        contact.depth = bestOverlap;
+        return true;
+    }
+
+    const int SHAPE_COUNT = static_cast<int>(ShapeType::COUNT);
+
+    // Indexed by [first shape][second shape]
+    const ShapePairTest SHAPE_PAIR_TESTS[SHAPE_COUNT][SHAPE_COUNT] = {
+        // NONE        SPHERE           AABB
+        {testNever, testNever,       testNever},       // NONE
+        {testNever, testSphereSphere, testSphereAABB}, // SPHERE
+        {testNever, testAABBSphere,  testAABBAABB},    // AABB
+    };
+}
+
+ShapePairTest getShapePairTest(ShapeType a, ShapeType b) {
+    return SHAPE_PAIR_TESTS[static_cast<int>(a)][static_cast<int>(b)];
+}
+
+bool computeShapeContact(const Position& centerA, const ColliderShape& a,
+                         const Position& centerB, const ColliderShape& b, ShapeContact& contact) {
+    if (a.type == ShapeType::SPHERE && b.type == ShapeType::SPHERE) {
+        return contactSphereSphere(centerA, a, centerB, b, contact);
+    }
+    if (a.type == ShapeType::SPHERE && b.type == ShapeType::AABB) {
+        return contactSphereAABB(centerA, a, centerB, b, contact);
+    }
+    if (a.type == ShapeType::AABB && b.type == ShapeType::SPHERE) {
+        return contactAABBSphere(centerA, a, centerB, b, contact);
+    }
+    if (a.type == ShapeType::AABB && b.type == ShapeType::AABB) {
+        return contactAABBAABB(centerA, a, centerB, b, contact);
+    }
+    return false;
+}
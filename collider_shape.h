@@ -0,0 +1,102 @@
+#ifndef COLLIDER_SHAPE_H
+#define COLLIDER_SHAPE_H
+
+#include "position.h"
+#include <algorithm>
+#include <cstdint>
+
+// Closed set of collision shapes. New shapes (capsule) are added here and
+// get a row and column in the shape-pair test table.
+enum class ShapeType : uint8_t {
+    NONE,    // Body takes part in the broadphase but never collides
+    SPHERE,
+    AABB,
+    COUNT
+};
+
+// Collision shape stored inline in the body, centered on the body position
+struct ColliderShape {
+    ShapeType type;
+    float radius;          // Sphere radius, or the bounding radius of the box
+    Position halfExtents;  // Box half size; unused by spheres
+
+    ColliderShape() : type(ShapeType::NONE), radius(1.0f), halfExtents(1, 1, 1) {}
+
+    static ColliderShape sphere(float radius) {
+        ColliderShape shape;
+        shape.type = ShapeType::SPHERE;
+        shape.radius = radius;
+        shape.halfExtents = Position(radius, radius, radius);
+        return shape;
+    }
+
+    static ColliderShape box(const Position& halfExtents) {
+        ColliderShape shape;
+        shape.type = ShapeType::AABB;
+        shape.radius = static_cast<float>(halfExtents.length());
+        shape.halfExtents = halfExtents;
+        return shape;
+    }
+
+    // Radius of a sphere around the center that contains the shape
+    float getBoundingRadius() const { return radius; }
+};
+
+// Shape-pair tests. Each takes the two shapes with the body positions they sit at.
+inline bool testSphereSphere(const Position& centerA, const ColliderShape& a,
+                             const Position& centerB, const ColliderShape& b) {
+    double dx = centerA.getX() - centerB.getX();
+    double dy = centerA.getY() - centerB.getY();
+    double dz = centerA.getZ() - centerB.getZ();
+    double reach = static_cast<double>(a.radius) + b.radius;
+    return dx * dx + dy * dy + dz * dz < reach * reach;
+}
+
+inline bool testSphereAABB(const Position& sphereCenter, const ColliderShape& sphere,
+                           const Position& boxCenter, const ColliderShape& box) {
+    // Distance from the sphere center to the closest point of the box
+    double dx = std::max(std::abs(sphereCenter.getX() - boxCenter.getX()) - box.halfExtents.getX(), 0.0);
+    double dy = std::max(std::abs(sphereCenter.getY() - boxCenter.getY()) - box.halfExtents.getY(), 0.0);
+    double dz = std::max(std::abs(sphereCenter.getZ() - boxCenter.getZ()) - box.halfExtents.getZ(), 0.0);
+    double radius = sphere.radius;
+    return dx * dx + dy * dy + dz * dz < radius * radius;
+}
+
+inline bool testAABBSphere(const Position& boxCenter, const ColliderShape& box,
+                           const Position& sphereCenter, const ColliderShape& sphere) {
+    return testSphereAABB(sphereCenter, sphere, boxCenter, box);
+}
+
+inline bool testAABBAABB(const Position& centerA, const ColliderShape& a,
+                         const Position& centerB, const ColliderShape& b) {
+    // Touching boxes count as overlapping
+    return std::abs(centerA.getX() - centerB.getX()) <= a.halfExtents.getX() + b.halfExtents.getX() &&
+           std::abs(centerA.getY() - centerB.getY()) <= a.halfExtents.getY() + b.halfExtents.getY() &&
+           std::abs(centerA.getZ() - centerB.getZ()) <= a.halfExtents.getZ() + b.halfExtents.getZ();
+}
+
+using ShapePairTest = bool (*)(const Position&, const ColliderShape&, const Position&, const ColliderShape&);
+
+// Looks up the test for a shape pair in the dispatch table
+ShapePairTest getShapePairTest(ShapeType a, ShapeType b);
+
+inline bool testShapes(const Position& centerA, const ColliderShape& a,
+                       const Position& centerB, const ColliderShape& b) {
+    return getShapePairTest(a.type, b.type)(centerA, a, centerB, b);
+}
+
+// Contact geometry for the solver. The normal is a unit vector pointing
+// from the first shape toward the second; depth is how far they overlap.
+struct ShapeContact {
+    Position normal;
+    double depth;
+
+    ShapeContact() : normal(0, 0, 1), depth(0.0) {}
+};
+
+// Fills in the contact of two overlapping shapes. Returns false if they do
+// not overlap, or only touch, so there is nothing to push apart.
+bool computeShapeContact(const Position& centerA, const ColliderShape& a,
+                         const Position& centerB, const ColliderShape& b, ShapeContact& contact);
+
+#endif // COLLIDER_SHAPE_H
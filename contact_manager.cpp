@@ -0,0 +1,125 @@
+#include "contact_manager.h"
+#include "physics_system.h"
+#include "hash_mix.h"
+#include <algorithm>
+
+uint64_t ContactManager::makeKey(uint32_t slotA, uint32_t slotB) {
+    if (slotA > slotB) std::swap(slotA, slotB);
+    return (static_cast<uint64_t>(slotA) << 32) | slotB;
+}
+
+void ContactManager::update(const std::vector<BodyPair>& contactPairs) {
+    entered.clear();
+    stayed.clear();
+    exited.clear();
+    matched.assign(activeContacts.size(), 0);
+
+    // Pairs found again are Stay, new ones Enter
+    stepContacts.clear();
+    for (const BodyPair& pair : contactPairs) {
+        Contact contact{makeKey(pair.first->handle.index, pair.second->handle.index), pair.first, pair.second,
+                        0.0f, Position()};
+
+        uint32_t previous = find(contact.key);
+        if (previous == EMPTY_SLOT) {
+            entered.push_back(contact);
+        } else {
+            // The pair may come back in the other order; the impulses follow the bodies
+            const Contact& last = activeContacts[previous];
+            contact.normalImpulse = last.normalImpulse;
+            contact.frictionImpulse = last.first == contact.first ? last.frictionImpulse : last.frictionImpulse * -1.0;
+            matched[previous] = 1;
+            stayed.push_back(contact);
+        }
+        stepContacts.push_back(contact);
+    }
+
+    // Resting pairs were not tested and keep their contact; anything else
+    // left over from the previous step has separated
+    for (size_t i = 0; i < activeContacts.size(); ++i) {
+        if (matched[i]) continue;
+
+        const Contact& contact = activeContacts[i];
+        if (contact.first->isActive && contact.second->isActive && isRestingPair(*contact.first, *contact.second)) {
+            stepContacts.push_back(contact);
+            stayed.push_back(contact);
+        } else {
+            exited.push_back(contact);
+        }
+    }
+
+    activeContacts.swap(stepContacts);
+    rebuildLookup();
+}
+
+void ContactManager::dispatchEvents() {
+    // Callbacks may be costly, so each list runs in its own loop
+    for (const Contact& contact : exited) {
+        if (contact.first->onCollisionExit) contact.first->onCollisionExit(contact.second);
+        if (contact.second->onCollisionExit) contact.second->onCollisionExit(contact.first);
+    }
+    for (const Contact& contact : entered) {
+        if (contact.first->onCollisionEnter) contact.first->onCollisionEnter(contact.second);
+        if (contact.second->onCollisionEnter) contact.second->onCollisionEnter(contact.first);
+    }
+    for (const Contact& contact : stayed) {
+        if (contact.first->onCollisionStay) contact.first->onCollisionStay(contact.second);
+        if (contact.second->onCollisionStay) contact.second->onCollisionStay(contact.first);
+    }
+}
+
+void ContactManager::removeBody(PhysicsBody* body) {
+    auto involves = [body](const Contact& contact) {
+        return contact.first == body || contact.second == body;
+    };
+
+    for (const Contact& contact : activeContacts) {
+        if (!involves(contact)) continue;
+
+        PhysicsBody* partner = contact.first == body ? contact.second : contact.first;
+        if (partner->onCollisionExit) partner->onCollisionExit(body);
+    }
+
+    activeContacts.erase(std::remove_if(activeContacts.begin(), activeContacts.end(), involves), activeContacts.end());
+    rebuildLookup();
+    entered.erase(std::remove_if(entered.begin(), entered.end(), involves), entered.end());
+    stayed.erase(std::remove_if(stayed.begin(), stayed.end(), involves), stayed.end());
+    exited.erase(std::remove_if(exited.begin(), exited.end(), involves), exited.end());
+}
+
+void ContactManager::clear() {
+    activeContacts.clear();
+    stepContacts.clear();
+    lookup.clear();
+    entered.clear();
+    stayed.clear();
+    exited.clear();
+}
+
+void ContactManager::rebuildLookup() {
+    // Load factor at or below one half
+    size_t size = 16;
+    while (size < activeContacts.size() * 2) size *= 2;
+    lookup.assign(size, EMPTY_SLOT);
+
+    size_t mask = size - 1;
+    for (size_t i = 0; i < activeContacts.size(); ++i) {
+        size_t index = mixHash(activeContacts[i].key) & mask;
+        while (lookup[index] != EMPTY_SLOT) {
+            index = (index + 1) & mask;
+        }
+        lookup[index] = static_cast<uint32_t>(i);
+    }
+}
+
+uint32_t ContactManager::find(uint64_t key) const {
+    if (lookup.empty()) return EMPTY_SLOT;
+
+    size_t mask = lookup.size() - 1;
+    size_t index = mixHash(key) & mask;
+    while (lookup[index] != EMPTY_SLOT) {
+        if (activeContacts[lookup[index]].key == key) return lookup[index];
+        index = (index + 1) & mask;
+    }
+    return EMPTY_SLOT;
+}
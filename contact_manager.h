@@ -0,0 +1,72 @@
+#ifndef CONTACT_MANAGER_H
+#define CONTACT_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "position.h"
+
+struct PhysicsBody;
+struct BodyPair;
+
+// Remembers which body pairs touched on the previous step and turns each
+// step's contact list into Enter/Stay/Exit events. Pairs are keyed by the
+// pool slots of both bodies, so the order a pair is reported in does not matter,
+// and looked up through an open-addressing table over the previous contacts.
+// Contacts between resting bodies are carried over, since they are not tested.
+// A contact found again keeps the solver impulses of the previous step, which
+// the solver uses as its starting guess (warm starting).
+class ContactManager {
+public:
+    struct Contact {
+        uint64_t key;
+        PhysicsBody* first;
+        PhysicsBody* second;
+        
+        // Accumulated solver impulses, carried to the next step
+        float normalImpulse;
+        Position frictionImpulse;
+    };
+
+private:
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    std::vector<Contact> activeContacts;   // Contacts of the last update
+    std::vector<Contact> stepContacts;     // Scratch for the step being diffed
+    std::vector<uint32_t> lookup;          // activeContacts indices, linear probing
+    std::vector<uint8_t> matched;          // Per active contact, seen again this step
+
+    // Events produced by the last update, dispatched together
+    std::vector<Contact> entered;
+    std::vector<Contact> stayed;
+    std::vector<Contact> exited;
+
+public:
+    // Diffs this step's contacts against the previous step
+    void update(const std::vector<BodyPair>& contactPairs);
+
+    // Fires the callbacks for the events found by update()
+    void dispatchEvents();
+
+    // Ends every contact of a body that is about to be destroyed. Its
+    // partners get their Exit callback right away, while the body is valid.
+    void removeBody(PhysicsBody* body);
+    void clear();
+
+    static uint64_t makeKey(uint32_t slotA, uint32_t slotB);
+
+private:
+    void rebuildLookup();
+    uint32_t find(uint64_t key) const;
+
+public:
+
+    // Statistics
+    const std::vector<Contact>& getActiveContacts() const { return activeContacts; }
+    std::vector<Contact>& getActiveContacts() { return activeContacts; }
+    size_t getEnterCount() const { return entered.size(); }
+    size_t getStayCount() const { return stayed.size(); }
+    size_t getExitCount() const { return exited.size(); }
+};
+
+#endif // CONTACT_MANAGER_H
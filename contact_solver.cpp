@@ -0,0 +1,135 @@
+#include "contact_solver.h"
+#include "physics_system.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double POSITION_SLOP = 0.01;         // Overlap left alone so resting contacts persist
+    const double POSITION_CORRECTION = 0.8;    // Share of the remaining overlap removed per step
+    const double RESTITUTION_THRESHOLD = 1.0;  // Slower impacts do not bounce, which stops jitter
+
+    // Inverse mass as seen by the solver; sleeping, static and kinematic bodies do not yield
+    float solverInvMass(const PhysicsBody& body) {
+        if (body.bodyType != BodyType::DYNAMIC || body.isSleeping) return 0.0f;
+        return body.invMass;
+    }
+}
+
+ContactSolver::ContactSolver() : iterations(8), warmStarting(true), maxPenetration(0.0) {}
+
+void ContactSolver::solve(std::vector<ContactManager::Contact>& contacts) {
+    prepare(contacts);
+
+    if (warmStarting) {
+        for (Constraint& constraint : constraints) {
+            ContactManager::Contact& contact = *constraint.contact;
+
+            // Drop the part of last step's friction that now points along the normal
+            contact.frictionImpulse = contact.frictionImpulse -
+                                      constraint.normal * contact.frictionImpulse.dot(constraint.normal);
+            applyImpulse(constraint, constraint.normal * contact.normalImpulse + contact.frictionImpulse);
+        }
+    } else {
+        for (Constraint& constraint : constraints) {
+            constraint.contact->normalImpulse = 0.0f;
+            constraint.contact->frictionImpulse = Position();
+        }
+    }
+
+    for (int i = 0; i < iterations; ++i) {
+        for (Constraint& constraint : constraints) {
+            solveVelocities(constraint);
+        }
+    }
+
+    correctPositions();
+}
+
+void ContactSolver::prepare(std::vector<ContactManager::Contact>& contacts) {
+    constraints.clear();
+    maxPenetration = 0.0;
+
+    for (ContactManager::Contact& contact : contacts) {
+        PhysicsBody* bodyA = contact.first;
+        PhysicsBody* bodyB = contact.second;
+        if (bodyA->isTrigger || bodyB->isTrigger) continue;
+
+        float invMassA = solverInvMass(*bodyA);
+        float invMassB = solverInvMass(*bodyB);
+        if (invMassA + invMassB <= 0.0f) {
+            // Nothing can move; forget the impulses so a later wake starts clean
+            contact.normalImpulse = 0.0f;
+            contact.frictionImpulse = Position();
+            continue;
+        }
+
+        ShapeContact geometry;
+        if (!computeShapeContact(bodyA->position, bodyA->shape, bodyB->position, bodyB->shape, geometry)) {
+            contact.normalImpulse = 0.0f;
+            contact.frictionImpulse = Position();
+            continue;
+        }
+
+        Constraint constraint;
+        constraint.contact = &contact;
+        constraint.bodyA = bodyA;
+        constraint.bodyB = bodyB;
+        constraint.normal = geometry.normal;
+        constraint.depth = geometry.depth;
+        constraint.invMassA = invMassA;
+        constraint.invMassB = invMassB;
+        constraint.normalMass = 1.0f / (invMassA + invMassB);
+
+        // Materials combine the usual way: friction by geometric mean, the bouncier restitution wins
+        constraint.friction = std::sqrt(bodyA->material.friction * bodyB->material.friction);
+        float restitution = std::max(bodyA->material.restitution, bodyB->material.restitution);
+
+        double approach = (bodyB->velocity - bodyA->velocity).dot(geometry.normal);
+        constraint.restitutionBias = approach < -RESTITUTION_THRESHOLD ? static_cast<float>(-restitution * approach) : 0.0f;
+
+        maxPenetration = std::max(maxPenetration, geometry.depth);
+        constraints.push_back(constraint);
+    }
+}
+
+void ContactSolver::applyImpulse(Constraint& constraint, const Position& impulse) {
+    constraint.bodyA->velocity = constraint.bodyA->velocity - impulse * constraint.invMassA;
+    constraint.bodyB->velocity = constraint.bodyB->velocity + impulse * constraint.invMassB;
+}
+
+void ContactSolver::solveVelocities(Constraint& constraint) {
+    ContactManager::Contact& contact = *constraint.contact;
+    const Position& normal = constraint.normal;
+
+    // Normal impulse: the running total may shrink but never pull the bodies together
+    double normalSpeed = (constraint.bodyB->velocity - constraint.bodyA->velocity).dot(normal);
+    float lambda = static_cast<float>(constraint.normalMass * (constraint.restitutionBias - normalSpeed));
+    float previous = contact.normalImpulse;
+    contact.normalImpulse = std::max(previous + lambda, 0.0f);
+    applyImpulse(constraint, normal * (contact.normalImpulse - previous));
+
+    // Friction opposes sliding, bounded by the friction cone of the normal impulse
+    Position relative = constraint.bodyB->velocity - constraint.bodyA->velocity;
+    Position sliding = relative - normal * relative.dot(normal);
+    Position previousFriction = contact.frictionImpulse;
+    Position friction = previousFriction - sliding * constraint.normalMass;
+
+    double maxFriction = constraint.friction * contact.normalImpulse;
+    double frictionLength = friction.length();
+    if (frictionLength > maxFriction) {
+        friction = frictionLength > 0.0 ? friction * (maxFriction / frictionLength) : Position();
+    }
+    contact.frictionImpulse = friction;
+    applyImpulse(constraint, friction - previousFriction);
+}
+
+void ContactSolver::correctPositions() {
+    for (const Constraint& constraint : constraints) {
+        double overlap = constraint.depth - POSITION_SLOP;
+        if (overlap <= 0.0) continue;
+
+        Position correction = constraint.normal * (overlap * POSITION_CORRECTION * constraint.normalMass);
+        constraint.bodyA->position = constraint.bodyA->position - correction * constraint.invMassA;
+        constraint.bodyB->position = constraint.bodyB->position + correction * constraint.invMassB;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef CONTACT_SOLVER_H
+#define CONTACT_SOLVER_H
+
+#include "contact_manager.h"
+#include "collider_shape.h"
+#include <cstddef>
+#include <vector>
+
+// Sequential-impulse contact solver. Each iteration visits every contact and
+// applies the impulse that stops the bodies approaching along the normal,
+// plus friction limited by the normal impulse. Starting from the previous
+// step's impulses (warm starting) lets stacked and crowded contacts converge
+// in a few iterations. Penetration left after the velocity pass is removed
+// by moving the bodies apart in proportion to their inverse mass.
+class ContactSolver {
+private:
+    struct Constraint {
+        ContactManager::Contact* contact;
+        PhysicsBody* bodyA;
+        PhysicsBody* bodyB;
+        Position normal;       // From bodyA toward bodyB
+        double depth;
+        float invMassA;        // Zero for bodies the solver must not move
+        float invMassB;
+        float normalMass;      // 1 / (invMassA + invMassB)
+        float friction;
+        float restitutionBias; // Separating speed the normal impulse aims for
+    };
+
+    std::vector<Constraint> constraints;  // Scratch, reused every step
+    int iterations;
+    bool warmStarting;
+    double maxPenetration;  // Deepest contact found by the last solve
+
+public:
+    ContactSolver();
+
+    // Solves the contacts of one step and stores the impulses back into them
+    void solve(std::vector<ContactManager::Contact>& contacts);
+
+    void setIterations(int count) { iterations = count > 0 ? count : 1; }
+    int getIterations() const { return iterations; }
+    void setWarmStarting(bool enabled) { warmStarting = enabled; }
+    bool isWarmStarting() const { return warmStarting; }
+
+    // Statistics
+    size_t getConstraintCount() const { return constraints.size(); }
+    double getMaxPenetration() const { return maxPenetration; }
+
+private:
+    void prepare(std::vector<ContactManager::Contact>& contacts);
+    void applyImpulse(Constraint& constraint, const Position& impulse);
+    void solveVelocities(Constraint& constraint);
+    void correctPositions();
+};
+
+#endif // CONTACT_SOLVER_H
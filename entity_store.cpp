@@ -0,0 +1,166 @@
+#include "entity_store.h"
+
+EntityStore::EntityStore() : liveCount(0) {}
+
+EntityId EntityStore::create(ComponentMask mask) {
+    uint32_t index;
+    if (!freeIds.empty()) {
+        index = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        index = static_cast<uint32_t>(locations.size());
+        locations.push_back(Location{0, NO_ARCHETYPE, 0});
+    }
+
+    EntityId id(index, locations[index].generation);
+    uint32_t archetypeIndex = archetypeFor(mask);
+    locations[index].archetype = archetypeIndex;
+    locations[index].row = appendRow(*archetypes[archetypeIndex], id);
+    ++liveCount;
+    return id;
+}
+
+bool EntityStore::destroy(EntityId id) {
+    if (!isAlive(id)) return false;
+
+    Location& location = locations[id.index];
+    removeRow(*archetypes[location.archetype], location.row);
+    location.archetype = NO_ARCHETYPE;
+    location.generation++;
+    freeIds.push_back(id.index);
+    --liveCount;
+    return true;
+}
+
+void EntityStore::clear() {
+    for (auto& archetype : archetypes) {
+        for (EntityId id : archetype->entities) {
+            locations[id.index].archetype = NO_ARCHETYPE;
+            locations[id.index].generation++;
+            freeIds.push_back(id.index);
+        }
+        archetype->entities.clear();
+        archetype->positions.clear();
+        archetype->velocities.clear();
+        archetype->vitals.clear();
+        archetype->status.clear();
+    }
+    liveCount = 0;
+}
+
+bool EntityStore::isAlive(EntityId id) const {
+    return locate(id) != nullptr;
+}
+
+ComponentMask EntityStore::getMask(EntityId id) const {
+    const Location* location = locate(id);
+    return location ? archetypes[location->archetype]->mask : 0;
+}
+
+void EntityStore::setMask(EntityId id, ComponentMask mask) {
+    const Location* location = locate(id);
+    if (!location || archetypes[location->archetype]->mask == mask) return;
+
+    uint32_t fromIndex = location->archetype;
+    uint32_t fromRow = location->row;
+    uint32_t toIndex = archetypeFor(mask);
+    Archetype& from = *archetypes[fromIndex];
+    Archetype& to = *archetypes[toIndex];
+
+    uint32_t toRow = appendRow(to, id);
+    if (from.has(Component::TRANSFORM) && to.has(Component::TRANSFORM)) to.positions[toRow] = from.positions[fromRow];
+    if (from.has(Component::VELOCITY) && to.has(Component::VELOCITY)) to.velocities[toRow] = from.velocities[fromRow];
+    if (from.has(Component::VITALS) && to.has(Component::VITALS)) to.vitals[toRow] = from.vitals[fromRow];
+    if (from.has(Component::STATUS) && to.has(Component::STATUS)) to.status[toRow] = from.status[fromRow];
+
+    removeRow(from, fromRow);
+    locations[id.index].archetype = toIndex;
+    locations[id.index].row = toRow;
+}
+
+Position* EntityStore::getPosition(EntityId id) {
+    return const_cast<Position*>(static_cast<const EntityStore*>(this)->getPosition(id));
+}
+
+const Position* EntityStore::getPosition(EntityId id) const {
+    const Location* location = locate(id);
+    if (!location) return nullptr;
+    const Archetype& archetype = *archetypes[location->archetype];
+    return archetype.has(Component::TRANSFORM) ? &archetype.positions[location->row] : nullptr;
+}
+
+Position* EntityStore::getVelocity(EntityId id) {
+    return const_cast<Position*>(static_cast<const EntityStore*>(this)->getVelocity(id));
+}
+
+const Position* EntityStore::getVelocity(EntityId id) const {
+    const Location* location = locate(id);
+    if (!location) return nullptr;
+    const Archetype& archetype = *archetypes[location->archetype];
+    return archetype.has(Component::VELOCITY) ? &archetype.velocities[location->row] : nullptr;
+}
+
+Vitals* EntityStore::getVitals(EntityId id) {
+    return const_cast<Vitals*>(static_cast<const EntityStore*>(this)->getVitals(id));
+}
+
+const Vitals* EntityStore::getVitals(EntityId id) const {
+    const Location* location = locate(id);
+    if (!location) return nullptr;
+    const Archetype& archetype = *archetypes[location->archetype];
+    return archetype.has(Component::VITALS) ? &archetype.vitals[location->row] : nullptr;
+}
+
+uint8_t* EntityStore::getStatus(EntityId id) {
+    return const_cast<uint8_t*>(static_cast<const EntityStore*>(this)->getStatus(id));
+}
+
+const uint8_t* EntityStore::getStatus(EntityId id) const {
+    const Location* location = locate(id);
+    if (!location) return nullptr;
+    const Archetype& archetype = *archetypes[location->archetype];
+    return archetype.has(Component::STATUS) ? &archetype.status[location->row] : nullptr;
+}
+
+const EntityStore::Location* EntityStore::locate(EntityId id) const {
+    if (id.index >= locations.size()) return nullptr;
+    const Location& location = locations[id.index];
+    if (location.generation != id.generation || location.archetype == NO_ARCHETYPE) return nullptr;
+    return &location;
+}
+
+uint32_t EntityStore::archetypeFor(ComponentMask mask) {
+    // A game has a handful of archetypes, so a linear search beats hashing
+    for (size_t i = 0; i < archetypes.size(); ++i) {
+        if (archetypes[i]->mask == mask) return static_cast<uint32_t>(i);
+    }
+    archetypes.emplace_back(new Archetype(mask));
+    return static_cast<uint32_t>(archetypes.size() - 1);
+}
+
+uint32_t EntityStore::appendRow(Archetype& archetype, EntityId id) {
+    archetype.entities.push_back(id);
+    if (archetype.has(Component::TRANSFORM)) archetype.positions.emplace_back();
+    if (archetype.has(Component::VELOCITY)) archetype.velocities.emplace_back();
+    if (archetype.has(Component::VITALS)) archetype.vitals.emplace_back();
+    if (archetype.has(Component::STATUS)) archetype.status.push_back(0);
+    return static_cast<uint32_t>(archetype.entities.size() - 1);
+}
+
+void EntityStore::removeRow(Archetype& archetype, uint32_t row) {
+    // Swap-and-pop keeps every column packed
+    uint32_t last = static_cast<uint32_t>(archetype.entities.size() - 1);
+    if (row != last) {
+        archetype.entities[row] = archetype.entities[last];
+        if (archetype.has(Component::TRANSFORM)) archetype.positions[row] = archetype.positions[last];
+        if (archetype.has(Component::VELOCITY)) archetype.velocities[row] = archetype.velocities[last];
+        if (archetype.has(Component::VITALS)) archetype.vitals[row] = archetype.vitals[last];
+        if (archetype.has(Component::STATUS)) archetype.status[row] = archetype.status[last];
+        locations[archetype.entities[row].index].row = row;
+    }
+    archetype.entities.pop_back();
+    if (archetype.has(Component::TRANSFORM)) archetype.positions.pop_back();
+    if (archetype.has(Component::VELOCITY)) archetype.velocities.pop_back();
+    if (archetype.has(Component::VITALS)) archetype.vitals.pop_back();
+    if (archetype.has(Component::STATUS)) archetype.status.pop_back();
+}
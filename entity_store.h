@@ -0,0 +1,120 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include "position.h"
+#include "slot_map.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Which components an entity has, one bit each
+using ComponentMask = uint32_t;
+
+namespace Component {
+    const ComponentMask TRANSFORM = 1u << 0;  // Position
+    const ComponentMask VELOCITY = 1u << 1;   // Units per second
+    const ComponentMask VITALS = 1u << 2;     // Health and mana
+    const ComponentMask STATUS = 1u << 3;     // Crowd control flags
+    const ComponentMask CHARACTER = 1u << 4;  // Tag, no data
+    const ComponentMask MOB = 1u << 5;        // Tag, no data
+}
+
+struct Vitals {
+    welltype health = 0;
+    welltype maxHealth = 0;
+    welltype mana = 0;
+    welltype maxMana = 0;
+};
+
+namespace StatusFlag {
+    const uint8_t STUNNED = 1u << 0;
+    const uint8_t SILENCED = 1u << 1;
+    const uint8_t ROOTED = 1u << 2;
+}
+
+struct EntityRecord;
+using EntityId = Handle<EntityRecord>;
+
+// All entities with exactly one component mask. Each component is its own
+// dense column, indexed by row; columns the mask lacks stay empty.
+struct Archetype {
+    ComponentMask mask;
+    std::vector<EntityId> entities;
+    std::vector<Position> positions;
+    std::vector<Position> velocities;
+    std::vector<Vitals> vitals;
+    std::vector<uint8_t> status;
+
+    explicit Archetype(ComponentMask componentMask) : mask(componentMask) {}
+    size_t size() const { return entities.size(); }
+    bool has(ComponentMask components) const { return (mask & components) == components; }
+};
+
+// Archetype storage for the hot per-entity state that systems sweep every
+// tick. Systems iterate the columns of every archetype that has the
+// components they need, so a pass over positions touches only positions.
+// Entities are generational ids; removing one moves the last row of its
+// archetype into the gap. Component pointers are invalidated by creating,
+// destroying or changing the mask of any entity in the same archetype.
+class EntityStore {
+private:
+    static constexpr uint32_t NO_ARCHETYPE = 0xFFFFFFFFu;
+
+    struct Location {
+        uint32_t generation;
+        uint32_t archetype;  // NO_ARCHETYPE when the id is free
+        uint32_t row;
+    };
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::vector<Location> locations;
+    std::vector<uint32_t> freeIds;
+    size_t liveCount;
+
+public:
+    EntityStore();
+    EntityStore(const EntityStore&) = delete;
+    EntityStore& operator=(const EntityStore&) = delete;
+
+    // New entity with value-initialised components
+    EntityId create(ComponentMask mask);
+    bool destroy(EntityId id);
+    void clear();
+
+    bool isAlive(EntityId id) const;
+    ComponentMask getMask(EntityId id) const;
+    // Moves the entity to the archetype for the new mask, keeping the
+    // components both masks share
+    void setMask(EntityId id, ComponentMask mask);
+
+    // Component access; null when dead or the entity lacks the component
+    Position* getPosition(EntityId id);
+    const Position* getPosition(EntityId id) const;
+    Position* getVelocity(EntityId id);
+    const Position* getVelocity(EntityId id) const;
+    Vitals* getVitals(EntityId id);
+    const Vitals* getVitals(EntityId id) const;
+    uint8_t* getStatus(EntityId id);
+    const uint8_t* getStatus(EntityId id) const;
+
+    // Calls fn(Archetype&) for every non-empty archetype with all required components
+    template <typename Fn>
+    void forEachArchetype(ComponentMask required, Fn&& fn) {
+        for (auto& archetype : archetypes) {
+            if (archetype->size() > 0 && archetype->has(required)) fn(*archetype);
+        }
+    }
+
+    size_t size() const { return liveCount; }
+    size_t getArchetypeCount() const { return archetypes.size(); }
+
+private:
+    const Location* locate(EntityId id) const;
+    uint32_t archetypeFor(ComponentMask mask);
+    uint32_t appendRow(Archetype& archetype, EntityId id);
+    void removeRow(Archetype& archetype, uint32_t row);
+};
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,137 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// FrameTimeHistogram Implementation
+FrameTimeHistogram::FrameTimeHistogram(double bucketWidthMs, double rangeMs)
+    : bucketWidth(bucketWidthMs > 0.0 ? bucketWidthMs : 0.25), count(0), total(0.0), maxValue(0.0) {
+    size_t bucketCount = static_cast<size_t>(std::ceil(std::max(rangeMs, bucketWidth) / bucketWidth));
+    buckets.assign(bucketCount + 1, 0);
+}
+
+void FrameTimeHistogram::record(double milliseconds) {
+    milliseconds = std::max(milliseconds, 0.0);
+    size_t index = std::min(static_cast<size_t>(milliseconds / bucketWidth), buckets.size() - 1);
+    ++buckets[index];
+    ++count;
+    total += milliseconds;
+    maxValue = std::max(maxValue, milliseconds);
+}
+
+void FrameTimeHistogram::clear() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    total = 0.0;
+    maxValue = 0.0;
+}
+
+double FrameTimeHistogram::getPercentile(double fraction) const {
+    if (count == 0) return 0.0;
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * count)), 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i + 1 < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= target) return std::min((i + 1) * bucketWidth, maxValue);
+    }
+    return maxValue;
+}
+
+uint64_t FrameTimeHistogram::countAbove(double milliseconds) const {
+    size_t first = static_cast<size_t>(std::ceil(std::max(milliseconds, 0.0) / bucketWidth));
+    uint64_t above = 0;
+    for (size_t i = first; i < buckets.size(); ++i) {
+        above += buckets[i];
+    }
+    return above;
+}
+
+// FramePacer Implementation
+FramePacer::FramePacer(float targetFPS)
+    : started(false), spinMargin(std::chrono::milliseconds(1)), minSpin(std::chrono::milliseconds(1)),
+      lastWorkTime(0.0), missedDeadlines(0), resyncs(0) {
+    setTargetFPS(targetFPS);
+}
+
+void FramePacer::setTargetFPS(float fps) {
+    if (fps <= 0.0f) return;
+    framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+}
+
+float FramePacer::getTargetFPS() const {
+    return static_cast<float>(1.0 / getFramePeriod());
+}
+
+double FramePacer::getFramePeriod() const {
+    return std::chrono::duration<double>(framePeriod).count();
+}
+
+void FramePacer::setMinSpin(std::chrono::microseconds duration) {
+    minSpin = std::max<Clock::duration>(duration, Clock::duration::zero());
+    spinMargin = std::max(spinMargin, minSpin);
+}
+
+void FramePacer::start() {
+    lastFrame = Clock::now();
+    nextDeadline = lastFrame + framePeriod;
+    started = true;
+}
+
+float FramePacer::waitForNextFrame() {
+    if (!started) start();
+
+    Clock::time_point now = Clock::now();
+    lastWorkTime = std::chrono::duration<double>(now - lastFrame).count();
+
+    if (now < nextDeadline) {
+        // Coarse sleep, then spin off the last stretch the OS cannot hit precisely
+        Clock::time_point wakeTarget = nextDeadline - spinMargin;
+        if (now < wakeTarget) {
+            std::this_thread::sleep_until(wakeTarget);
+
+            // Widen the margin to the overshoot just seen, and let it shrink slowly otherwise
+            Clock::duration overshoot = std::max(Clock::now() - wakeTarget, Clock::duration::zero());
+            Clock::duration decayed = spinMargin - spinMargin / 16;
+            spinMargin = std::min(std::max({minSpin, decayed, overshoot + overshoot / 4}), framePeriod / 2);
+        }
+        while (Clock::now() < nextDeadline) {
+            std::this_thread::yield();
+        }
+        nextDeadline += framePeriod;
+    } else {
+        ++missedDeadlines;
+        if (now - nextDeadline > framePeriod) {
+            // Too far behind to catch up without a burst of short frames
+            nextDeadline = now + framePeriod;
+            ++resyncs;
+        } else {
+            nextDeadline += framePeriod;
+        }
+    }
+
+    now = Clock::now();
+    double interval = std::chrono::duration<double>(now - lastFrame).count();
+    lastFrame = now;
+
+    double intervalMs = interval * 1000.0;
+    frameTimes.record(intervalMs);
+    jitter.record(std::abs(intervalMs - getFramePeriod() * 1000.0));
+    return static_cast<float>(interval);
+}
+
+double FramePacer::getLoad() const {
+    return lastWorkTime / getFramePeriod();
+}
+
+bool FramePacer::isJitterWithinBudget(double budgetMs, double fraction) const {
+    return jitter.getPercentile(fraction) <= budgetMs;
+}
+
+void FramePacer::resetStats() {
+    frameTimes.clear();
+    jitter.clear();
+    missedDeadlines = 0;
+    resyncs = 0;
+}
@@ -0,0 +1,97 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Histogram of frame timings in milliseconds with fixed-width buckets. Values
+// past the last bucket are kept in an overflow bucket; the exact maximum is
+// tracked separately.
+class FrameTimeHistogram {
+private:
+    std::vector<uint32_t> buckets;  // Last bucket is the overflow
+    double bucketWidth;             // Milliseconds per bucket
+    uint64_t count;
+    double total;
+    double maxValue;
+
+public:
+    FrameTimeHistogram(double bucketWidthMs = 0.25, double rangeMs = 100.0);
+
+    void record(double milliseconds);
+    void clear();
+
+    uint64_t getCount() const { return count; }
+    double getMean() const { return count > 0 ? total / count : 0.0; }
+    double getMax() const { return maxValue; }
+
+    // Upper edge of the bucket holding the given fraction (0..1) of samples
+    double getPercentile(double fraction) const;
+    // Samples strictly above the value, counted at bucket resolution
+    uint64_t countAbove(double milliseconds) const;
+
+    const std::vector<uint32_t>& getBuckets() const { return buckets; }
+    double getBucketWidth() const { return bucketWidth; }
+};
+
+// Paces a loop to a target frame rate without burning a core. Each wait sleeps
+// until shortly before the deadline and spins with yields for the rest, since
+// the OS sleep overshoots by up to a scheduler quantum. Deadlines advance by a
+// whole period from the previous deadline rather than from when the wait
+// ended, so wake-up latency does not accumulate into drift. A loop that falls
+// more than a frame behind is resynchronised instead of running a burst of
+// catch-up frames.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration framePeriod;
+    Clock::time_point nextDeadline;
+    Clock::time_point lastFrame;   // When the previous wait returned
+    bool started;
+
+    // The sleep stops this far before the deadline. It follows the observed
+    // sleep overshoot but never drops below minSpin.
+    Clock::duration spinMargin;
+    Clock::duration minSpin;
+
+    double lastWorkTime;   // Seconds between the previous wait and this one
+    uint64_t missedDeadlines;
+    uint64_t resyncs;
+
+    FrameTimeHistogram frameTimes;  // Interval between consecutive frames
+    FrameTimeHistogram jitter;      // |interval - period|
+
+public:
+    explicit FramePacer(float targetFPS = 60.0f);
+
+    void setTargetFPS(float fps);
+    float getTargetFPS() const;
+    double getFramePeriod() const;  // Seconds
+
+    void setMinSpin(std::chrono::microseconds duration);
+
+    // Starts the schedule now; the first deadline is one period away
+    void start();
+
+    // Blocks until the end of the current frame and returns the time since
+    // the previous frame in seconds
+    float waitForNextFrame();
+
+    // Share of the frame period spent outside the wait by the last frame
+    double getLoad() const;
+    double getLastWorkTime() const { return lastWorkTime; }
+    uint64_t getMissedDeadlines() const { return missedDeadlines; }
+    uint64_t getResyncs() const { return resyncs; }
+
+    const FrameTimeHistogram& getFrameTimeHistogram() const { return frameTimes; }
+    const FrameTimeHistogram& getJitterHistogram() const { return jitter; }
+    // True when the given percentile of frame jitter is within budgetMs
+    bool isJitterWithinBudget(double budgetMs, double fraction = 0.99) const;
+    void resetStats();
+};
+
+#endif // FRAME_PACER_H
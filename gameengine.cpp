@@ -2,13 +2,16 @@
 #include "character.h"
 #include "mob.h"
 #include "ability.h"
+#include "projectile_sweep.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
 #include <cmath>
 
 // ProjectileManager Implementation
-void ProjectileManager::spawnProjectile(const Ability& ability, Character& caster, const Position& direction) {
+ProjectileManager::ProjectileManager() : gridCharacterCount(0), jobPool(nullptr) {}
+
+ProjectileId ProjectileManager::spawnProjectile(const Ability& ability, Character& caster, const Position& direction) {
     Position startPos = caster.getPosition();
     
     // Calculate velocity based on projectile speed and direction
@@ -30,190 +33,357 @@ void ProjectileManager::spawnProjectile(const Ability& ability, Character& caste
         projectile.drag = 0.0f;
     }
     
-    activeProjectiles.push_back(projectile);
+    ProjectileId id = pool.spawn(projectile);
+    if (!id.isValid()) {
+        std::cout << caster.getName() << "'s " << ability.getName() << " fizzles: too many projectiles in flight" << std::endl;
+        return id;
+    }
     
     std::cout << caster.getName() << " fires " << ability.getName() 
               << " projectile at speed " << ability.getProjectileSpeed() 
               << " for " << maxLifetime << " seconds!" << std::endl;
+    return id;
 }
 
-void ProjectileManager::updateProjectiles(float deltaTime, std::vector<Character>& characters, std::vector<Mob>& mobs) {
-    for (auto& projectile : activeProjectiles) {
-        if (!projectile.isActive) continue;
-        
-        // Update time alive
-        projectile.timeAlive += deltaTime;
-        
-        // Check if projectile has expired
-        if (projectile.timeAlive >= projectile.maxLifetime) {
-            projectile.isActive = false;
-            continue;
+namespace {
+    const size_t SHAPE_COUNT = SPHERE + 1;
+    const double TARGET_RADIUS = 1.0;  // Character and mob collision radius
+    const float CONE_ANGLE = 45.0f;
+    const size_t MOVE_GRAIN = 4096;
+    const size_t HIT_GRAIN = 256;
+    
+    // Cones and lines are sampled along the step at half their reach, so
+    // the areas of consecutive samples overlap
+    double sampleSpacing(const Ability* ability) {
+        return std::max<double>(ability->getEffectRadius() * 0.5, TARGET_RADIUS);
+    }
+}
+
+void ProjectileManager::updateProjectiles(float deltaTime, SlotMap<Character>& characters, SlotMap<Mob>& mobs) {
+    // Age, move and flag every projectile in passes over the pool's columns
+    pool.prepareStep(deltaTime);
+    runRanges(pool.size(), MOVE_GRAIN, [this, deltaTime](size_t begin, size_t end, size_t) {
+        pool.integrateRange(deltaTime, begin, end);
+    });
+    
+    // Check for ground collision (simple ground at z = 0)
+    for (size_t i = 0; i < pool.size(); i++) {
+        if (pool.flags[i] == ProjectileFlag::GROUNDED) {
+            std::cout << "Projectile " << pool.sourceAbility[i]->getName() << " hits the ground!" << std::endl;
         }
-        
-        // Apply physics
-        Position acceleration(0.0, 0.0, -projectile.gravity); // Gravity pulls down (negative Z)
-        
-        // Apply drag (simple linear drag)
-        if (projectile.drag > 0.0f) {
-            Position dragForce = projectile.velocity * (-projectile.drag);
-            acceleration = acceleration + dragForce;
+    }
+    
+    // Check for entity collisions, one shape at a time
+    hits.clear();
+    buildTargetGrid(characters, mobs);
+    groupByShape();
+    size_t threads = jobPool ? jobPool->getThreadCount() : 1;
+    if (candidates.size() < threads) {
+        candidates.resize(threads);
+    }
+    
+    if (!jobPool) {
+        queryHits(0, shapeOrder.size(), deltaTime, characters, candidates[0], hits);
+    } else {
+        // Each range writes its own buffer and the buffers are appended in
+        // range order, so hits come out as a single-threaded run finds them
+        size_t chunkCount = (shapeOrder.size() + HIT_GRAIN - 1) / HIT_GRAIN;
+        if (hitChunks.size() < chunkCount) {
+            hitChunks.resize(chunkCount);
         }
-        
-        // Update velocity and position
-        projectile.velocity = projectile.velocity + acceleration * deltaTime;
-        projectile.currentPos = projectile.currentPos + projectile.velocity * deltaTime;
-        
-        // Check for ground collision (simple ground at z = 0)
-        if (projectile.currentPos.getZ() <= 0.0 && projectile.velocity.getZ() < 0.0) {
-            projectile.isActive = false;
-            std::cout << "Projectile " << projectile.sourceAbility->getName() << " hits the ground!" << std::endl;
-            continue;
+        jobPool->parallelFor(shapeOrder.size(), HIT_GRAIN,
+                             [this, deltaTime, &characters](size_t begin, size_t end, size_t thread) {
+            std::vector<ProjectileHit>& output = hitChunks[begin / HIT_GRAIN];
+            output.clear();
+            queryHits(begin, end, deltaTime, characters, candidates[thread], output);
+        });
+        for (size_t i = 0; i < chunkCount; i++) {
+            hits.insert(hits.end(), hitChunks[i].begin(), hitChunks[i].end());
         }
-        
-        // Check for entity collisions
-        checkCollisions(projectile, characters, mobs);
     }
+    applyHits(characters, mobs);
     
-    // Remove inactive projectiles
-    removeInactiveProjectiles();
+    // Recycle spent projectiles
+    pool.removeDead();
 }
 
-void ProjectileManager::checkCollisions(ProjectileInstance& projectile, std::vector<Character>& characters, std::vector<Mob>& mobs) {
-    if (!projectile.isActive) return;
-    
-    bool hitTarget = false;
+void ProjectileManager::runRanges(size_t count, size_t grainSize, const JobPool::RangeFunction& function) {
+    if (jobPool) {
+        jobPool->parallelFor(count, grainSize, function);
+    } else if (count > 0) {
+        function(0, count, 0);
+    }
+}
+
+void ProjectileManager::buildTargetGrid(SlotMap<Character>& characters, SlotMap<Mob>& mobs) {
+    targetGrid.clear();
+    gridCharacters.clear();
+    gridMobs.clear();
+    for (size_t i = 0; i < characters.size(); i++) {
+        targetGrid.add(characters[i].getPosition());
+        gridCharacters.push_back(characters.handleAt(i));
+    }
+    for (size_t i = 0; i < mobs.size(); i++) {
+        targetGrid.add(mobs[i].getPosition());
+        gridMobs.push_back(mobs.handleAt(i));
+    }
+    gridCharacterCount = characters.size();
+    targetGrid.build();
+}
+
+void ProjectileManager::groupByShape() {
+    // Counting sort of the projectiles by shape; indices stay ascending
+    // within a group. Those that landed or expired this step are included,
+    // since they still flew part of it.
+    shapeStart.assign(SHAPE_COUNT + 1, 0);
+    for (size_t i = 0; i < pool.size(); i++) {
+        shapeStart[std::min<size_t>(pool.sourceAbility[i]->getShape(), SHAPE_COUNT - 1) + 1]++;
+    }
+    for (size_t shape = 0; shape < SHAPE_COUNT; shape++) {
+        shapeStart[shape + 1] += shapeStart[shape];
+    }
     
-    // Check character collisions
-    for (auto& character : characters) {
-        // Don't hit the caster
-        if (&character == projectile.caster) continue;
-        
-        bool isHit = false;
+    shapeOrder.resize(shapeStart[SHAPE_COUNT]);
+    uint32_t cursor[SHAPE_COUNT];
+    std::copy(shapeStart.begin(), shapeStart.end() - 1, cursor);
+    for (size_t i = 0; i < pool.size(); i++) {
+        size_t shape = std::min<size_t>(pool.sourceAbility[i]->getShape(), SHAPE_COUNT - 1);
+        shapeOrder[cursor[shape]++] = static_cast<uint32_t>(i);
+    }
+}
+
+void ProjectileManager::queryHits(size_t begin, size_t end, float deltaTime, const SlotMap<Character>& characters,
+                                  std::vector<uint32_t>& scratch, std::vector<ProjectileHit>& output) {
+    // A range may span the end of one shape group and the start of the next
+    for (size_t shape = 0; shape < SHAPE_COUNT; shape++) {
+        size_t first = std::max<size_t>(begin, shapeStart[shape]);
+        size_t last = std::min<size_t>(end, shapeStart[shape + 1]);
+        if (first >= last) continue;
+        const uint32_t* group = shapeOrder.data() + first;
+        size_t count = last - first;
         
-        // Check collision based on ability shape
-        switch (projectile.sourceAbility->getShape()) {
-            case SINGLE_TARGET:
-            case CIRCLE:
-            case SPHERE: {
-                double distance = projectile.currentPos.distanceTo(character.getPosition());
-                isHit = (distance <= projectile.radius + 1.0); // 1.0 is character collision radius
+        switch (static_cast<AbilityShape>(shape)) {
+            case CONE:
+                collideGroup(group, count, false, deltaTime, characters, scratch, output,
+                    [this](size_t i, const Position& start, const Position& end, const Position& direction, const Position& target) {
+                        const Ability* ability = pool.sourceAbility[i];
+                        double reach = ability->getEffectRadius() + TARGET_RADIUS;
+                        return sweepSampled(start, end, sampleSpacing(ability), [&](const Position& position) {
+                            return position.distanceTo(target) <= reach &&
+                                   ability->isTargetInCone(position, target, direction, CONE_ANGLE);
+                        });
+                    });
                 break;
-            }
-            case CONE: {
-                // For cone projectiles, check if character is in the cone area
-                double distance = projectile.currentPos.distanceTo(character.getPosition());
-                if (distance <= projectile.sourceAbility->getEffectRadius() + 1.0) {
-                    Position direction = projectile.velocity.normalize();
-                    isHit = projectile.sourceAbility->isTargetInCone(projectile.currentPos, character.getPosition(), direction, 45.0f);
-                }
+            case LINE:
+                collideGroup(group, count, false, deltaTime, characters, scratch, output,
+                    [this](size_t i, const Position& start, const Position& end, const Position& direction, const Position& target) {
+                        const Ability* ability = pool.sourceAbility[i];
+                        return sweepSampled(start, end, sampleSpacing(ability), [&](const Position& position) {
+                            return ability->isTargetInLine(position, target, direction, ability->getEffectRadius());
+                        });
+                    });
                 break;
-            }
-            case LINE: {
-                Position direction = projectile.velocity.normalize();
-                isHit = projectile.sourceAbility->isTargetInLine(projectile.currentPos, character.getPosition(), direction, projectile.sourceAbility->getEffectRadius());
-                break;
-            }
             default:
-                double distance = projectile.currentPos.distanceTo(character.getPosition());
-                isHit = (distance <= projectile.radius + 1.0);
+                // SINGLE_TARGET, CIRCLE and SPHERE touch what their collision radius reaches
+                collideGroup(group, count, shape == SINGLE_TARGET, deltaTime, characters, scratch, output,
+                    [this](size_t i, const Position& start, const Position& end, const Position&, const Position& target) {
+                        return sweepSphere(start, end, target, pool.radius[i] + TARGET_RADIUS);
+                    });
                 break;
         }
-        
-        if (isHit) {
-            // Apply damage/effect
-            if (projectile.sourceAbility->getEffect() == DAMAGE) {
-                welltype damage = projectile.sourceAbility->calculateDamage(
-                    projectile.caster->getStats().getStrength(),
-                    projectile.caster->getStats().getIntelligence()
-                );
-                character.damage(damage);
-                std::cout << "Projectile " << projectile.sourceAbility->getName() 
-                          << " hits " << character.getName() << " for " << damage << " damage!" << std::endl;
-            }
-            hitTarget = true;
-            
-            // Only break for single-target projectiles
-            if (projectile.sourceAbility->getShape() == SINGLE_TARGET) {
-                break;
-            }
-        }
     }
-    
-    // Check mob collisions (allow multi-target projectiles to hit both characters and mobs)
-    for (auto& mob : mobs) {
-        bool isHit = false;
+}
+
+template <typename HitTest>
+void ProjectileManager::collideGroup(const uint32_t* indices, size_t count, bool singleTarget, float deltaTime,
+                                     const SlotMap<Character>& characters, std::vector<uint32_t>& scratch,
+                                     std::vector<ProjectileHit>& output, HitTest hitTest) {
+    for (size_t n = 0; n < count; n++) {
+        size_t i = indices[n];
+        const Ability* ability = pool.sourceAbility[i];
+        Position start(pool.previousX[i], pool.previousY[i], pool.previousZ[i]);
+        Position end;
+        float flightTime = flightEnd(i, deltaTime, end);
+        Position direction = Position(pool.velocityX[i], pool.velocityY[i], pool.velocityZ[i]).normalize();
         
-        // Check collision based on ability shape
-        switch (projectile.sourceAbility->getShape()) {
-            case SINGLE_TARGET:
-            case CIRCLE:
-            case SPHERE: {
-                double distance = projectile.currentPos.distanceTo(mob.getPosition());
-                isHit = (distance <= projectile.radius + 1.0); // 1.0 is mob collision radius
-                break;
-            }
-            case CONE: {
-                // For cone projectiles, check if mob is in the cone area
-                double distance = projectile.currentPos.distanceTo(mob.getPosition());
-                if (distance <= projectile.sourceAbility->getEffectRadius() + 1.0) {
-                    Position direction = projectile.velocity.normalize();
-                    isHit = projectile.sourceAbility->isTargetInCone(projectile.currentPos, mob.getPosition(), direction, 45.0f);
-                }
-                break;
-            }
-            case LINE: {
-                Position direction = projectile.velocity.normalize();
-                isHit = projectile.sourceAbility->isTargetInLine(projectile.currentPos, mob.getPosition(), direction, projectile.sourceAbility->getEffectRadius());
-                break;
-            }
-            default:
-                double distance = projectile.currentPos.distanceTo(mob.getPosition());
-                isHit = (distance <= projectile.radius + 1.0);
-                break;
-        }
+        // Widest reach of any shape's test from anywhere on the step, so the
+        // grid never hides a hit
+        double reach = std::max<double>(pool.radius[i], ability->getEffectRadius()) + TARGET_RADIUS +
+                       start.distanceTo(end) * 0.5;
+        scratch.clear();
+        targetGrid.query((start + end) * 0.5, reach, scratch);
         
-        if (isHit) {
-            // Apply damage/effect
-            if (projectile.sourceAbility->getEffect() == DAMAGE) {
-                welltype damage = projectile.sourceAbility->calculateDamage(
-                    projectile.caster->getStats().getStrength(),
-                    projectile.caster->getStats().getIntelligence()
-                );
-                mob.damage(damage);
-                std::cout << "Projectile " << projectile.sourceAbility->getName() 
-                          << " hits " << mob.getDescription() << " for " << damage << " damage!" << std::endl;
-            }
-            hitTarget = true;
+        // Candidates come sorted: characters first, then mobs, each in
+        // iteration order. A single-target projectile hits at most one of
+        // each, the first it reaches along the step.
+        uint32_t firstCharacter = 0, firstMob = 0;
+        double characterFraction = NO_SWEEP_HIT, mobFraction = NO_SWEEP_HIT;
+        bool hitAny = false;
+        for (uint32_t id : scratch) {
+            bool isMob = id >= gridCharacterCount;
             
-            // Only break for single-target projectiles
-            if (projectile.sourceAbility->getShape() == SINGLE_TARGET) {
-                break;
+            // Don't hit the caster
+            if (!isMob && &characters[id] == pool.caster[i]) continue;
+            double fraction = hitTest(i, start, end, direction, targetGrid.getPosition(id));
+            if (fraction == NO_SWEEP_HIT) continue;
+            hitAny = true;
+            
+            if (!singleTarget) {
+                recordHit(i, id, fraction, start, end, flightTime, output);
+            } else if (isMob && (mobFraction == NO_SWEEP_HIT || fraction < mobFraction)) {
+                firstMob = id;
+                mobFraction = fraction;
+            } else if (!isMob && (characterFraction == NO_SWEEP_HIT || fraction < characterFraction)) {
+                firstCharacter = id;
+                characterFraction = fraction;
             }
         }
+        if (characterFraction != NO_SWEEP_HIT) recordHit(i, firstCharacter, characterFraction, start, end, flightTime, output);
+        if (mobFraction != NO_SWEEP_HIT) recordHit(i, firstMob, mobFraction, start, end, flightTime, output);
+        
+        // Deactivate projectile if it hit something
+        if (hitAny) {
+            pool.flags[i] |= ProjectileFlag::HIT;
+        }
     }
+}
+
+float ProjectileManager::flightEnd(size_t index, float deltaTime, Position& end) const {
+    end = Position(pool.positionX[index], pool.positionY[index], pool.positionZ[index]);
+    if (pool.flags[index] == 0) return deltaTime;
     
-    // Deactivate projectile if it hit something
-    if (hitTarget) {
-        projectile.isActive = false;
+    // Back up along the arc by however far it flew past landing or expiring
+    float stop = std::min(pool.groundTime[index], pool.maxLifetime[index]);
+    float overshoot = std::min(std::max(pool.timeAlive[index] - stop, 0.0f), deltaTime);
+    if (overshoot > 0.0f) {
+        end = pool.predictPosition(index, -overshoot);
+    }
+    return deltaTime - overshoot;
+}
+
+void ProjectileManager::recordHit(size_t index, uint32_t target, double fraction, const Position& start,
+                                  const Position& end, float flightTime, std::vector<ProjectileHit>& output) const {
+    bool isMob = target >= gridCharacterCount;
+    CharacterHandle character = isMob ? CharacterHandle() : gridCharacters[target];
+    MobHandle mob = isMob ? gridMobs[target - gridCharacterCount] : MobHandle();
+    output.push_back(ProjectileHit{pool.idAt(index), isMob, character, mob, static_cast<float>(fraction * flightTime),
+                                   start + (end - start) * fraction});
+}
+
+void ProjectileManager::applyHits(SlotMap<Character>& characters, SlotMap<Mob>& mobs) {
+    for (const ProjectileHit& hit : hits) {
+        // Apply damage/effect
+        size_t index = pool.indexOf(hit.projectile);
+        const Ability* ability = pool.sourceAbility[index];
+        if (ability->getEffect() != DAMAGE) continue;
+        StatBlock casterStats = pool.caster[index]->getStats();
+        welltype damage = ability->calculateDamage(casterStats.getStrength(), casterStats.getIntelligence());
+        if (hit.isMob) {
+            Mob* mob = mobs.get(hit.mob);
+            if (!mob) continue;
+            mob->damage(damage);
+            std::cout << "Projectile " << ability->getName() 
+                      << " hits " << mob->getDescription() << " for " << damage << " damage!" << std::endl;
+        } else {
+            Character* character = characters.get(hit.character);
+            if (!character) continue;
+            character->damage(damage);
+            std::cout << "Projectile " << ability->getName() 
+                      << " hits " << character->getName() << " for " << damage << " damage!" << std::endl;
+        }
     }
 }
 
-void ProjectileManager::removeInactiveProjectiles() {
-    activeProjectiles.erase(
-        std::remove_if(activeProjectiles.begin(), activeProjectiles.end(),
-            [](const ProjectileInstance& p) { return !p.isActive; }),
-        activeProjectiles.end()
-    );
+void ProjectileManager::forgetCaster(const Character* caster) {
+    for (size_t i = pool.size(); i > 0; i--) {
+        if (pool.caster[i - 1] == caster) {
+            pool.remove(pool.idAt(i - 1));
+        }
+    }
 }
 
 // GameEngine Implementation
-GameEngine::GameEngine(float targetFPS, bool fixedTimeStep) 
-    : targetFPS(targetFPS), fixedDeltaTime(1.0f / targetFPS), useFixedTimeStep(fixedTimeStep),
-      isRunning(false), isPaused(false) {
+namespace {
+    const float MAX_VARIABLE_DELTA = 1.0f / 15.0f;  // Largest step taken without a fixed timestep
+    const int DEFAULT_MAX_SUBSTEPS = 5;
+    
+    // Adaptive tick rate: frames using more than OVERLOAD_LOAD of their period
+    // for OVERLOAD_FRAMES in a row lower the rate by TICK_RATE_STEP; frames
+    // under IDLE_LOAD for IDLE_FRAMES raise it again
+    const double OVERLOAD_LOAD = 0.9;
+    const double IDLE_LOAD = 0.5;
+    const int OVERLOAD_FRAMES = 30;
+    const int IDLE_FRAMES = 120;
+    const float TICK_RATE_STEP = 0.9f;
+    
+    const uint64_t HEADLESS_RUN_TICKS = 300;  // Same simulated span as the interactive demo loop
+}
+
+GameEngine::GameEngine(float targetFPS, bool fixedTimeStep, EngineMode mode) 
+    : mode(mode), targetFPS(targetFPS), fixedDeltaTime(1.0f / targetFPS), useFixedTimeStep(fixedTimeStep),
+      accumulator(0.0), maxSubsteps(DEFAULT_MAX_SUBSTEPS), interpolationAlpha(0.0f),
+      tickCount(0), droppedTime(0.0), framePacer(targetFPS), adaptiveTickRate(false),
+      nominalTickRate(targetFPS), minTickRate(targetFPS), overloadedFrames(0), idleFrames(0),
+      isRunning(false), isPaused(false), headlessPaced(false), ticksPerSecond(0.0),
+      debugTickCounter(0) {
     projectileManager = std::make_unique<ProjectileManager>();
-    playerController = std::make_unique<PlayerController>();
+    if (mode == EngineMode::INTERACTIVE) {
+        playerController = std::make_unique<PlayerController>();
+    }
     physicsSystem = std::make_unique<PhysicsSystem>();
     lastUpdateTime = std::chrono::steady_clock::now();
+    registerSystems();
+}
+
+void GameEngine::registerSystems() {
+    using namespace EngineResource;
+    
+    // Physics shares no state with the gameplay systems and runs alongside
+    // the first of them. Movement and projectiles write characters and mobs,
+    // so they follow the player controller and each other; the two status
+    // effect systems then run together, since characters and mobs are disjoint.
+    // The player controller moves the player's character from input
+    if (playerController) {
+        scheduler.addSystem("player controller", 0, INPUT | CHARACTERS, [this](float) {
+            playerController->update();
+        });
+    }
+    
+    scheduler.addSystem("physics", 0, PHYSICS, [this](float deltaTime) {
+        physicsSystem->update(deltaTime);
+    });
+    
+    // Sweeps the store's position and velocity columns rather than the
+    // entity objects; runs before projectiles so hits see this tick's positions
+    scheduler.addSystem("movement", 0, CHARACTERS | MOBS, [this](float deltaTime) {
+        const uint8_t immobile = StatusFlag::STUNNED | StatusFlag::ROOTED;
+        entityStore.forEachArchetype(Component::TRANSFORM | Component::VELOCITY | Component::STATUS,
+                                     [deltaTime, immobile](Archetype& archetype) {
+            for (size_t row = 0; row < archetype.size(); ++row) {
+                if (archetype.status[row] & immobile) continue;
+                const Position& velocity = archetype.velocities[row];
+                archetype.positions[row].move(velocity.getX() * deltaTime, velocity.getY() * deltaTime,
+                                              velocity.getZ() * deltaTime);
+            }
+        });
+    });
+    
+    // Projectiles hit characters and mobs, so they order against both
+    scheduler.addSystem("projectiles", 0, PROJECTILES | CHARACTERS | MOBS, [this](float deltaTime) {
+        projectileManager->updateProjectiles(deltaTime, characters, mobs);
+    });
+    
+    // Status effects only touch the entity they are on
+    scheduler.addSystem("character status effects", 0, CHARACTERS, [this](float deltaTime) {
+        characters.forEach([deltaTime](Character& character) {
+            character.updateStatusEffects(deltaTime);
+        });
+    });
+    scheduler.addSystem("mob status effects", 0, MOBS, [this](float deltaTime) {
+        mobs.forEach([deltaTime](Mob& mob) {
+            mob.updateStatusEffects(deltaTime);
+        });
+    });
 }
 
 GameEngine::~GameEngine() {
@@ -221,14 +391,25 @@ GameEngine::~GameEngine() {
 }
 
 void GameEngine::initialize() {
-    std::cout << "Game Engine initialized with target FPS: " << targetFPS << std::endl;
-    std::cout << "Fixed timestep: " << (useFixedTimeStep ? "ON" : "OFF") << std::endl;
+    if (mode == EngineMode::HEADLESS) {
+        std::cout << "Game Engine initialized headless at " << getTickRate() << " ticks/s"
+                  << (headlessPaced ? "" : " (unpaced)") << std::endl;
+    } else {
+        std::cout << "Game Engine initialized with target FPS: " << targetFPS << std::endl;
+        std::cout << "Fixed timestep: " << (useFixedTimeStep ? "ON" : "OFF");
+        if (useFixedTimeStep) {
+            std::cout << " (" << getTickRate() << " ticks/s, max " << maxSubsteps << " per frame)";
+        }
+        std::cout << std::endl;
+    }
     
     // Initialize systems
     // TODO: Initialize player controller and physics system
     
     isRunning = true;
     isPaused = false;
+    accumulator = 0.0;
+    interpolationAlpha = 0.0f;
     lastUpdateTime = std::chrono::steady_clock::now();
 }
 
@@ -237,68 +418,187 @@ void GameEngine::run() {
         initialize();
     }
     
+    if (mode == EngineMode::HEADLESS) {
+        std::cout << "\n=== Starting Headless Simulation ===" << std::endl;
+        uint64_t startTick = tickCount;
+        runTicks(HEADLESS_RUN_TICKS);
+        std::cout << "=== Headless Simulation Ended ===" << std::endl;
+        std::cout << "Simulation ticks: " << (tickCount - startTick)
+                  << " (" << ticksPerSecond << " ticks/s)" << std::endl;
+        return;
+    }
+    
     std::cout << "\n=== Starting Game Loop ===" << std::endl;
     std::cout << "Game is running. Type any key and press Enter to stop..." << std::endl;
     
-    // Simple game loop for demonstration
+    // Frames are presented at targetFPS by the pacer; the simulation ticks at
+    // its own rate through the accumulator in advance()
+    framePacer.setTargetFPS(targetFPS);
+    framePacer.resetStats();
+    framePacer.start();
+    lastUpdateTime = std::chrono::steady_clock::now();
+    
     int frameCount = 0;
+    uint64_t startTick = tickCount;
+    float frameTime = 0.0f;
     while (isRunning && frameCount < 300) { // Run for ~5 seconds at 60 FPS
         if (!isPaused) {
-            float deltaTime = useFixedTimeStep ? fixedDeltaTime : getDeltaTime();
-            update(deltaTime);
+            advance(frameTime);
         }
         
         frameCount++;
         
-        // Simple frame rate limiting (simplified for now)
-        // TODO: Add proper frame rate limiting when needed
+        // Sleeps out the rest of the frame; the measured interval feeds the
+        // next advance(), so time spent paused is simply not banked
+        frameTime = framePacer.waitForNextFrame();
+        lastUpdateTime = std::chrono::steady_clock::now();
+        if (adaptiveTickRate && !isPaused) {
+            adaptTickRate(framePacer.getLoad());
+        }
     }
     
+    const FrameTimeHistogram& frameTimes = framePacer.getFrameTimeHistogram();
     std::cout << "\n=== Game Loop Ended ===" << std::endl;
     std::cout << "Total frames processed: " << frameCount << std::endl;
+    std::cout << "Simulation ticks: " << (tickCount - startTick) << std::endl;
+    std::cout << "Frame time ms (mean/p99/max): " << frameTimes.getMean() << " / "
+              << frameTimes.getPercentile(0.99) << " / " << frameTimes.getMax() << std::endl;
+    std::cout << "Missed deadlines: " << framePacer.getMissedDeadlines() << std::endl;
 }
 
-void GameEngine::update(float deltaTime) {
-    // Update all game systems
+int GameEngine::advance(float frameTime) {
+    frameTime = std::max(frameTime, 0.0f);
+    
+    if (!useFixedTimeStep) {
+        update(std::min(frameTime, MAX_VARIABLE_DELTA));
+        ++tickCount;
+        interpolationAlpha = 1.0f;
+        return 1;
+    }
     
-    // Debug output removed for clean testing
+    accumulator += frameTime;
     
-    // Update player controller
-    if (playerController) {
-        playerController->update();
+    int ticks = 0;
+    while (accumulator >= fixedDeltaTime && ticks < maxSubsteps) {
+        tick();
+        accumulator -= fixedDeltaTime;
+        ++ticks;
     }
     
-    // Update physics system
-    if (physicsSystem) {
-        physicsSystem->update(deltaTime);
+    // Frames slower than maxSubsteps ticks would make every later frame slower
+    // still; drop the whole ticks that are left and keep only the fraction
+    if (accumulator >= fixedDeltaTime) {
+        double excess = accumulator - std::fmod(accumulator, static_cast<double>(fixedDeltaTime));
+        droppedTime += excess;
+        accumulator -= excess;
     }
     
-    // Update projectiles
-    projectileManager->updateProjectiles(deltaTime, characters, mobs);
+    interpolationAlpha = static_cast<float>(accumulator / fixedDeltaTime);
+    return ticks;
+}
+
+double GameEngine::runTicks(uint64_t count) {
+    if (!isRunning) {
+        initialize();
+    }
     
-    // Update status effects for all entities
-    for (auto& character : characters) {
-        character.updateStatusEffects(deltaTime);
+    if (headlessPaced) {
+        framePacer.setTargetFPS(getTickRate());
+        framePacer.resetStats();
+        framePacer.start();
     }
-    for (auto& mob : mobs) {
-        // Debug output removed for clean testing
-        mob.updateStatusEffects(deltaTime);
+    
+    auto start = std::chrono::steady_clock::now();
+    uint64_t done = 0;
+    while (isRunning && done < count) {
+        if (!isPaused) {
+            tick();
+            ++done;
+        }
+        
+        if (headlessPaced) {
+            framePacer.waitForNextFrame();
+        } else if (isPaused) {
+            std::this_thread::yield();
+        }
     }
     
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ticksPerSecond = elapsed > 0.0 ? done / elapsed : 0.0;
+    lastUpdateTime = std::chrono::steady_clock::now();
+    return ticksPerSecond;
+}
+
+void GameEngine::tick() {
+    update(fixedDeltaTime);
+    ++tickCount;
+}
+
+void GameEngine::setTickRate(float ticksPerSecond) {
+    if (ticksPerSecond <= 0.0f) return;
+    nominalTickRate = ticksPerSecond;
+    minTickRate = std::min(minTickRate, ticksPerSecond);
+    applyTickRate(ticksPerSecond);
+}
+
+void GameEngine::applyTickRate(float ticksPerSecond) {
+    fixedDeltaTime = 1.0f / ticksPerSecond;
+    
+    // Keep the banked time below one tick of the new length
+    accumulator = std::fmod(accumulator, static_cast<double>(fixedDeltaTime));
+    interpolationAlpha = static_cast<float>(accumulator / fixedDeltaTime);
+}
+
+void GameEngine::setAdaptiveTickRate(bool enabled, float minimum) {
+    adaptiveTickRate = enabled;
+    minTickRate = std::min(std::max(minimum, 1.0f), nominalTickRate);
+    overloadedFrames = 0;
+    idleFrames = 0;
+    if (!enabled) {
+        applyTickRate(nominalTickRate);
+    }
+}
+
+void GameEngine::adaptTickRate(double load) {
+    if (!adaptiveTickRate) return;
+    float tickRate = getTickRate();
+    
+    if (load > OVERLOAD_LOAD) {
+        idleFrames = 0;
+        if (++overloadedFrames >= OVERLOAD_FRAMES && tickRate > minTickRate) {
+            applyTickRate(std::max(tickRate * TICK_RATE_STEP, minTickRate));
+            overloadedFrames = 0;
+        }
+    } else if (load < IDLE_LOAD) {
+        overloadedFrames = 0;
+        if (++idleFrames >= IDLE_FRAMES && tickRate < nominalTickRate) {
+            applyTickRate(std::min(tickRate / TICK_RATE_STEP, nominalTickRate));
+            idleFrames = 0;
+        }
+    } else {
+        overloadedFrames = 0;
+        idleFrames = 0;
+    }
+}
+
+void GameEngine::update(float deltaTime) {
+    // Update all game systems: player controller, physics, movement,
+    // projectiles and status effects, in that order wherever one depends on another
+    scheduler.run(deltaTime);
+    
     // Here you could add other systems:
     // - Character AI updates
     // - Mob movement
     // - Ability cooldowns
-    // - Physics simulation
     
-    // Debug output every 60 frames (roughly every second at 60 FPS)
-    static int debugCounter = 0;
-    debugCounter++;
-    if (debugCounter >= 60) {
+    // Debug output every 60 updates (roughly every second at 60 FPS). The
+    // counter is per engine so several worlds in one process do not share it.
+    debugTickCounter++;
+    if (debugTickCounter >= 60) {
         if (projectileManager->getProjectileCount() > 0) {
             std::cout << "Active projectiles: " << projectileManager->getProjectileCount() << std::endl;
         }
-        debugCounter = 0;
+        debugTickCounter = 0;
     }
 }
 
@@ -307,41 +607,72 @@ void GameEngine::shutdown() {
     // TODO: Shutdown player controller and physics system
     projectileManager->clearAllProjectiles();
     characters.clear();
+    characterNames.clear();
     mobs.clear();
     std::cout << "Game Engine shutdown complete." << std::endl;
 }
 
 float GameEngine::getDeltaTime() {
+    // Cap delta time to prevent large jumps (e.g., when debugging)
+    return std::min(measureFrameTime(), MAX_VARIABLE_DELTA);
+}
+
+float GameEngine::measureFrameTime() {
     auto currentTime = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(currentTime - lastUpdateTime);
     lastUpdateTime = currentTime;
     
-    float deltaTime = duration.count() / 1000000.0f; // Convert to seconds
-    
-    // Cap delta time to prevent large jumps (e.g., when debugging)
-    const float maxDeltaTime = 1.0f / 15.0f; // Cap at 15 FPS minimum
-    return std::min(deltaTime, maxDeltaTime);
+    return duration.count() / 1000000.0f; // Convert to seconds
 }
 
-void GameEngine::addCharacter(const Character& character) {
-    characters.push_back(character);
+CharacterHandle GameEngine::addCharacter(const Character& character) {
+    CharacterHandle handle = characters.insert(character);
+    Character& added = *characters.get(handle);
+    added.rebindStatusEffects();
+    added.attachToStore(entityStore);
+    characterNames.emplace(added.getName(), handle);
     // TODO: Register with physics system
-    std::cout << "Added character: " << character.getName() << std::endl;
+    std::cout << "Added character: " << added.getName() << std::endl;
+    return handle;
 }
 
-void GameEngine::addMob(const Mob& mob) {
-    mobs.push_back(mob);
+MobHandle GameEngine::addMob(const Mob& mob) {
+    MobHandle handle = mobs.insert(mob);
+    Mob& added = *mobs.get(handle);
+    added.rebindStatusEffects();
+    added.attachToStore(entityStore);
     // TODO: Register with physics system
-    std::cout << "Added mob: " << mob.getDescription() << std::endl;
+    std::cout << "Added mob: " << added.getDescription() << std::endl;
+    return handle;
 }
 
-Character* GameEngine::getCharacter(const std::string& name) {
-    for (auto& character : characters) {
-        if (character.getName() == name) {
-            return &character;
-        }
+bool GameEngine::removeCharacter(CharacterHandle handle) {
+    Character* character = characters.get(handle);
+    if (!character) return false;
+    
+    auto named = characterNames.find(character->getName());
+    if (named != characterNames.end() && named->second == handle) {
+        characterNames.erase(named);
     }
-    return nullptr;
+    if (playerController && playerController->getPlayerCharacter() == character) {
+        playerController->setPlayerCharacter(nullptr);
+    }
+    projectileManager->forgetCaster(character);
+    return characters.erase(handle);
+}
+
+bool GameEngine::removeMob(MobHandle handle) {
+    return mobs.erase(handle);
+}
+
+Character* GameEngine::getCharacter(const std::string& name) {
+    auto named = characterNames.find(name);
+    return named != characterNames.end() ? characters.get(named->second) : nullptr;
+}
+
+CharacterHandle GameEngine::findCharacter(const std::string& name) const {
+    auto named = characterNames.find(name);
+    return named != characterNames.end() ? named->second : CharacterHandle();
 }
 
 Mob* GameEngine::getMob(size_t index) {
@@ -354,25 +685,34 @@ Mob* GameEngine::getMob(size_t index) {
 void GameEngine::printGameState() const {
     std::cout << "\n=== Game State ===" << std::endl;
     std::cout << "Characters: " << characters.size() << std::endl;
-    for (const auto& character : characters) {
+    characters.forEach([](const Character& character) {
         std::cout << "  - " << character.getName() << " at " << character.getPosition() << std::endl;
-    }
+    });
     
     std::cout << "Mobs: " << mobs.size() << std::endl;
-    for (const auto& mob : mobs) {
+    mobs.forEach([](const Mob& mob) {
         std::cout << "  - " << mob.getDescription() << " at " << mob.getPosition() << std::endl;
-    }
+    });
     
     std::cout << "Active Projectiles: " << projectileManager->getProjectileCount() << std::endl;
 }
 
 void GameEngine::printProjectileInfo() const {
-    const auto& projectiles = projectileManager->getActiveProjectiles();
+    const ProjectilePool& projectiles = projectileManager->getPool();
     std::cout << "\n=== Projectile Info ===" << std::endl;
     for (size_t i = 0; i < projectiles.size(); ++i) {
-        const auto& p = projectiles[i];
+        ProjectileInstance p = projectiles.get(i);
         std::cout << "Projectile " << i << ": " << p.sourceAbility->getName() 
                   << " at " << p.currentPos 
                   << " (alive: " << p.timeAlive << "s)" << std::endl;
     }
 }
+
+void GameEngine::printSystemTimings() const {
+    std::cout << "\n=== System Timings (last update) ===" << std::endl;
+    for (const auto& timing : scheduler.getTimings()) {
+        std::cout << "  [wave " << timing.wave << "] " << timing.name << ": "
+                  << timing.milliseconds << " ms" << std::endl;
+    }
+    std::cout << "  total: " << scheduler.getLastRunMs() << " ms" << std::endl;
+}
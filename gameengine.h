@@ -2,76 +2,199 @@
 #define GAMEENGINE_H
 
 #include "position.h"
+#include "character.h"
+#include "mob.h"
+#include "slot_map.h"
+#include "entity_store.h"
+#include "projectile_pool.h"
+#include "target_grid.h"
 #include "player_controller.h"
 #include "physics_system.h"
+#include "frame_pacer.h"
+#include "system_scheduler.h"
 #include <string>
 #include <vector>
 #include <chrono>
 #include <memory>
+#include <cstdint>
+#include <unordered_map>
 
 // Forward declarations
-class Character;
-class Mob;
 class Ability;
 class ProjectileManager;
 
-struct ProjectileInstance {
-    Position currentPos;
-    Position velocity;          // Units per second
-    float timeAlive;           // Time since spawn in seconds
-    float maxLifetime;         // Max time before projectile expires
-    const Ability* sourceAbility;
-    Character* caster;
-    bool isActive;
-    float radius;              // Collision radius
-    
-    // Optional physics properties
-    float gravity;             // Downward acceleration (units/s²)
-    float drag;                // Air resistance coefficient
-    
-    ProjectileInstance(const Position& startPos, const Position& vel, const Ability* ability, 
-                      Character* casterPtr, float lifetime = 10.0f, float collisionRadius = 0.5f)
-        : currentPos(startPos), velocity(vel), timeAlive(0.0f), maxLifetime(lifetime),
-          sourceAbility(ability), caster(casterPtr), isActive(true), radius(collisionRadius),
-          gravity(0.0f), drag(0.0f) {}
+// Generational entity handles; a handle goes stale when its entity is removed
+using CharacterHandle = Handle<Character>;
+using MobHandle = Handle<Mob>;
+
+// One projectile striking one target during an update
+struct ProjectileHit {
+    ProjectileId projectile;
+    bool isMob;
+    CharacterHandle character;  // The target when !isMob
+    MobHandle mob;              // The target when isMob
+    float time;         // Seconds into the update's step at first contact
+    Position point;     // Where the projectile was at first contact
 };
 
 class ProjectileManager {
 private:
-    std::vector<ProjectileInstance> activeProjectiles;
+    ProjectilePool pool;
+    
+    // Per-frame hit pass state. Characters are grid ids 0..n-1 and mobs
+    // follow, both in slot map iteration order.
+    TargetGrid targetGrid;
+    size_t gridCharacterCount;
+    std::vector<CharacterHandle> gridCharacters;  // Handle of each character grid id
+    std::vector<MobHandle> gridMobs;              // Handle of each mob grid id, less gridCharacterCount
+    std::vector<uint32_t> shapeOrder;   // Projectile indices grouped by AbilityShape
+    std::vector<uint32_t> shapeStart;   // Group s is shapeOrder[shapeStart[s] .. shapeStart[s + 1])
+    std::vector<std::vector<uint32_t>> candidates;      // Grid query scratch per thread
+    std::vector<std::vector<ProjectileHit>> hitChunks;  // Per-range output of the hit query phase
+    std::vector<ProjectileHit> hits;                    // Hits found by the last update
+    
+    JobPool* jobPool;  // Not owned; null runs the update on the calling thread
+    
+    void runRanges(size_t count, size_t grainSize, const JobPool::RangeFunction& function);
+    void buildTargetGrid(SlotMap<Character>& characters, SlotMap<Mob>& mobs);
+    void groupByShape();
+    // Hit queries for shapeOrder[begin, end). Only reads characters and mobs
+    // and only flags its own projectiles, so ranges run in parallel.
+    void queryHits(size_t begin, size_t end, float deltaTime, const SlotMap<Character>& characters,
+                   std::vector<uint32_t>& scratch, std::vector<ProjectileHit>& output);
+    // Runs one shape's swept test over a group of projectiles. The test
+    // returns the fraction of the step at first contact, or NO_SWEEP_HIT.
+    template <typename HitTest>
+    void collideGroup(const uint32_t* indices, size_t count, bool singleTarget, float deltaTime,
+                      const SlotMap<Character>& characters, std::vector<uint32_t>& scratch,
+                      std::vector<ProjectileHit>& output, HitTest hitTest);
+    // Where the projectile stopped flying this step and for how long it
+    // flew: the whole step, or up to where it landed or expired
+    float flightEnd(size_t index, float deltaTime, Position& end) const;
+    void recordHit(size_t index, uint32_t target, double fraction, const Position& start, const Position& end,
+                   float flightTime, std::vector<ProjectileHit>& output) const;
+    // Deals the damage for every entry of hits, in order, on the calling thread
+    void applyHits(SlotMap<Character>& characters, SlotMap<Mob>& mobs);
     
 public:
-    void spawnProjectile(const Ability& ability, Character& caster, const Position& direction);
-    void updateProjectiles(float deltaTime, std::vector<Character>& characters, std::vector<Mob>& mobs);
-    void checkCollisions(ProjectileInstance& projectile, std::vector<Character>& characters, std::vector<Mob>& mobs);
-    void removeInactiveProjectiles();
+    ProjectileManager();
+    
+    // Invalid id when the pool is full
+    ProjectileId spawnProjectile(const Ability& ability, Character& caster, const Position& direction);
+    // Spawns a fully described projectile, e.g. one bullet of a scripted pattern
+    ProjectileId spawnProjectile(const ProjectileInstance& projectile) { return pool.spawn(projectile); }
+    
+    // Moves every projectile, then tests the survivors against the targets
+    // near them: a grid of character and mob positions is rebuilt each call,
+    // and projectiles are tested one AbilityShape group at a time. Tests
+    // sweep the whole step, from where each projectile started to where it
+    // ended, so a fast projectile cannot pass through a target between ticks.
+    // One that lands or expires during the step is swept up to that moment,
+    // so what it hits does not depend on the tick rate.
+    // With a job pool, movement and hit queries run in parallel and only
+    // record hits; damage is then dealt on the calling thread in projectile
+    // order, so the outcome does not depend on the thread count.
+    void updateProjectiles(float deltaTime, SlotMap<Character>& characters, SlotMap<Mob>& mobs);
+    
+    // Drops projectiles fired by a character that is going away
+    void forgetCaster(const Character* caster);
+    
+    void setJobPool(JobPool* pool) { jobPool = pool; }  // Not owned; nullptr runs single-threaded
+    JobPool* getJobPool() const { return jobPool; }
+    
+    // Room for this many live projectiles; only grows. Spawning never allocates.
+    void setCapacity(size_t capacity) { pool.reserve(capacity); }
+    // Grid cell edge; about the typical hit reach works best
+    void setTargetCellSize(double size) { targetGrid.setCellSize(size); }
     
     // Getters for debugging/rendering
-    const std::vector<ProjectileInstance>& getActiveProjectiles() const { return activeProjectiles; }
-    size_t getProjectileCount() const { return activeProjectiles.size(); }
-    void clearAllProjectiles() { activeProjectiles.clear(); }
+    const ProjectilePool& getPool() const { return pool; }
+    size_t getProjectileCount() const { return pool.size(); }
+    // Every hit of the last updateProjectiles call, in the order applied
+    const std::vector<ProjectileHit>& getLastHits() const { return hits; }
+    void clearAllProjectiles() { pool.clear(); }
+};
+
+// Shared state touched by the engine's systems, as scheduler resource bits.
+// Characters and mobs are different archetypes in the EntityStore, so their
+// bits cover their store columns too. std::cout is not a resource: the
+// standard streams may be written from several threads, and lines logged by
+// systems in the same wave may interleave.
+namespace EngineResource {
+    const ResourceMask INPUT = 1u << 0;        // Input manager and camera
+    const ResourceMask CHARACTERS = 1u << 1;   // Characters and their store rows
+    const ResourceMask MOBS = 1u << 2;         // Mobs and their store rows
+    const ResourceMask PROJECTILES = 1u << 3;
+    const ResourceMask PHYSICS = 1u << 4;      // PhysicsSystem bodies and contacts
+}
+
+// INTERACTIVE drives a local player with camera and input. HEADLESS is a
+// dedicated simulation: no PlayerController, Camera or InputManager is
+// created and run() ticks the world without presenting frames.
+enum class EngineMode {
+    INTERACTIVE,
+    HEADLESS
 };
 
 class GameEngine {
 private:
-    std::vector<Character> characters;
-    std::vector<Mob> mobs;
+    EngineMode mode;
+    // Hot per-entity state (position, velocity, vitals, crowd control) of
+    // every added character and mob, in dense archetype columns. Declared
+    // before the slot maps so it outlives the entities attached to it.
+    EntityStore entityStore;
+    // Entities live in slot maps, so adding one never moves the others and
+    // Character*/Mob* held by projectiles and status effects stay valid
+    // until that entity is removed
+    SlotMap<Character> characters;
+    SlotMap<Mob> mobs;
+    std::unordered_map<std::string, CharacterHandle> characterNames;
     std::unique_ptr<ProjectileManager> projectileManager;
     std::unique_ptr<PlayerController> playerController;
     std::unique_ptr<PhysicsSystem> physicsSystem;
     
     // Timing
     std::chrono::steady_clock::time_point lastUpdateTime;
-    float targetFPS;
-    float fixedDeltaTime;
+    float targetFPS;           // Presentation rate of the run loop
+    float fixedDeltaTime;      // Simulation tick length, 1 / tick rate
     bool useFixedTimeStep;
     
+    // Fixed-step accumulator. Frame time is banked and spent in whole ticks;
+    // the remainder is carried over and exposed as the interpolation alpha.
+    double accumulator;
+    int maxSubsteps;           // Ticks allowed per frame before time is dropped
+    float interpolationAlpha;  // Share of a tick left in the accumulator, 0..1
+    uint64_t tickCount;
+    double droppedTime;        // Seconds discarded by the substep guard
+    
+    // Frame limiter for run(), and the optional tick rate adaptation that
+    // trades simulation rate for frame rate when the loop cannot keep up
+    FramePacer framePacer;
+    bool adaptiveTickRate;
+    float nominalTickRate;     // Rate set by setTickRate, the adaptive ceiling
+    float minTickRate;
+    int overloadedFrames;
+    int idleFrames;
+    
     // Game state
     bool isRunning;
     bool isPaused;
     
+    // Headless loop
+    bool headlessPaced;        // One tick per tick period instead of flat out
+    double ticksPerSecond;     // Measured by the last headless run
+    
+    int debugTickCounter;      // Ticks since the last periodic debug line
+    
+    // Systems run by update(); independent ones may run concurrently
+    SystemScheduler scheduler;
+    
+    void applyTickRate(float ticksPerSecond);
+    void registerSystems();
+    
 public:
-    GameEngine(float targetFPS = 60.0f, bool fixedTimeStep = false);
+    GameEngine(float targetFPS = 60.0f, bool fixedTimeStep = false,
+               EngineMode mode = EngineMode::INTERACTIVE);
     ~GameEngine();
     
     // Core game loop methods
@@ -80,36 +203,106 @@ public:
     void update(float deltaTime);
     void shutdown();
     
-    // Entity management
-    void addCharacter(const Character& character);
-    void addMob(const Mob& mob);
+    // Advances the simulation by one frame of wall time. With a fixed timestep
+    // this runs as many update(fixedDeltaTime) ticks as the accumulator holds,
+    // at most maxSubsteps, and returns how many ran. Otherwise it runs a
+    // single update with the frame time.
+    int advance(float frameTime);
+    
+    // Runs exactly one simulation tick of fixedDeltaTime
+    void tick();
+    
+    // Runs count simulation ticks of fixedDeltaTime back to back, or one per
+    // tick period when paced, and returns the ticks per second achieved.
+    // This is what run() does in headless mode.
+    double runTicks(uint64_t count);
+    
+    // Entity management. Character names are unique keys; adding a second
+    // character with a taken name leaves the name pointing at the first.
+    CharacterHandle addCharacter(const Character& character);
+    MobHandle addMob(const Mob& mob);
+    bool removeCharacter(CharacterHandle handle);
+    bool removeMob(MobHandle handle);
+    
+    // Lookups are O(1); null for unknown names and stale handles
     Character* getCharacter(const std::string& name);
-    Mob* getMob(size_t index);
+    Character* getCharacter(CharacterHandle handle) { return characters.get(handle); }
+    CharacterHandle findCharacter(const std::string& name) const;
+    Mob* getMob(MobHandle handle) { return mobs.get(handle); }
+    Mob* getMob(size_t index);  // Iteration order, which removals change
+    size_t getCharacterCount() const { return characters.size(); }
+    size_t getMobCount() const { return mobs.size(); }
+    EntityStore& getEntityStore() { return entityStore; }
     
     // Projectile system access
     ProjectileManager& getProjectileManager() { return *projectileManager; }
     
-    // Player controller access
+    // Player controller access; interactive mode only
     PlayerController& getPlayerController() { return *playerController; }
+    bool hasPlayerController() const { return playerController != nullptr; }
     
     // Physics system access
     PhysicsSystem& getPhysicsSystem() { return *physicsSystem; }
     
+    // System scheduling. With a job pool, systems whose resources do not
+    // conflict run concurrently; the pool is not owned.
+    SystemScheduler& getScheduler() { return scheduler; }
+    void setJobPool(JobPool* pool) {
+        scheduler.setJobPool(pool);
+        projectileManager->setJobPool(pool);
+    }
+    const std::vector<SystemTiming>& getSystemTimings() const { return scheduler.getTimings(); }
+    
     // Game state control
     void pause() { isPaused = true; }
     void resume() { isPaused = false; }
     void stop() { isRunning = false; }
     bool getIsRunning() const { return isRunning; }
     bool getIsPaused() const { return isPaused; }
+    EngineMode getMode() const { return mode; }
+    bool isHeadless() const { return mode == EngineMode::HEADLESS; }
+    void setHeadlessPaced(bool paced) { headlessPaced = paced; }
+    bool isHeadlessPaced() const { return headlessPaced; }
+    double getTicksPerSecond() const { return ticksPerSecond; }
     
     // Timing utilities
     float getDeltaTime();
+    float measureFrameTime();  // Seconds since the last measurement, uncapped
+
     float getTargetFPS() const { return targetFPS; }
-    void setTargetFPS(float fps) { targetFPS = fps; fixedDeltaTime = 1.0f / fps; }
+    void setTargetFPS(float fps) { targetFPS = fps; framePacer.setTargetFPS(fps); }
+    
+    // Simulation tick rate, independent of the presentation rate
+    float getTickRate() const { return 1.0f / fixedDeltaTime; }
+    float getFixedDeltaTime() const { return fixedDeltaTime; }
+    void setTickRate(float ticksPerSecond);
+    void setFixedTimeStep(bool enabled) { useFixedTimeStep = enabled; }
+    bool isFixedTimeStep() const { return useFixedTimeStep; }
+    void setMaxSubsteps(int count) { maxSubsteps = count > 0 ? count : 1; }
+    int getMaxSubsteps() const { return maxSubsteps; }
+    
+    // How far presentation is between the last two ticks; rendering and the
+    // camera blend previous and current state by this amount
+    float getInterpolationAlpha() const { return interpolationAlpha; }
+    uint64_t getTickCount() const { return tickCount; }
+    double getDroppedTime() const { return droppedTime; }
+    
+    // Frame pacing; frame time and jitter histograms live in the pacer
+    FramePacer& getFramePacer() { return framePacer; }
+    const FramePacer& getFramePacer() const { return framePacer; }
+    
+    // Lets the tick rate fall towards minimum while frames overrun their
+    // budget, and climb back to the nominal rate once there is headroom
+    void setAdaptiveTickRate(bool enabled, float minimum = 20.0f);
+    bool isAdaptiveTickRate() const { return adaptiveTickRate; }
+    // Feeds one frame's load, the share of its period spent working, to the
+    // adaptation; run() calls this after every frame
+    void adaptTickRate(double load);
     
     // Debug methods
     void printGameState() const;
     void printProjectileInfo() const;
+    void printSystemTimings() const;
 };
 
 #endif // GAMEENGINE_H
@@ -0,0 +1,19 @@
+#ifndef HASH_MIX_H
+#define HASH_MIX_H
+
+#include <cstddef>
+#include <cstdint>
+
+// splitmix64 finalizer. Spreads packed keys whose low bits barely differ,
+// such as neighbouring cells or adjacent slot pairs, across a power-of-two
+// open-addressing table.
+inline size_t mixHash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+#endif // HASH_MIX_H
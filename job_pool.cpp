@@ -0,0 +1,158 @@
+#include "job_pool.h"
+#include <algorithm>
+
+namespace {
+    // Which pool, if any, owns the current thread, and its queue index there
+    thread_local const JobPool* currentPool = nullptr;
+    thread_local size_t currentIndex = 0;
+
+    // Counts an outside thread as part of a pool until destroyed
+    struct OutsideClaim {
+        const JobPool* previousPool;
+        size_t previousIndex;
+
+        OutsideClaim(const JobPool* pool, size_t index) : previousPool(currentPool), previousIndex(currentIndex) {
+            currentPool = pool;
+            currentIndex = index;
+        }
+        ~OutsideClaim() {
+            currentPool = previousPool;
+            currentIndex = previousIndex;
+        }
+    };
+}
+
+JobPool::JobPool(size_t workerCount) : queuedTasks(0), stopping(false) {
+    for (size_t i = 0; i <= workerCount; ++i) {
+        queues.emplace_back(new WorkQueue());
+    }
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobPool::workerLoop, this, i);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t JobPool::defaultWorkerCount() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobPool::parallelFor(size_t count, size_t grainSize, const RangeFunction& function) {
+    if (count == 0) return;
+    if (currentPool == this) {
+        runBatch(count, grainSize, function, currentIndex);
+        return;
+    }
+
+    // Outside callers take turns on the last queue and thread index. The one
+    // holding it counts as part of the pool, so ranges that nest parallelFor()
+    // on its thread reuse the claim instead of waiting on themselves.
+    std::lock_guard<std::mutex> lock(outsideMutex);
+    OutsideClaim claim(this, workers.size());
+    runBatch(count, grainSize, function, workers.size());
+}
+
+void JobPool::runBatch(size_t count, size_t grainSize, const RangeFunction& function, size_t threadIndex) {
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t taskCount = (count + grainSize - 1) / grainSize;
+
+    // Nothing to share, or nobody to share with
+    if (taskCount == 1 || workers.empty()) {
+        for (size_t begin = 0; begin < count; begin += grainSize) {
+            function(begin, std::min(begin + grainSize, count), threadIndex);
+        }
+        return;
+    }
+
+    Batch batch;
+    batch.function = &function;
+    batch.remaining.store(taskCount);
+
+    {
+        WorkQueue& queue = *queues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t begin = 0; begin < count; begin += grainSize) {
+            queue.tasks.push_back(Task{&batch, begin, std::min(begin + grainSize, count)});
+        }
+    }
+    queuedTasks.fetch_add(taskCount);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_all();
+
+    // Help until the batch is done, which may mean running other batches' tasks
+    while (batch.remaining.load(std::memory_order_acquire) != 0) {
+        if (!runOneTask(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+bool JobPool::runOneTask(size_t threadIndex) {
+    Task task;
+    bool found = false;
+
+    // Own queue first, newest task, which is the one most likely still in cache
+    {
+        WorkQueue& queue = *queues[threadIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Then steal the oldest task from someone else
+    for (size_t offset = 1; !found && offset < queues.size(); ++offset) {
+        WorkQueue& queue = *queues[(threadIndex + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+
+    queuedTasks.fetch_sub(1);
+    // A throwing range still counts as finished, or its batch would never end
+    try {
+        (*task.batch->function)(task.begin, task.end, threadIndex);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task.batch->errorMutex);
+        if (!task.batch->error) {
+            task.batch->error = std::current_exception();
+        }
+    }
+    task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (runOneTask(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) return;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task queue each. Owners take work
+// from the back of their own queue and idle threads steal from the front of
+// the others. The thread that calls parallelFor() runs tasks while it waits,
+// so parallelFor() may be nested inside a task without deadlocking.
+// Threads outside the pool share one queue and thread index, so their
+// parallelFor() calls take turns rather than overlapping.
+class JobPool {
+public:
+    // Runs items [begin, end) on the thread with the given index,
+    // which is below getThreadCount()
+    using RangeFunction = std::function<void(size_t begin, size_t end, size_t threadIndex)>;
+
+private:
+    struct Batch {
+        const RangeFunction* function;
+        std::atomic<size_t> remaining;  // Tasks not yet finished
+        std::mutex errorMutex;
+        std::exception_ptr error;       // First exception thrown by a task
+    };
+
+    struct Task {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;  // One per worker, the last for outside callers
+    std::mutex outsideMutex;                         // Held by the outside caller using the last queue
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<size_t> queuedTasks;
+    bool stopping;
+
+public:
+    // workerCount threads are started; the calling thread is one more
+    explicit JobPool(size_t workerCount = defaultWorkerCount());
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // Splits [0, count) into ranges of at most grainSize items and blocks until
+    // every range has run. Range boundaries depend only on count and grainSize,
+    // so callers can write per-range results and merge them in a fixed order.
+    // The first exception thrown by a range is rethrown here once no range
+    // of the call is still running.
+    void parallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+    // Workers plus the calling thread; sizes per-thread scratch buffers
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    // One worker per hardware thread besides the caller
+    static size_t defaultWorkerCount();
+
+private:
+    void runBatch(size_t count, size_t grainSize, const RangeFunction& function, size_t threadIndex);
+    bool runOneTask(size_t threadIndex);
+    void workerLoop(size_t index);
+};
+
+#endif // JOB_POOL_H
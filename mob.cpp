@@ -3,7 +3,7 @@
 
 // Constructor implementation
 Mob::Mob(Race race)
-    : race(race), isStunned(false), isSilenced(false), isRooted(false) {
+    : race(race), isStunned(false), isSilenced(false), isRooted(false), entityStore(nullptr) {
     // Initialize with default stats based on race
     stattype baseStrength = race.getStrengthBonus();
     stattype baseDexterity = race.getDexterityBonus();
@@ -14,35 +14,163 @@ Mob::Mob(Race race)
     stats = StatBlock(baseStrength, baseDexterity, baseIntelligence, baseMaxHealth, baseMaxMana);
 }
 
+Mob::Mob(const Mob& other)
+    : race(other.race), stats(other.getStats()), position(other.getPosition()),
+      statusEffects(other.statusEffects), isStunned(other.getIsStunned()), isSilenced(other.getIsSilenced()),
+      isRooted(other.getIsRooted()), velocity(other.getVelocity()), entityStore(nullptr) {
+}
+
+Mob& Mob::operator=(const Mob& other) {
+    if (this == &other) return *this;
+    
+    race = other.race;
+    stats = other.getStats();
+    statusEffects = other.statusEffects;
+    
+    // An attached mob keeps its entity and takes the new values into it
+    setPosition(other.getPosition());
+    setVelocity(other.getVelocity());
+    setStunned(other.getIsStunned());
+    setSilenced(other.getIsSilenced());
+    setRooted(other.getIsRooted());
+    pushVitals();
+    return *this;
+}
+
+Mob::~Mob() {
+    if (entityStore) {
+        entityStore->destroy(entity);
+    }
+}
+
+// Entity store façade
+void Mob::attachToStore(EntityStore& store) {
+    if (entityStore == &store) return;
+    detachFromStore();
+    
+    entity = store.create(Component::TRANSFORM | Component::VELOCITY | Component::VITALS |
+                          Component::STATUS | Component::MOB);
+    entityStore = &store;
+    *store.getPosition(entity) = position;
+    *store.getVelocity(entity) = velocity;
+    setStunned(isStunned);
+    setSilenced(isSilenced);
+    setRooted(isRooted);
+    pushVitals();
+}
+
+void Mob::detachFromStore() {
+    if (!entityStore) return;
+    
+    pullVitals();
+    position = getPosition();
+    velocity = getVelocity();
+    isStunned = getIsStunned();
+    isSilenced = getIsSilenced();
+    isRooted = getIsRooted();
+    
+    entityStore->destroy(entity);
+    entityStore = nullptr;
+    entity = EntityId();
+}
+
+void Mob::pullVitals() {
+    if (!entityStore) return;
+    const Vitals& vitals = *entityStore->getVitals(entity);
+    stats.setMaxHealth(vitals.maxHealth);
+    stats.setHealth(vitals.health);
+    stats.setMaxMana(vitals.maxMana);
+    stats.setMana(vitals.mana);
+}
+
+void Mob::pushVitals() {
+    if (!entityStore) return;
+    Vitals& vitals = *entityStore->getVitals(entity);
+    vitals.health = stats.getHealth();
+    vitals.maxHealth = stats.getMaxHealth();
+    vitals.mana = stats.getMana();
+    vitals.maxMana = stats.getMaxMana();
+}
+
+void Mob::setStatusFlag(uint8_t flag, bool set) {
+    uint8_t& status = *entityStore->getStatus(entity);
+    status = set ? (status | flag) : (status & ~flag);
+}
+
 // Basic getter methods
 Race Mob::getRace() const { return race; }
-StatBlock Mob::getStats() const { return stats; }
 
-StatBlock& Mob::getStatsRef() { return stats; }
+StatBlock Mob::getStats() const {
+    if (!entityStore) return stats;
+    
+    StatBlock current = stats;
+    const Vitals& vitals = *entityStore->getVitals(entity);
+    current.setMaxHealth(vitals.maxHealth);
+    current.setHealth(vitals.health);
+    current.setMaxMana(vitals.maxMana);
+    current.setMana(vitals.mana);
+    return current;
+}
+
+StatBlock& Mob::getStatsRef() {
+    pullVitals();
+    return stats;
+}
+
+bool Mob::getIsStunned() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::STUNNED) != 0 : isStunned;
+}
+
+bool Mob::getIsSilenced() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::SILENCED) != 0 : isSilenced;
+}
+
+bool Mob::getIsRooted() const {
+    return entityStore ? (*entityStore->getStatus(entity) & StatusFlag::ROOTED) != 0 : isRooted;
+}
 
 // Position method implementations
-Position Mob::getPosition() const { return position; }
+Position Mob::getPosition() const {
+    return entityStore ? *entityStore->getPosition(entity) : position;
+}
 
 void Mob::setPosition(const Position& pos) {
-    position = pos;
+    if (entityStore) {
+        *entityStore->getPosition(entity) = pos;
+    } else {
+        position = pos;
+    }
 }
 
 void Mob::setPosition(double x, double y, double z) {
-    position.set(x, y, z);
+    setPosition(Position(x, y, z));
 }
 
 void Mob::move(double deltaX, double deltaY, double deltaZ) {
-    position.move(deltaX, deltaY, deltaZ);
+    Position& target = entityStore ? *entityStore->getPosition(entity) : position;
+    target.move(deltaX, deltaY, deltaZ);
 }
 
 double Mob::distanceTo(const Mob& other) const {
-    return position.distanceTo(other.getPosition());
+    return getPosition().distanceTo(other.getPosition());
 }
 
 // Removed Character distance method to avoid circular dependency
 
 double Mob::distanceTo(const Position& pos) const {
-    return position.distanceTo(pos);
+    return getPosition().distanceTo(pos);
+}
+
+Position Mob::getVelocity() const {
+    return entityStore ? *entityStore->getVelocity(entity) : velocity;
+}
+
+void Mob::setVelocity(const Position& newVelocity) {
+    if (entityStore) {
+        *entityStore->getVelocity(entity) = newVelocity;
+    } else {
+        velocity = newVelocity;
+    }
 }
 
 // Description methods
@@ -51,24 +179,32 @@ std::string Mob::getDescription() const {
 }
 
 std::string Mob::getFullDescription() const {
-    return race.getName() + " - HP: " + std::to_string(stats.getHealth()) + "/" + std::to_string(stats.getMaxHealth());
+    return race.getName() + " - HP: " + std::to_string(getStats().getHealth()) + "/" + std::to_string(getStats().getMaxHealth());
 }
 
 // Combat methods
 void Mob::damage(welltype amount) {
+    pullVitals();
     stats.damage(amount);
+    pushVitals();
 }
 
 void Mob::heal(welltype amount) {
+    pullVitals();
     stats.heal(amount);
+    pushVitals();
 }
 
 void Mob::restoreMana(welltype amount) {
+    pullVitals();
     stats.restoreMana(amount);
+    pushVitals();
 }
 
 void Mob::consumeMana(welltype amount) {
+    pullVitals();
     stats.consumeMana(amount);
+    pushVitals();
 }
 
 // Status effect management methods
@@ -137,6 +273,12 @@ bool Mob::hasStatusEffect(const std::string& effectName) const {
     return false;
 }
 
+void Mob::rebindStatusEffects() {
+    for (auto& effect : statusEffects) {
+        effect.setMobTarget(this);
+    }
+}
+
 // Stat modification methods for status effects
 void Mob::modifyStrength(stattype amount) {
     stats.setStrength(stats.getStrength() + amount);
@@ -151,22 +293,74 @@ void Mob::modifyIntelligence(stattype amount) {
 }
 
 void Mob::modifyMaxHealth(welltype amount) {
+    pullVitals();
     stats.setMaxHealth(stats.getMaxHealth() + amount);
+    pushVitals();
 }
 
 void Mob::modifyMaxMana(welltype amount) {
+    pullVitals();
     stats.setMaxMana(stats.getMaxMana() + amount);
+    pushVitals();
+}
+
+void Mob::setStrength(stattype value) {
+    stats.setStrength(value);
+}
+
+void Mob::setDexterity(stattype value) {
+    stats.setDexterity(value);
+}
+
+void Mob::setIntelligence(stattype value) {
+    stats.setIntelligence(value);
+}
+
+void Mob::setMaxHealth(welltype value) {
+    pullVitals();
+    stats.setMaxHealth(value);
+    pushVitals();
+}
+
+void Mob::setMaxMana(welltype value) {
+    pullVitals();
+    stats.setMaxMana(value);
+    pushVitals();
+}
+
+void Mob::setMovementSpeed(float speed) {
+    stats.setMovementSpeed(speed);
+}
+
+void Mob::setAttackSpeed(float speed) {
+    stats.setAttackSpeed(speed);
+}
+
+void Mob::setDamageMultiplier(float multiplier) {
+    stats.setDamageMultiplier(multiplier);
 }
 
 // Crowd control methods for status effects
 void Mob::setStunned(bool stunned) {
-    isStunned = stunned;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::STUNNED, stunned);
+    } else {
+        isStunned = stunned;
+    }
 }
 
 void Mob::setSilenced(bool silenced) {
-    isSilenced = silenced;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::SILENCED, silenced);
+    } else {
+        isSilenced = silenced;
+    }
 }
 
 void Mob::setRooted(bool rooted) {
-    isRooted = rooted;
+    if (entityStore) {
+        setStatusFlag(StatusFlag::ROOTED, rooted);
+    } else {
+        isRooted = rooted;
+    }
 }
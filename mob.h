@@ -1,7 +1,11 @@
+#ifndef MOB_H
+#define MOB_H
+
 #include "types.h"
 #include "race.h"
 #include "statblock.h"
 #include "position.h"
+#include "entity_store.h"
 #include <string>
 #include <vector> // Added for std::vector
 #include "statuseffect.h" // Added for StatusEffect
@@ -17,19 +21,45 @@ class Mob {
         bool isStunned;        // Cannot act
         bool isSilenced;       // Cannot cast spells
         bool isRooted;         // Cannot move
+        
+        Position velocity;     // Units per second
+        
+        // While attached to an entity store, position, velocity, crowd control
+        // flags, health and mana live there and the fields above are unused
+        EntityStore* entityStore;
+        EntityId entity;
+        
+        void pullVitals();     // Store health and mana into stats
+        void pushVitals();     // stats health and mana into the store
+        void setStatusFlag(uint8_t flag, bool set);
 
     public:
         Mob(Race race);
         
+        // Copies start detached, holding the source's current hot state
+        Mob(const Mob& other);
+        Mob& operator=(const Mob& other);
+        ~Mob();
+        
+        // Entity store façade
+        void attachToStore(EntityStore& store);
+        void detachFromStore();
+        bool isAttached() const { return entityStore != nullptr; }
+        EntityId getEntityId() const { return entity; }
+        
         // Basic getter methods
         Race getRace() const;
         StatBlock getStats() const;
-        StatBlock& getStatsRef(); // Non-const reference for modifications
+        // Non-const reference for modifications. While attached, health, mana
+        // and their maximums live in the store: they are current in the
+        // reference, but change them with heal, damage, restoreMana,
+        // consumeMana, setMaxHealth and setMaxMana
+        StatBlock& getStatsRef();
         
         // Crowd control getters
-        bool getIsStunned() const { return isStunned; }
-        bool getIsSilenced() const { return isSilenced; }
-        bool getIsRooted() const { return isRooted; }
+        bool getIsStunned() const;
+        bool getIsSilenced() const;
+        bool getIsRooted() const;
         
         // Position method implementations
         Position getPosition() const;
@@ -38,6 +68,8 @@ class Mob {
         void move(double deltaX, double deltaY, double deltaZ);
         double distanceTo(const Mob& other) const;
         double distanceTo(const Position& pos) const;
+        Position getVelocity() const;
+        void setVelocity(const Position& newVelocity);
         
         // Status effect management
         void addStatusEffect(const StatusEffect& effect);
@@ -45,6 +77,7 @@ class Mob {
         void updateStatusEffects(float deltaTime);
         const std::vector<StatusEffect>& getStatusEffects() const;
         bool hasStatusEffect(const std::string& effectName) const;
+        void rebindStatusEffects();  // Points copied effects at this mob
         
         // Stat modification methods (for status effects)
         void modifyStrength(stattype amount);
@@ -52,6 +85,14 @@ class Mob {
         void modifyIntelligence(stattype amount);
         void modifyMaxHealth(welltype amount);
         void modifyMaxMana(welltype amount);
+        void setStrength(stattype value);
+        void setDexterity(stattype value);
+        void setIntelligence(stattype value);
+        void setMaxHealth(welltype value);
+        void setMaxMana(welltype value);
+        void setMovementSpeed(float speed);
+        void setAttackSpeed(float speed);
+        void setDamageMultiplier(float multiplier);
         
         // Crowd control methods (for status effects)
         void setStunned(bool stunned);
@@ -67,4 +108,6 @@ class Mob {
         void heal(welltype amount);
         void restoreMana(welltype amount);
         void consumeMana(welltype amount);
-};
\ No newline at end of file
+};
+
+#endif // MOB_H
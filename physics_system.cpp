@@ -1,22 +1,58 @@
 #include "physics_system.h"
+#include "job_pool.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
-PhysicsSystem::PhysicsSystem() : cellSize(10.0f), gridBounds(100.0f, 100.0f, 20.0f) {
-    std::cout << "PhysicsSystem initialized" << std::endl;
+namespace {
+    const size_t SHAPE_COUNT = static_cast<size_t>(ShapeType::COUNT);
+    
+    // Items per range handed to the job pool in each parallel phase
+    const size_t INTEGRATION_GRAIN = 1024;
+    const size_t CELL_GRAIN = 256;
+    const size_t SWEEP_GRAIN = 512;
+    const size_t NARROWPHASE_GRAIN = 2048;
+    
+    // How far a swept body is placed inside what it hit, so the narrowphase
+    // reports the contact and the solver stops it
+    const double SWEEP_CONTACT_DEPTH = 0.02;
     
-    // Initialize spatial grid
-    int gridX = static_cast<int>(gridBounds.getX() / cellSize) + 1;
-    int gridY = static_cast<int>(gridBounds.getY() / cellSize) + 1;
-    int gridZ = static_cast<int>(gridBounds.getZ() / cellSize) + 1;
+    // Sphere candidates a ray collects before they are tested together
+    const size_t RAY_BATCH_SIZE = 16;
+    
+    double axisComponent(const Position& position, int axis) {
+        return axis == 0 ? position.getX() : (axis == 1 ? position.getY() : position.getZ());
+    }
     
-    spatialGrid.resize(gridX);
-    for (auto& xLayer : spatialGrid) {
-        xLayer.resize(gridY);
-        for (auto& yLayer : xLayer) {
-            yLayer.resize(gridZ);
+    // Runs one shape-pair test over a run of pairs. The test is a template
+    // argument, so it is inlined into the loop instead of dispatched per pair.
+    template <ShapePairTest Test>
+    void runShapeBatch(const BodyPair* pairs, size_t count, std::vector<BodyPair>& contacts) {
+        for (size_t i = 0; i < count; ++i) {
+            const BodyPair& pair = pairs[i];
+            if (Test(pair.first->position, pair.first->shape, pair.second->position, pair.second->shape)) {
+                contacts.push_back(pair);
+            }
         }
     }
+    
+    using ShapeBatchTest = void (*)(const BodyPair*, size_t, std::vector<BodyPair>&);
+    
+    // Batches are keyed with the lower shape type first, so only the upper triangle is filled
+    const ShapeBatchTest SHAPE_BATCH_TESTS[SHAPE_COUNT][SHAPE_COUNT] = {
+        // NONE   SPHERE                            AABB
+        {nullptr, nullptr,                          nullptr},                        // NONE
+        {nullptr, runShapeBatch<testSphereSphere>,  runShapeBatch<testSphereAABB>},  // SPHERE
+        {nullptr, nullptr,                          runShapeBatch<testAABBAABB>},    // AABB
+    };
+}
+
+PhysicsSystem::PhysicsSystem(BroadphaseType broadphase)
+    : poolLifetime(std::make_shared<int>(0)), broadphaseType(broadphase),
+      jobPool(nullptr), spatialHash(10.0f),
+      sweepNeedsPrune(false), sweepAxis(-1), runningCallbacks(false), rayStamp(0), queryGridStale(false) {
+    std::cout << "PhysicsSystem initialized" << std::endl;
 }
 
 PhysicsSystem::~PhysicsSystem() {
@@ -24,372 +60,905 @@ PhysicsSystem::~PhysicsSystem() {
 }
 
 void PhysicsSystem::update(float deltaTime) {
+    lastStepStats = PhysicsStepStats();
+    
+    for (size_t i = 0; i < fastBodies.size(); ++i) {
+        fastBodyStarts[i] = bodies.atSlot(fastBodies[i]).position;
+    }
+    
     simulatePhysics(deltaTime);
+    if (broadphaseType == BroadphaseType::UNIFORM_GRID) {
+        updateSpatialGrid();
+    }
+    sweepFastBodies();
+    buildCandidatePairs();
     detectCollisions();
     resolveCollisions();
-    updateSpatialGrid();
+    updateSleeping(deltaTime);
 }
 
 void PhysicsSystem::simulatePhysics(float deltaTime) {
-    for (auto& body : bodies) {
-        if (!body->isActive || body->bodyType == BodyType::STATIC) continue;
+    queryGridStale = true;
+    
+    // Bodies integrate independently, so any split of the pool works
+    runRanges(bodies.size(), INTEGRATION_GRAIN, [this, deltaTime](size_t begin, size_t end, size_t) {
+        integrateBodies(begin, end, deltaTime);
+    });
+}
+
+void PhysicsSystem::integrateBodies(size_t begin, size_t end, float deltaTime) {
+    // Dense pool iteration, no reference counting per body. Position, velocity
+    // and force stay inline in PhysicsBody: copying them into arrays for a
+    // vector kernel cost more than the kernel saved, and persistent columns
+    // would change every caller that reads body->position.
+    for (size_t i = begin; i < end; ++i) {
+        PhysicsBody& body = bodies[i];
+        if (!body.isActive || body.isSleeping || body.bodyType == BodyType::STATIC) continue;
         
         applyForces(body, deltaTime);
         integrateVelocity(body, deltaTime);
         clampVelocity(body);
-        updateBodyTransform(body, deltaTime);
     }
 }
 
-void PhysicsSystem::detectCollisions() {
-    // Simple broad phase collision detection using spatial grid
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        if (!bodies[i]->isActive) continue;
+void PhysicsSystem::buildCandidatePairs() {
+    candidatePairs.clear();
+    
+    if (broadphaseType == BroadphaseType::SORT_AND_SWEEP) {
+        buildSweepPairs();
+    } else {
+        buildGridPairs();
+    }
+    
+    lastStepStats.candidatePairs = candidatePairs.size();
+}
+
+void PhysicsSystem::runRanges(size_t count, size_t grainSize, const std::function<void(size_t, size_t, size_t)>& function) {
+    if (jobPool) {
+        jobPool->parallelFor(count, grainSize, function);
+    } else if (count > 0) {
+        function(0, count, 0);
+    }
+}
+
+void PhysicsSystem::collectPairs(size_t count, size_t grainSize, std::vector<BodyPair>& output,
+                                 const std::function<void(size_t, size_t, std::vector<BodyPair>&)>& emit) {
+    if (!jobPool) {
+        emit(0, count, output);
+        return;
+    }
+    
+    // Each range writes its own buffer and the buffers are appended in range
+    // order, so the output matches a single-threaded run for any thread count
+    size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (pairChunks.size() < chunkCount) {
+        pairChunks.resize(chunkCount);
+    }
+    for (size_t i = 0; i < chunkCount; ++i) {
+        pairChunks[i].clear();
+    }
+    
+    jobPool->parallelFor(count, grainSize, [this, grainSize, &emit](size_t begin, size_t end, size_t) {
+        emit(begin, end, pairChunks[begin / grainSize]);
+    });
+    
+    for (size_t i = 0; i < chunkCount; ++i) {
+        output.insert(output.end(), pairChunks[i].begin(), pairChunks[i].end());
+    }
+}
+
+void PhysicsSystem::buildGridPairs() {
+    if (!jobPool) {
+        spatialHash.forEachCell([this](const SpatialHash::Cell& cell) {
+            emitCellPairs(cell, candidatePairs);
+        });
+        return;
+    }
+    
+    // Cells are independent, so ranges of the cell storage run in parallel
+    collectPairs(spatialHash.getCellStorageSize(), CELL_GRAIN, candidatePairs,
+                 [this](size_t begin, size_t end, std::vector<BodyPair>& output) {
+        for (size_t i = begin; i < end; ++i) {
+            const SpatialHash::Cell& cell = spatialHash.getCellAt(i);
+            if (!cell.ids.empty()) emitCellPairs(cell, output);
+        }
+    });
+}
+
+void PhysicsSystem::emitCellPairs(const SpatialHash::Cell& cell, std::vector<BodyPair>& output) {
+    // A pair sharing several cells is only emitted from the first cell of
+    // the overlap of both bodies' cell ranges, so the list has no duplicates
+    const std::vector<uint32_t>& cellBodies = cell.ids;
+    
+    for (size_t i = 0; i < cellBodies.size(); ++i) {
+        const CellRange& rangeA = spatialHash.getProxyRange(cellBodies[i]);
         
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            if (!bodies[j]->isActive) continue;
+        for (size_t j = i + 1; j < cellBodies.size(); ++j) {
+            const CellRange& rangeB = spatialHash.getProxyRange(cellBodies[j]);
             
-            if (checkCollision(bodies[i].get(), bodies[j].get())) {
-                // Collision detected - trigger callbacks
-                if (bodies[i]->onCollisionEnter) {
-                    bodies[i]->onCollisionEnter(bodies[j].get());
-                }
-                if (bodies[j]->onCollisionEnter) {
-                    bodies[j]->onCollisionEnter(bodies[i].get());
-                }
+            if (std::max(rangeA.minX, rangeB.minX) != cell.x ||
+                std::max(rangeA.minY, rangeB.minY) != cell.y ||
+                std::max(rangeA.minZ, rangeB.minZ) != cell.z) {
+                continue;
             }
+            
+            PhysicsBody& bodyA = bodies.atSlot(cellBodies[i]);
+            PhysicsBody& bodyB = bodies.atSlot(cellBodies[j]);
+            if (isRestingPair(bodyA, bodyB)) continue;
+            
+            output.emplace_back(&bodyA, &bodyB);
         }
     }
 }
 
-void PhysicsSystem::resolveCollisions() {
-    // Simple collision resolution - push bodies apart
+void PhysicsSystem::buildSweepPairs() {
+    updateSweepOrder();
+    
+    const int axisB = (sweepAxis + 1) % 3;
+    const int axisC = (sweepAxis + 2) % 3;
+    
+    // Pack the active intervals in sweep order so the inner loop reads memory linearly
+    sweepSorted.clear();
+    sweepSortedSlot.clear();
+    for (uint32_t slot : sweepOrder) {
+        if (bodies.atSlot(slot).isActive) {
+            const SweepBounds& bounds = sweepBounds[slot];
+            SweepEntry entry;
+            entry.minSweep = bounds.min[sweepAxis];
+            entry.maxSweep = bounds.max[sweepAxis];
+            entry.minB = bounds.min[axisB];
+            entry.maxB = bounds.max[axisB];
+            entry.minC = bounds.min[axisC];
+            entry.maxC = bounds.max[axisC];
+            sweepSorted.push_back(entry);
+            sweepSortedSlot.push_back(slot);
+        }
+    }
+    
+    collectPairs(sweepSorted.size(), SWEEP_GRAIN, candidatePairs,
+                 [this](size_t begin, size_t end, std::vector<BodyPair>& output) {
+        emitSweepPairs(begin, end, output);
+    });
+}
+
+void PhysicsSystem::emitSweepPairs(size_t begin, size_t end, std::vector<BodyPair>& output) {
+    const size_t count = sweepSorted.size();
+    for (size_t i = begin; i < end; ++i) {
+        const SweepEntry a = sweepSorted[i];
+        
+        for (size_t j = i + 1; j < count; ++j) {
+            const SweepEntry& b = sweepSorted[j];
+            
+            // Every later interval starts even further along the axis
+            if (b.minSweep > a.maxSweep) break;
+            
+            // Non-short-circuit tests keep this mostly-false branch predictable
+            bool overlaps = (a.maxB >= b.minB) & (a.minB <= b.maxB) & (a.maxC >= b.minC) & (a.minC <= b.maxC);
+            if (!overlaps) continue;
+            
+            PhysicsBody& bodyA = bodies.atSlot(sweepSortedSlot[i]);
+            PhysicsBody& bodyB = bodies.atSlot(sweepSortedSlot[j]);
+            if (isRestingPair(bodyA, bodyB)) continue;
+            
+            output.emplace_back(&bodyA, &bodyB);
+        }
+    }
+}
+
+void PhysicsSystem::updateSweepOrder() {
+    sweepBounds.resize(bodies.getSlotCapacity());
+    sweepListed.resize(bodies.getSlotCapacity(), 0);
+    
+    // Refresh intervals and pick the axis with the largest spread of centers
+    double mean[3] = {0.0, 0.0, 0.0};
+    double meanSquare[3] = {0.0, 0.0, 0.0};
+    
     for (size_t i = 0; i < bodies.size(); ++i) {
-        if (!bodies[i]->isActive || bodies[i]->bodyType == BodyType::STATIC) continue;
+        const PhysicsBody& body = bodies[i];
+        SweepBounds& bounds = sweepBounds[bodies.slotAt(i)];
+        float radius = body.shape.getBoundingRadius();
+        double center[3] = {body.position.getX(), body.position.getY(), body.position.getZ()};
         
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            if (!bodies[j]->isActive || bodies[j]->bodyType == BodyType::STATIC) continue;
+        for (int axis = 0; axis < 3; ++axis) {
+            bounds.min[axis] = center[axis] - radius;
+            bounds.max[axis] = center[axis] + radius;
+            mean[axis] += center[axis];
+            meanSquare[axis] += center[axis] * center[axis];
+        }
+    }
+    
+    double variance[3];
+    int dominantAxis = 0;
+    double count = static_cast<double>(std::max<size_t>(bodies.size(), 1));
+    for (int axis = 0; axis < 3; ++axis) {
+        variance[axis] = meanSquare[axis] / count - (mean[axis] / count) * (mean[axis] / count);
+        if (variance[axis] > variance[dominantAxis]) {
+            dominantAxis = axis;
+        }
+    }
+    
+    // Only switch axis on a clear win, since every switch costs a full sort
+    if (sweepAxis >= 0 && variance[dominantAxis] < variance[sweepAxis] * 1.25) {
+        dominantAxis = sweepAxis;
+    }
+    
+    // Drop destroyed slots; a slot reused since then is still listed and stays put
+    if (sweepNeedsPrune) {
+        auto dead = std::remove_if(sweepOrder.begin(), sweepOrder.end(), [this](uint32_t slot) {
+            if (bodies.isSlotLive(slot)) return false;
+            sweepListed[slot] = 0;
+            return true;
+        });
+        sweepOrder.erase(dead, sweepOrder.end());
+        sweepNeedsPrune = false;
+    }
+    
+    for (uint32_t slot : sweepPending) {
+        if (bodies.isSlotLive(slot) && !sweepListed[slot]) {
+            sweepListed[slot] = 1;
+            sweepOrder.push_back(slot);
+        }
+    }
+    sweepPending.clear();
+    
+    auto startsBefore = [this](uint32_t a, uint32_t b) {
+        return sweepBounds[a].min[sweepAxis] < sweepBounds[b].min[sweepAxis];
+    };
+    
+    if (dominantAxis != sweepAxis) {
+        // The previous order says nothing about the new axis
+        sweepAxis = dominantAxis;
+        std::sort(sweepOrder.begin(), sweepOrder.end(), startsBefore);
+        return;
+    }
+    
+    // Bodies move little between steps, so insertion sort is close to O(n)
+    for (size_t i = 1; i < sweepOrder.size(); ++i) {
+        uint32_t slot = sweepOrder[i];
+        size_t j = i;
+        while (j > 0 && startsBefore(slot, sweepOrder[j - 1])) {
+            sweepOrder[j] = sweepOrder[j - 1];
+            --j;
+        }
+        sweepOrder[j] = slot;
+    }
+}
+
+void PhysicsSystem::detectCollisions() {
+    contactPairs.clear();
+    shapePairBatches.resize(SHAPE_COUNT * SHAPE_COUNT);
+    for (std::vector<BodyPair>& batch : shapePairBatches) {
+        batch.clear();
+    }
+    
+    // Bucket candidates by shape pair, lower shape type first
+    for (const BodyPair& pair : candidatePairs) {
+        size_t typeA = static_cast<size_t>(pair.first->shape.type);
+        size_t typeB = static_cast<size_t>(pair.second->shape.type);
+        
+        if (typeA <= typeB) {
+            shapePairBatches[typeA * SHAPE_COUNT + typeB].push_back(pair);
+        } else {
+            shapePairBatches[typeB * SHAPE_COUNT + typeA].emplace_back(pair.second, pair.first);
+        }
+    }
+    
+    // One tight loop per shape pair; pairs involving NONE have no test
+    for (size_t typeA = 0; typeA < SHAPE_COUNT; ++typeA) {
+        for (size_t typeB = typeA; typeB < SHAPE_COUNT; ++typeB) {
+            ShapeBatchTest test = SHAPE_BATCH_TESTS[typeA][typeB];
+            const std::vector<BodyPair>& batch = shapePairBatches[typeA * SHAPE_COUNT + typeB];
+            if (!test || batch.empty()) continue;
             
-            if (checkCollision(bodies[i].get(), bodies[j].get())) {
-                // Calculate separation vector
-                Position separation = bodies[i]->position - bodies[j]->position;
-                double distance = separation.length();
-                
-                if (distance > 0) {
-                    double minDistance = 1.0; // Minimum separation distance
-                    double overlap = minDistance - distance;
-                    
-                    if (overlap > 0) {
-                        Position separationDir = separation.normalize();
-                        Position correction = separationDir * (overlap * 0.5);
-                        
-                        // Move bodies apart
-                        if (bodies[i]->bodyType == BodyType::DYNAMIC) {
-                            bodies[i]->position = bodies[i]->position + correction;
-                        }
-                        if (bodies[j]->bodyType == BodyType::DYNAMIC) {
-                            bodies[j]->position = bodies[j]->position - correction;
-                        }
-                    }
-                }
-            }
+            lastStepStats.narrowphaseTests += batch.size();
+            collectPairs(batch.size(), NARROWPHASE_GRAIN, contactPairs,
+                         [test, &batch](size_t begin, size_t end, std::vector<BodyPair>& output) {
+                test(batch.data() + begin, end - begin, output);
+            });
+        }
+    }
+    
+    // Diff against the previous step while sleep states still match the broadphase
+    contactManager.update(contactPairs);
+    
+    // A moving body touching a sleeping one wakes it
+    for (const BodyPair& pair : contactPairs) {
+        if (pair.first->isSleeping && !pair.second->isSleeping && pair.second->bodyType != BodyType::STATIC) {
+            wakeBody(*pair.first);
+        } else if (pair.second->isSleeping && !pair.first->isSleeping && pair.first->bodyType != BodyType::STATIC) {
+            wakeBody(*pair.second);
         }
     }
+    
+    // Run the callbacks in one pass. The event lists must not change under
+    // them, so bodies they destroy are freed afterwards.
+    runningCallbacks = true;
+    contactManager.dispatchEvents();
+    runningCallbacks = false;
+    
+    lastStepStats.contacts = contactPairs.size();
+    lastStepStats.contactsEntered = contactManager.getEnterCount();
+    lastStepStats.contactsExited = contactManager.getExitCount();
+    destroyDeferredBodies();
 }
 
-std::shared_ptr<PhysicsBody> PhysicsSystem::createBody(const Position& position, float mass) {
-    auto body = std::make_shared<PhysicsBody>();
-    body->position = position;
-    body->mass = mass;
-    body->invMass = (mass > 0) ? 1.0f / mass : 0.0f;
+void PhysicsSystem::resolveCollisions() {
+    queryGridStale = true;
     
-    // Create default sphere collider
-    body->collider = std::make_shared<SphereCollider>(position, 1.0f);
+    // The manager's list also holds carried-over resting contacts and the
+    // impulses of the previous step for warm starting
+    contactSolver.solve(contactManager.getActiveContacts());
     
-    addBody(body);
-    return body;
+    lastStepStats.solvedContacts = contactSolver.getConstraintCount();
+    lastStepStats.maxPenetration = contactSolver.getMaxPenetration();
 }
 
-void PhysicsSystem::addBody(std::shared_ptr<PhysicsBody> body) {
-    bodies.push_back(body);
-    addBodyToGrid(body);
+BodyHandle PhysicsSystem::spawnBody(const Position& position, float mass) {
+    BodyHandle handle = bodies.emplace();
+    PhysicsBody& body = *bodies.get(handle);
+    body.handle = handle;
+    body.position = position;
+    body.mass = mass;
+    body.invMass = (mass > 0) ? 1.0f / mass : 0.0f;
+    
+    // Default sphere collider
+    body.shape = ColliderShape::sphere(1.0f);
+    
+    addBodyToGrid(handle.index);
+    if (broadphaseType == BroadphaseType::SORT_AND_SWEEP) {
+        sweepPending.push_back(handle.index);
+    }
+    return handle;
 }
 
-void PhysicsSystem::removeBody(std::shared_ptr<PhysicsBody> body) {
-    removeBodyFromGrid(body);
-    bodies.erase(std::remove(bodies.begin(), bodies.end(), body), bodies.end());
+void PhysicsSystem::destroyBody(BodyHandle handle) {
+    if (!bodies.contains(handle)) return;
+    if (runningCallbacks) {
+        deferredDestroys.push_back(handle);
+        return;
+    }
+    
+    // Partners get their Exit callbacks, which may destroy bodies in turn
+    runningCallbacks = true;
+    contactManager.removeBody(bodies.get(handle));
+    runningCallbacks = false;
+    
+    spatialHash.remove(handle.index);
+    setBodyFastMoving(handle, false);
+    bodies.erase(handle);
+    
+    // Pair lists hold raw pointers into the pool; the sweep order is pruned lazily
+    candidatePairs.clear();
+    contactPairs.clear();
+    sweepNeedsPrune = true;
+    destroyDeferredBodies();
+}
+
+void PhysicsSystem::destroyDeferredBodies() {
+    // Each destroy may defer more; a handle queued twice is skipped the second time
+    while (!deferredDestroys.empty()) {
+        BodyHandle handle = deferredDestroys.back();
+        deferredDestroys.pop_back();
+        destroyBody(handle);
+    }
 }
 
 void PhysicsSystem::clearAllBodies() {
     bodies.clear();
-    // Clear spatial grid
-    for (auto& xLayer : spatialGrid) {
-        for (auto& yLayer : xLayer) {
-            for (auto& zLayer : yLayer) {
-                zLayer.bodies.clear();
+    fastBodies.clear();
+    fastBodyStarts.clear();
+    candidatePairs.clear();
+    contactPairs.clear();
+    contactManager.clear();
+    deferredDestroys.clear();
+    sweepOrder.clear();
+    sweepBounds.clear();
+    sweepListed.clear();
+    sweepPending.clear();
+    sweepNeedsPrune = false;
+    sweepAxis = -1;
+    spatialHash.clear();
+}
+
+void PhysicsSystem::sweepFastBodies() {
+    for (size_t i = 0; i < fastBodies.size(); ++i) {
+        PhysicsBody& body = bodies.atSlot(fastBodies[i]);
+        if (!body.isActive || body.isSleeping || body.bodyType != BodyType::DYNAMIC) continue;
+        if (body.shape.type == ShapeType::NONE) continue;
+        
+        // A body moving less than its radius overlaps anything it passes at
+        // one of the discrete positions, so only longer moves are swept
+        const Position& start = fastBodyStarts[i];
+        Position motion = body.position - start;
+        double travel = motion.length();
+        double radius = body.shape.getBoundingRadius();
+        if (travel < radius) continue;
+        lastStepStats.sweptBodies++;
+        
+        Position direction = motion * (1.0 / travel);
+        Position sweepMin(std::min(start.getX(), body.position.getX()) - radius,
+                          std::min(start.getY(), body.position.getY()) - radius,
+                          std::min(start.getZ(), body.position.getZ()) - radius);
+        Position sweepMax(std::max(start.getX(), body.position.getX()) + radius,
+                          std::max(start.getY(), body.position.getY()) + radius,
+                          std::max(start.getZ(), body.position.getZ()) + radius);
+        
+        // Time of impact as a distance along the move. The swept sphere against
+        // a sphere is a ray against the sphere grown by the radius; against a
+        // box it is a ray against the grown box, which is slightly early at corners.
+        double firstHit = travel;
+        forEachQueryCandidate(sweepMin, sweepMax, [&](PhysicsBody& other) {
+            if (&other == &body || other.isTrigger || other.shape.type == ShapeType::NONE) return;
+            
+            Position offset = other.position - start;
+            double distance = -1.0;
+            if (other.shape.type == ShapeType::SPHERE) {
+                double reach = radius + other.shape.radius;
+                double projection = offset.dot(direction);
+                double outside = offset.dot(offset) - reach * reach;
+                double discriminant = projection * projection - outside;
+                
+                // Bodies already touching at the start are left to the narrowphase
+                if (outside > 0.0 && discriminant >= 0.0) {
+                    distance = projection - std::sqrt(discriminant);
+                }
+            } else {
+                const Position& half = other.shape.halfExtents;
+                distance = intersectRayBox(offset.getX(), offset.getY(), offset.getZ(),
+                                           half.getX() + radius, half.getY() + radius, half.getZ() + radius,
+                                           direction.getX(), direction.getY(), direction.getZ(), firstHit);
+            }
+            if (distance >= 0.0 && distance < firstHit) {
+                firstHit = distance;
+            }
+        });
+        
+        if (firstHit < travel) {
+            body.position = start + direction * std::min(firstHit + SWEEP_CONTACT_DEPTH, travel);
+            lastStepStats.sweepHits++;
+            if (broadphaseType == BroadphaseType::UNIFORM_GRID) {
+                addBodyToGrid(fastBodies[i]);
             }
         }
     }
 }
 
-bool PhysicsSystem::checkCollision(const PhysicsBody* body1, const PhysicsBody* body2) const {
-    if (!body1->collider || !body2->collider) return false;
-    return body1->collider->checkCollision(body2->collider.get());
-}
-
-std::vector<std::shared_ptr<PhysicsBody>> PhysicsSystem::getBodiesInRadius(const Position& center, float radius) {
-    std::vector<std::shared_ptr<PhysicsBody>> nearbyBodies;
+void PhysicsSystem::updateSleeping(float deltaTime) {
+    if (!sleepingEnabled) return;
+    
+    const size_t slotCount = bodies.getSlotCapacity();
+    islandParent.resize(slotCount);
+    islandCanSleep.resize(slotCount);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        uint32_t slot = bodies.slotAt(i);
+        islandParent[slot] = slot;
+        islandCanSleep[slot] = 1;
+    }
+    
+    // Dynamic bodies in contact form islands. Static and kinematic bodies
+    // stay out, or a shared floor would link every island together.
+    for (const ContactManager::Contact& contact : contactManager.getActiveContacts()) {
+        const PhysicsBody& a = *contact.first;
+        const PhysicsBody& b = *contact.second;
+        if (a.bodyType != BodyType::DYNAMIC || b.bodyType != BodyType::DYNAMIC) continue;
+        
+        uint32_t rootA = findIsland(a.handle.index);
+        uint32_t rootB = findIsland(b.handle.index);
+        if (rootA != rootB) islandParent[rootB] = rootA;
+    }
     
-    for (const auto& body : bodies) {
-        if (!body->isActive) continue;
+    // Advance sleep timers; a single restless body keeps its island awake
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        PhysicsBody& body = bodies[i];
+        if (!body.isActive || body.bodyType != BodyType::DYNAMIC || body.isSleeping) continue;
         
-        double distance = center.distanceTo(body->position);
-        if (distance <= radius) {
-            nearbyBodies.push_back(body);
+        bool resting = body.velocity.length() < VELOCITY_THRESHOLD && body.force == Position(0, 0, 0);
+        body.sleepTimer = resting ? body.sleepTimer + deltaTime : 0.0f;
+        if (body.sleepTimer < SLEEP_DELAY) {
+            islandCanSleep[findIsland(bodies.slotAt(i))] = 0;
         }
     }
     
+    // Islands sleep and wake as a whole
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        PhysicsBody& body = bodies[i];
+        if (!body.isActive || body.bodyType != BodyType::DYNAMIC) continue;
+        
+        bool canSleep = islandCanSleep[findIsland(bodies.slotAt(i))] != 0;
+        if (canSleep && !body.isSleeping) {
+            body.isSleeping = true;
+            body.velocity = Position(0, 0, 0);
+            body.acceleration = Position(0, 0, 0);
+        } else if (!canSleep && body.isSleeping) {
+            wakeBody(body);
+        }
+        
+        if (body.isSleeping) lastStepStats.sleepingBodies++;
+    }
+}
+
+uint32_t PhysicsSystem::findIsland(uint32_t slot) {
+    // Path halving keeps the trees flat
+    while (islandParent[slot] != slot) {
+        islandParent[slot] = islandParent[islandParent[slot]];
+        slot = islandParent[slot];
+    }
+    return slot;
+}
+
+void PhysicsSystem::wakeBody(PhysicsBody& body) {
+    body.isSleeping = false;
+    body.sleepTimer = 0.0f;
+}
+
+void PhysicsSystem::wakeBody(BodyHandle handle) {
+    PhysicsBody* body = bodies.get(handle);
+    if (body) wakeBody(*body);
+}
+
+bool PhysicsSystem::isBodySleeping(BodyHandle handle) const {
+    const PhysicsBody* body = bodies.get(handle);
+    return body && body->isSleeping;
+}
+
+void PhysicsSystem::setSleepingEnabled(bool enabled) {
+    sleepingEnabled = enabled;
+    if (!enabled) {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            wakeBody(bodies[i]);
+        }
+    }
+}
+
+std::shared_ptr<PhysicsBody> PhysicsSystem::createBody(const Position& position, float mass) {
+    return makeBodyView(*bodies.get(spawnBody(position, mass)));
+}
+
+std::shared_ptr<PhysicsBody> PhysicsSystem::addBody(const std::shared_ptr<PhysicsBody>& body) {
+    if (!body) return nullptr;
+    if (bodies.get(body->handle) == body.get()) return body;  // Already pooled
+    
+    // Externally built bodies are copied into the pool
+    BodyHandle handle = bodies.insert(*body);
+    PhysicsBody& pooled = *bodies.get(handle);
+    pooled.handle = handle;
+    
+    if (pooled.isActive) {
+        addBodyToGrid(handle.index);
+    }
+    if (pooled.isFastMoving) {
+        pooled.isFastMoving = false;
+        setBodyFastMoving(handle, true);
+    }
+    if (broadphaseType == BroadphaseType::SORT_AND_SWEEP) {
+        sweepPending.push_back(handle.index);
+    }
+    return makeBodyView(pooled);
+}
+
+void PhysicsSystem::removeBody(const std::shared_ptr<PhysicsBody>& body) {
+    if (body && bodies.get(body->handle) == body.get()) {
+        destroyBody(body->handle);
+    }
+}
+
+std::shared_ptr<PhysicsBody> PhysicsSystem::makeBodyView(PhysicsBody& body) const {
+    // Aliasing constructor: shares one control block instead of allocating per body
+    return std::shared_ptr<PhysicsBody>(poolLifetime, &body);
+}
+
+bool PhysicsSystem::checkCollision(const PhysicsBody* body1, const PhysicsBody* body2) const {
+    return testShapes(body1->position, body1->shape, body2->position, body2->shape);
+}
+
+std::vector<std::shared_ptr<PhysicsBody>> PhysicsSystem::getBodiesInRadius(const Position& center, float radius) {
+    std::vector<std::shared_ptr<PhysicsBody>> nearbyBodies;
+    forEachBodyInRadius(center, radius, [this, &nearbyBodies](PhysicsBody& body) {
+        nearbyBodies.push_back(makeBodyView(body));
+    });
     return nearbyBodies;
 }
 
+size_t PhysicsSystem::queryBodiesInRadius(const Position& center, float radius, std::vector<BodyHandle>& results) {
+    results.clear();
+    forEachBodyInRadius(center, radius, [&results](PhysicsBody& body) {
+        results.push_back(body.handle);
+    });
+    return results.size();
+}
+
+size_t PhysicsSystem::queryBodiesInAABB(const Position& min, const Position& max, std::vector<BodyHandle>& results) {
+    results.clear();
+    forEachBodyInAABB(min, max, [&results](PhysicsBody& body) {
+        results.push_back(body.handle);
+    });
+    return results.size();
+}
+
+bool PhysicsSystem::raycast(const Ray& ray, RayHit& hit) {
+    refreshQueryGrid();
+    castRay(ray, hit);
+    return hit.hit;
+}
+
+void PhysicsSystem::raycastBatch(const std::vector<Ray>& rays, std::vector<RayHit>& hits) {
+    // One grid refresh and one set of scratch buffers for the whole batch
+    refreshQueryGrid();
+    hits.resize(rays.size());
+    for (size_t i = 0; i < rays.size(); ++i) {
+        castRay(rays[i], hits[i]);
+    }
+}
+
 bool PhysicsSystem::raycast(const Position& start, const Position& direction, float maxDistance, 
                            std::shared_ptr<PhysicsBody>& hitBody, Position& hitPoint) {
-    // Simple raycast implementation
-    Position end = start + direction.normalize() * maxDistance;
+    RayHit hit;
+    if (!raycast(Ray(start, direction, maxDistance), hit)) return false;
     
-    for (const auto& body : bodies) {
-        if (!body->isActive) continue;
-        
-        // Check if ray intersects with body's collider
-        if (body->collider) {
-            Position center = body->collider->getCenter();
-            float radius = body->collider->getRadius();
-            
-            // Simple sphere-ray intersection
-            Position toCenter = center - start;
-            double projection = toCenter.dot(direction);
-            
-            if (projection < 0) continue; // Ray points away from sphere
-            
-            double closestApproach = toCenter.dot(toCenter) - projection * projection;
-            double radiusSquared = radius * radius;
+    hitBody = makeBodyView(*bodies.get(hit.body));
+    hitPoint = hit.point;
+    return true;
+}
+
+bool PhysicsSystem::lineOfSight(const Position& start, const Position& end) {
+    Position direction = end - start;
+    float distance = direction.length();
+    
+    RayHit hit;
+    return !raycast(Ray(start, direction, distance), hit);
+}
+
+void PhysicsSystem::refreshQueryGrid() {
+    // Queries between steps see the positions left by the solver; the first
+    // query after a step pays for the refresh, the rest reuse it
+    if (queryGridStale) {
+        updateSpatialGrid();
+    }
+}
+
+void PhysicsSystem::castRay(const Ray& ray, RayHit& hit) {
+    hit = RayHit();
+    double length = ray.direction.length();
+    if (length == 0.0 || !(ray.maxDistance > 0.0f)) return;
+    
+    const Position& origin = ray.origin;
+    Position direction = ray.direction * (1.0 / length);
+    double maxDistance = ray.maxDistance;
+    
+    if (rayStamps.size() < bodies.getSlotCapacity()) {
+        rayStamps.resize(bodies.getSlotCapacity(), 0);
+    }
+    if (++rayStamp == 0) {
+        std::fill(rayStamps.begin(), rayStamps.end(), 0);
+        rayStamp = 1;
+    }
+    rayCandidates.clear();
+    
+    // A ray crossing more cells than there are bodies is cheaper to test against every body
+    double cellSize = spatialHash.getCellSize();
+    if (!std::isfinite(maxDistance) || maxDistance / cellSize > static_cast<double>(bodies.size())) {
+        castRayThroughAll(origin, direction, maxDistance, hit);
+    } else {
+        // 3D DDA: step into whichever neighbouring cell the ray reaches first
+        int cell[3];
+        int step[3];
+        double nextBoundary[3];  // Ray distance to the next cell boundary per axis
+        double boundaryStep[3];  // Ray distance between boundaries per axis
+        for (int axis = 0; axis < 3; ++axis) {
+            double start = axisComponent(origin, axis);
+            double heading = axisComponent(direction, axis);
+            cell[axis] = spatialHash.getCellCoordinate(start);
             
-            if (closestApproach > radiusSquared) continue; // Ray misses sphere
+            if (heading > 0.0) {
+                step[axis] = 1;
+                nextBoundary[axis] = ((cell[axis] + 1) * cellSize - start) / heading;
+                boundaryStep[axis] = cellSize / heading;
+            } else if (heading < 0.0) {
+                step[axis] = -1;
+                nextBoundary[axis] = (cell[axis] * cellSize - start) / heading;
+                boundaryStep[axis] = -cellSize / heading;
+            } else {
+                step[axis] = 0;
+                nextBoundary[axis] = std::numeric_limits<double>::infinity();
+                boundaryStep[axis] = std::numeric_limits<double>::infinity();
+            }
+        }
+        
+        while (true) {
+            int axis = 0;
+            if (nextBoundary[1] < nextBoundary[axis]) axis = 1;
+            if (nextBoundary[2] < nextBoundary[axis]) axis = 2;
+            double cellExit = nextBoundary[axis];
             
-            double halfChord = sqrt(radiusSquared - closestApproach);
-            double distance = projection - halfChord;
+            const SpatialHash::Cell* visited = spatialHash.findCell(cell[0], cell[1], cell[2]);
+            if (visited) {
+                for (uint32_t slot : visited->ids) {
+                    gatherRayCandidate(slot, origin, direction, maxDistance, hit);
+                }
+            }
             
-            if (distance > 0 && distance <= maxDistance) {
-                hitBody = body;
-                hitPoint = start + direction.normalize() * distance;
-                return true;
+            // Spheres wait for a full batch unless the ray may end in this cell.
+            // Bodies in later cells cannot be entered before cellExit.
+            bool lastCell = cellExit >= maxDistance;
+            bool mayStop = hit.hit && hit.distance <= cellExit;
+            if (lastCell || mayStop || rayCandidates.size() >= RAY_BATCH_SIZE) {
+                flushRayCandidates(direction, maxDistance, hit);
             }
+            if (lastCell || (hit.hit && hit.distance <= cellExit)) break;
+            
+            cell[axis] += step[axis];
+            nextBoundary[axis] += boundaryStep[axis];
         }
     }
     
-    return false;
+    if (hit.hit) {
+        hit.point = origin + direction * hit.distance;
+    }
 }
 
-bool PhysicsSystem::lineOfSight(const Position& start, const Position& end) {
-    std::shared_ptr<PhysicsBody> hitBody;
-    Position hitPoint;
+void PhysicsSystem::castRayThroughAll(const Position& origin, const Position& direction, double maxDistance, RayHit& hit) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        gatherRayCandidate(bodies.slotAt(i), origin, direction, maxDistance, hit);
+    }
+    flushRayCandidates(direction, maxDistance, hit);
+}
+
+void PhysicsSystem::gatherRayCandidate(uint32_t slot, const Position& origin, const Position& direction,
+                                       double maxDistance, RayHit& hit) {
+    if (rayStamps[slot] == rayStamp) return;
+    rayStamps[slot] = rayStamp;
     
-    Position direction = end - start;
-    float distance = direction.length();
+    const PhysicsBody& body = bodies.atSlot(slot);
+    if (!body.isActive) return;
     
-    return !raycast(start, direction, distance, hitBody, hitPoint);
+    Position offset = body.position - origin;
+    if (body.shape.type == ShapeType::SPHERE) {
+        rayCandidates.add(slot, static_cast<float>(offset.getX()), static_cast<float>(offset.getY()),
+                          static_cast<float>(offset.getZ()), body.shape.radius);
+    } else if (body.shape.type == ShapeType::AABB) {
+        // Boxes are rare enough to test right away
+        double limit = hit.hit ? hit.distance : maxDistance;
+        const Position& half = body.shape.halfExtents;
+        double distance = intersectRayBox(offset.getX(), offset.getY(), offset.getZ(),
+                                          half.getX(), half.getY(), half.getZ(),
+                                          direction.getX(), direction.getY(), direction.getZ(), limit);
+        if (distance >= 0.0 && (!hit.hit || distance < hit.distance)) {
+            hit.hit = true;
+            hit.body = body.handle;
+            hit.distance = static_cast<float>(distance);
+        }
+    }
 }
 
-void PhysicsSystem::updateSpatialGrid() {
-    // Clear grid
-    for (auto& xLayer : spatialGrid) {
-        for (auto& yLayer : xLayer) {
-            for (auto& zLayer : yLayer) {
-                zLayer.bodies.clear();
-            }
-        }
+void PhysicsSystem::flushRayCandidates(const Position& direction, double maxDistance, RayHit& hit) {
+    if (rayCandidates.size() == 0) return;
+    
+    float distance = 0.0f;
+    float limit = hit.hit ? hit.distance : static_cast<float>(maxDistance);
+    int nearest = findNearestSphereHit(rayCandidates, static_cast<float>(direction.getX()),
+                                       static_cast<float>(direction.getY()), static_cast<float>(direction.getZ()),
+                                       limit, distance);
+    if (nearest >= 0) {
+        hit.hit = true;
+        hit.body = bodies.atSlot(rayCandidates.slots[nearest]).handle;
+        hit.distance = distance;
     }
+    rayCandidates.clear();
+}
+
+void PhysicsSystem::updateSpatialGrid() {
+    queryGridStale = false;
     
-    // Re-add all bodies to grid
-    for (const auto& body : bodies) {
-        if (body->isActive) {
-            addBodyToGrid(body);
+    // Bodies that stay inside their cells cost a range comparison and nothing more,
+    // and sleeping bodies that are already registered not even that
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        uint32_t slot = bodies.slotAt(i);
+        if (bodies[i].isActive) {
+            if (bodies[i].isSleeping && spatialHash.contains(slot)) continue;
+            addBodyToGrid(slot);
+        } else {
+            spatialHash.remove(slot);
         }
     }
 }
 
 void PhysicsSystem::setGridParameters(float cellSize, const Position& bounds) {
-    this->cellSize = cellSize;
-    this->gridBounds = bounds;
-    
-    // Reinitialize grid with new parameters
-    int gridX = static_cast<int>(gridBounds.getX() / cellSize) + 1;
-    int gridY = static_cast<int>(gridBounds.getY() / cellSize) + 1;
-    int gridZ = static_cast<int>(gridBounds.getZ() / cellSize) + 1;
-    
-    spatialGrid.clear();
-    spatialGrid.resize(gridX);
-    for (auto& xLayer : spatialGrid) {
-        xLayer.resize(gridY);
-        for (auto& yLayer : xLayer) {
-            yLayer.resize(gridZ);
-        }
-    }
+    (void)bounds;  // The hashed grid covers any position
+    spatialHash.setCellSize(cellSize);
+    updateSpatialGrid();
 }
 
-void PhysicsSystem::integrateVelocity(std::shared_ptr<PhysicsBody> body, float deltaTime) {
+void PhysicsSystem::integrateVelocity(PhysicsBody& body, float deltaTime) {
     // Apply velocity to position
-    body->position = body->position + body->velocity * deltaTime;
+    body.position = body.position + body.velocity * deltaTime;
     
     // Apply damping
-    body->velocity = body->velocity * (1.0f - body->linearDamping * deltaTime);
+    body.velocity = body.velocity * (1.0f - body.linearDamping * deltaTime);
 }
 
-void PhysicsSystem::applyForces(std::shared_ptr<PhysicsBody> body, float deltaTime) {
+void PhysicsSystem::applyForces(PhysicsBody& body, float deltaTime) {
     // Apply gravity
-    body->force.setZ(body->force.getZ() + GRAVITY * body->mass);
+    body.force.setZ(body.force.getZ() + GRAVITY * body.mass);
     
     // Calculate acceleration
-    body->acceleration = body->force * body->invMass;
+    body.acceleration = body.force * body.invMass;
     
     // Apply acceleration to velocity
-    body->velocity = body->velocity + body->acceleration * deltaTime;
+    body.velocity = body.velocity + body.acceleration * deltaTime;
     
     // Reset forces
-    body->force = Position(0, 0, 0);
+    body.force = Position(0, 0, 0);
 }
 
-void PhysicsSystem::clampVelocity(std::shared_ptr<PhysicsBody> body) {
-    float velocityMagnitude = body->velocity.length();
+void PhysicsSystem::clampVelocity(PhysicsBody& body) {
+    float velocityMagnitude = body.velocity.length();
     if (velocityMagnitude > MAX_VELOCITY) {
-        body->velocity = body->velocity.normalize() * MAX_VELOCITY;
+        body.velocity = body.velocity.normalize() * MAX_VELOCITY;
     }
     
     // Apply velocity threshold
     if (velocityMagnitude < VELOCITY_THRESHOLD) {
-        body->velocity = Position(0, 0, 0);
+        body.velocity = Position(0, 0, 0);
     }
 }
 
-void PhysicsSystem::updateBodyTransform(std::shared_ptr<PhysicsBody> body, float deltaTime) {
-    // Update collider position
-    if (body->collider) {
-        body->collider->updateTransform(body->position);
-    }
-}
-
-void PhysicsSystem::addBodyToGrid(std::shared_ptr<PhysicsBody> body) {
-    auto indices = getGridIndices(body->position, 1.0f);
+void PhysicsSystem::addBodyToGrid(uint32_t slot) {
+    const PhysicsBody& body = bodies.atSlot(slot);
+    float radius = body.shape.getBoundingRadius();
+    Position extent(radius, radius, radius);
     
-    for (const auto& index : indices) {
-        int x = std::get<0>(index);
-        int y = std::get<1>(index);
-        int z = std::get<2>(index);
-        if (x >= 0 && x < static_cast<int>(spatialGrid.size()) &&
-            y >= 0 && y < static_cast<int>(spatialGrid[0].size()) &&
-            z >= 0 && z < static_cast<int>(spatialGrid[0][0].size())) {
-            spatialGrid[x][y][z].bodies.push_back(body);
-        }
-    }
-}
-
-void PhysicsSystem::removeBodyFromGrid(std::shared_ptr<PhysicsBody> body) {
-    auto indices = getGridIndices(body->position, 1.0f);
-    
-    for (const auto& index : indices) {
-        int x = std::get<0>(index);
-        int y = std::get<1>(index);
-        int z = std::get<2>(index);
-        if (x >= 0 && x < static_cast<int>(spatialGrid.size()) &&
-            y >= 0 && y < static_cast<int>(spatialGrid[0].size()) &&
-            z >= 0 && z < static_cast<int>(spatialGrid[0][0].size())) {
-            auto& cell = spatialGrid[x][y][z];
-            cell.bodies.erase(std::remove(cell.bodies.begin(), cell.bodies.end(), body), cell.bodies.end());
-        }
-    }
-}
-
-std::vector<std::tuple<int, int, int>> PhysicsSystem::getGridIndices(const Position& position, float radius) {
-    std::vector<std::tuple<int, int, int>> indices;
-    
-    int minX = static_cast<int>((position.getX() - radius) / cellSize);
-    int maxX = static_cast<int>((position.getX() + radius) / cellSize);
-    int minY = static_cast<int>((position.getY() - radius) / cellSize);
-    int maxY = static_cast<int>((position.getY() + radius) / cellSize);
-    int minZ = static_cast<int>((position.getZ() - radius) / cellSize);
-    int maxZ = static_cast<int>((position.getZ() + radius) / cellSize);
-    
-    for (int x = minX; x <= maxX; ++x) {
-        for (int y = minY; y <= maxY; ++y) {
-            for (int z = minZ; z <= maxZ; ++z) {
-                indices.emplace_back(x, y, z);
-            }
-        }
-    }
-    
-    return indices;
+    spatialHash.update(slot, body.position - extent, body.position + extent);
 }
 
 // Additional utility methods implementation
 std::vector<std::shared_ptr<PhysicsBody>> PhysicsSystem::getBodiesInAABB(const Position& min, const Position& max) {
     std::vector<std::shared_ptr<PhysicsBody>> bodiesInAABB;
-    
-    for (const auto& body : bodies) {
-        if (!body->isActive) continue;
-        
-        Position bodyPos = body->position;
-        if (bodyPos.getX() >= min.getX() && bodyPos.getX() <= max.getX() &&
-            bodyPos.getY() >= min.getY() && bodyPos.getY() <= max.getY() &&
-            bodyPos.getZ() >= min.getZ() && bodyPos.getZ() <= max.getZ()) {
-            bodiesInAABB.push_back(body);
-        }
-    }
-    
+    forEachBodyInAABB(min, max, [this, &bodiesInAABB](PhysicsBody& body) {
+        bodiesInAABB.push_back(makeBodyView(body));
+    });
     return bodiesInAABB;
 }
 
 std::vector<std::shared_ptr<PhysicsBody>> PhysicsSystem::getBodiesAtPosition(const Position& position, float tolerance) {
-    std::vector<std::shared_ptr<PhysicsBody>> bodiesAtPosition;
-    
-    for (const auto& body : bodies) {
-        if (!body->isActive) continue;
-        
-        double distance = position.distanceTo(body->position);
-        if (distance <= tolerance) {
-            bodiesAtPosition.push_back(body);
-        }
-    }
-    
-    return bodiesAtPosition;
+    return getBodiesInRadius(position, tolerance);
 }
 
 bool PhysicsSystem::isPositionOccupied(const Position& position, float radius) {
-    for (const auto& body : bodies) {
-        if (!body->isActive) continue;
-        
-        double distance = position.distanceTo(body->position);
-        if (distance < radius) {
-            return true;
-        }
-    }
-    return false;
+    // Strictly inside, as before
+    double radiusSquared = static_cast<double>(radius) * radius;
+    bool occupied = false;
+    forEachBodyInRadius(position, radius, [&](PhysicsBody& body) {
+        Position offset = body.position - position;
+        if (offset.dot(offset) < radiusSquared) occupied = true;
+    });
+    return occupied;
 }
 
-void PhysicsSystem::applyImpulse(std::shared_ptr<PhysicsBody> body, const Position& impulse) {
+void PhysicsSystem::applyImpulse(BodyHandle handle, const Position& impulse) {
+    PhysicsBody* body = bodies.get(handle);
     if (!body || body->bodyType == BodyType::STATIC) return;
     
     // Apply impulse to velocity: v = v + impulse / mass
     body->velocity = body->velocity + impulse * body->invMass;
+    wakeBody(*body);
+}
+
+void PhysicsSystem::setBodyShape(BodyHandle handle, const ColliderShape& shape) {
+    PhysicsBody* body = bodies.get(handle);
+    if (body) {
+        body->shape = shape;
+    }
 }
 
-void PhysicsSystem::setBodyCollider(std::shared_ptr<PhysicsBody> body, std::shared_ptr<Collider> collider) {
-    if (body && collider) {
-        body->collider = collider;
-        collider->updateTransform(body->position);
+void PhysicsSystem::setBodyCollider(BodyHandle handle, std::shared_ptr<Collider> collider) {
+    // The collider only describes the shape; the body keeps its own position
+    if (collider) {
+        setBodyShape(handle, collider->getShape());
     }
 }
 
-void PhysicsSystem::setBodyType(std::shared_ptr<PhysicsBody> body, BodyType type) {
+void PhysicsSystem::setBodyType(BodyHandle handle, BodyType type) {
+    PhysicsBody* body = bodies.get(handle);
     if (body) {
         body->bodyType = type;
         if (type == BodyType::STATIC) {
@@ -400,7 +969,26 @@ void PhysicsSystem::setBodyType(std::shared_ptr<PhysicsBody> body, BodyType type
     }
 }
 
-void PhysicsSystem::setBodyMass(std::shared_ptr<PhysicsBody> body, float mass) {
+void PhysicsSystem::setBodyFastMoving(BodyHandle handle, bool fastMoving) {
+    PhysicsBody* body = bodies.get(handle);
+    if (!body || body->isFastMoving == fastMoving) return;
+    
+    body->isFastMoving = fastMoving;
+    if (fastMoving) {
+        fastBodies.push_back(handle.index);
+        fastBodyStarts.push_back(body->position);
+        return;
+    }
+    
+    // Few bodies are flagged, so a linear search is fine
+    auto found = std::find(fastBodies.begin(), fastBodies.end(), handle.index);
+    size_t index = found - fastBodies.begin();
+    fastBodies.erase(found);
+    fastBodyStarts.erase(fastBodyStarts.begin() + index);
+}
+
+void PhysicsSystem::setBodyMass(BodyHandle handle, float mass) {
+    PhysicsBody* body = bodies.get(handle);
     if (body && mass > 0) {
         body->mass = mass;
         body->invMass = 1.0f / mass;
@@ -410,33 +998,23 @@ void PhysicsSystem::setBodyMass(std::shared_ptr<PhysicsBody> body, float mass) {
     }
 }
 
-// Collider implementations
-bool SphereCollider::checkCollision(const Collider* other) const {
-    if (const SphereCollider* sphere = dynamic_cast<const SphereCollider*>(other)) {
-        double distance = center.distanceTo(sphere->center);
-        return distance < (radius + sphere->radius);
-    }
-    else if (const AABBCollider* aabb = dynamic_cast<const AABBCollider*>(other)) {
-        // Sphere-AABB collision detection
-        Position aabbCenter = aabb->getCenter();
-        Position aabbHalfSize = (aabb->getMax() - aabb->getMin()) * 0.5;
-        
-        // Find closest point on AABB to sphere center
-        Position closestPoint;
-        closestPoint.setX(std::max(aabbCenter.getX() - aabbHalfSize.getX(), 
-                                  std::min(center.getX(), aabbCenter.getX() + aabbHalfSize.getX())));
-        closestPoint.setY(std::max(aabbCenter.getY() - aabbHalfSize.getY(), 
-                                  std::min(center.getY(), aabbCenter.getY() + aabbHalfSize.getY())));
-        closestPoint.setZ(std::max(aabbCenter.getZ() - aabbHalfSize.getZ(), 
-                                  std::min(center.getZ(), aabbCenter.getZ() + aabbHalfSize.getZ())));
-        
-        // Check if closest point is inside sphere
-        double distance = center.distanceTo(closestPoint);
-        return distance < radius;
-    }
-    return false;
+void PhysicsSystem::applyImpulse(const std::shared_ptr<PhysicsBody>& body, const Position& impulse) {
+    if (body) applyImpulse(body->handle, impulse);
+}
+
+void PhysicsSystem::setBodyCollider(const std::shared_ptr<PhysicsBody>& body, std::shared_ptr<Collider> collider) {
+    if (body) setBodyCollider(body->handle, collider);
+}
+
+void PhysicsSystem::setBodyType(const std::shared_ptr<PhysicsBody>& body, BodyType type) {
+    if (body) setBodyType(body->handle, type);
 }
 
+void PhysicsSystem::setBodyMass(const std::shared_ptr<PhysicsBody>& body, float mass) {
+    if (body) setBodyMass(body->handle, mass);
+}
+
+// Collider implementations
 Position AABBCollider::getCenter() const {
     return Position((min.getX() + max.getX()) * 0.5,
                    (min.getY() + max.getY()) * 0.5,
@@ -454,30 +1032,3 @@ void AABBCollider::updateTransform(const Position& position) {
     min = min + offset;
     max = max + offset;
 }
-
-bool AABBCollider::checkCollision(const Collider* other) const {
-    if (const AABBCollider* aabb = dynamic_cast<const AABBCollider*>(other)) {
-        return !(max.getX() < aabb->min.getX() || min.getX() > aabb->max.getX() ||
-                 max.getY() < aabb->min.getY() || min.getY() > aabb->max.getY() ||
-                 max.getZ() < aabb->min.getZ() || min.getZ() > aabb->max.getZ());
-    }
-    else if (const SphereCollider* sphere = dynamic_cast<const SphereCollider*>(other)) {
-        // AABB-Sphere collision detection (same as Sphere-AABB)
-        Position aabbCenter = getCenter();
-        Position aabbHalfSize = (max - min) * 0.5;
-        
-        // Find closest point on AABB to sphere center
-        Position closestPoint;
-        closestPoint.setX(std::max(aabbCenter.getX() - aabbHalfSize.getX(), 
-                                  std::min(sphere->getCenter().getX(), aabbCenter.getX() + aabbHalfSize.getX())));
-        closestPoint.setY(std::max(aabbCenter.getY() - aabbHalfSize.getY(), 
-                                  std::min(sphere->getCenter().getY(), aabbCenter.getY() + aabbHalfSize.getY())));
-        closestPoint.setZ(std::max(aabbCenter.getZ() - aabbHalfSize.getZ(), 
-                                  std::min(sphere->getCenter().getZ(), aabbCenter.getZ() + aabbHalfSize.getZ())));
-        
-        // Check if closest point is inside sphere
-        double distance = sphere->getCenter().distanceTo(closestPoint);
-        return distance < sphere->getRadius();
-    }
-    return false;
-}
@@ -2,14 +2,27 @@
 #define PHYSICS_SYSTEM_H
 
 #include "position.h"
+#include "spatial_hash.h"
+#include "slot_map.h"
+#include "collider_shape.h"
+#include "contact_manager.h"
+#include "contact_solver.h"
+#include "ray_kernel.h"
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <limits>
 
 // Forward declarations
 class Character;
 class Mob;
 class Collider;
+class JobPool;
+struct PhysicsBody;
+
+// Generational handle to a pooled body
+using BodyHandle = Handle<PhysicsBody>;
 
 // Physics body types
 enum class BodyType {
@@ -18,6 +31,12 @@ enum class BodyType {
     KINEMATIC   // Script-controlled objects (doors, platforms)
 };
 
+// Broadphase algorithm used to find candidate pairs
+enum class BroadphaseType {
+    UNIFORM_GRID,   // Sparse hashed cells, suits evenly sized bodies
+    SORT_AND_SWEEP  // Sorted intervals along the dominant axis, suits mixed sizes and unbounded worlds
+};
+
 // Physics material properties
 struct PhysicsMaterial {
     float friction;
@@ -43,28 +62,100 @@ struct PhysicsBody {
     PhysicsMaterial material;
     
     // Collision detection
-    std::shared_ptr<Collider> collider;
+    ColliderShape shape;  // Stored inline, centered on position
     bool isTrigger;
     bool isActive;
     
+    // Sleeping bodies skip integration and pair tests until woken
+    bool isSleeping;
+    float sleepTimer;  // Seconds spent below the velocity threshold
+    
+    // Swept against other bodies every step so it cannot pass through them.
+    // Set through PhysicsSystem::setBodyFastMoving().
+    bool isFastMoving;
+    
     // Callbacks
     std::function<void(PhysicsBody*)> onCollisionEnter;
     std::function<void(PhysicsBody*)> onCollisionStay;
     std::function<void(PhysicsBody*)> onCollisionExit;
     
+    // Set by PhysicsSystem when the body enters the pool
+    BodyHandle handle;
+    
     PhysicsBody() : position(0, 0, 0), velocity(0, 0, 0), acceleration(0, 0, 0),
                     force(0, 0, 0), mass(1.0f), invMass(1.0f), linearDamping(0.01f),
-                    bodyType(BodyType::DYNAMIC), material(), isTrigger(false), isActive(true) {}
+                    bodyType(BodyType::DYNAMIC), material(), isTrigger(false), isActive(true),
+                    isSleeping(false), sleepTimer(0.0f), isFastMoving(false) {}
 };
 
-// Collision detection interface
+// A pair where neither body can move this step, because both sleep or one
+// sleeps against a static body. Such pairs keep their contact state untested.
+inline bool isRestingPair(const PhysicsBody& a, const PhysicsBody& b) {
+    return (a.isSleeping || b.isSleeping) &&
+           (a.isSleeping || a.bodyType == BodyType::STATIC) &&
+           (b.isSleeping || b.bodyType == BodyType::STATIC);
+}
+
+// Candidate pair produced by the broadphase
+struct BodyPair {
+    PhysicsBody* first;
+    PhysicsBody* second;
+    
+    BodyPair(PhysicsBody* a = nullptr, PhysicsBody* b = nullptr) : first(a), second(b) {}
+};
+
+// Ray for batched queries; the direction need not be normalized. Rays
+// without a distance are unbounded.
+struct Ray {
+    Position origin;
+    Position direction;
+    float maxDistance;
+    
+    Ray(const Position& o = Position(), const Position& d = Position(1, 0, 0),
+        float distance = std::numeric_limits<float>::infinity())
+        : origin(o), direction(d), maxDistance(distance) {}
+};
+
+// Nearest body a ray entered, if any
+struct RayHit {
+    bool hit;
+    BodyHandle body;
+    Position point;
+    float distance;
+    
+    RayHit() : hit(false), body(), point(), distance(0.0f) {}
+};
+
+// Collision statistics for the most recent step
+struct PhysicsStepStats {
+    size_t candidatePairs;    // Pairs emitted by the broadphase
+    size_t narrowphaseTests;  // Collider tests performed
+    size_t contacts;          // Pairs found overlapping
+    size_t contactsEntered;   // Pairs that started touching this step
+    size_t contactsExited;    // Pairs that stopped touching this step
+    size_t sleepingBodies;    // Bodies asleep at the end of the step
+    size_t solvedContacts;    // Contacts the solver had to work on
+    double maxPenetration;    // Deepest overlap the solver found before correcting it
+    size_t sweptBodies;       // Fast bodies that moved far enough to be swept
+    size_t sweepHits;         // Swept bodies stopped at a time of impact
+    
+    PhysicsStepStats() : candidatePairs(0), narrowphaseTests(0), contacts(0), contactsEntered(0), contactsExited(0),
+                         sleepingBodies(0), solvedContacts(0), maxPenetration(0.0), sweptBodies(0), sweepHits(0) {}
+};
+
+// Collider builders. Bodies store the ColliderShape these produce; the
+// classes remain for setBodyCollider() and standalone shape tests.
 class Collider {
 public:
     virtual ~Collider() = default;
-    virtual bool checkCollision(const Collider* other) const = 0;
+    virtual ColliderShape getShape() const = 0;
     virtual Position getCenter() const = 0;
     virtual float getRadius() const = 0;
     virtual void updateTransform(const Position& position) = 0;
+    
+    bool checkCollision(const Collider* other) const {
+        return testShapes(getCenter(), getShape(), other->getCenter(), other->getShape());
+    }
 };
 
 // Sphere collider
@@ -77,7 +168,7 @@ public:
     SphereCollider(const Position& pos = Position(0, 0, 0), float r = 1.0f)
         : center(pos), radius(r) {}
     
-    bool checkCollision(const Collider* other) const override;
+    ColliderShape getShape() const override { return ColliderShape::sphere(radius); }
     Position getCenter() const override { return center; }
     float getRadius() const override { return radius; }
     void updateTransform(const Position& position) override { center = position; }
@@ -96,7 +187,7 @@ public:
                   const Position& maxPos = Position(1, 1, 1))
         : min(minPos), max(maxPos) {}
     
-    bool checkCollision(const Collider* other) const override;
+    ColliderShape getShape() const override { return ColliderShape::box((max - min) * 0.5); }
     Position getCenter() const override;
     float getRadius() const override;
     void updateTransform(const Position& position) override;
@@ -109,76 +200,269 @@ public:
 // Physics system main class
 class PhysicsSystem {
 private:
-    std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    // Pooled body storage; the broadphase keys its tables by slot index
+    SlotMap<PhysicsBody> bodies;
+    std::shared_ptr<int> poolLifetime;  // Control block shared by legacy shared_ptr views
     
     // Physics constants
     float GRAVITY = -9.81f;
     float MAX_VELOCITY = 50.0f;
     const float VELOCITY_THRESHOLD = 0.01f;
+    const float SLEEP_DELAY = 0.5f;  // Seconds an island must rest before it sleeps
+    bool sleepingEnabled = true;
+    
+    BroadphaseType broadphaseType;
+    
+    // Optional worker pool; without one every phase runs on the calling thread
+    JobPool* jobPool;
+    std::vector<std::vector<BodyPair>> pairChunks;  // Per-range output of parallel pair phases
+    
+    // Spatial partitioning for collision detection, keyed by body slot
+    SpatialHash spatialHash;
     
-    // Spatial partitioning for collision detection
-    struct SpatialCell {
-        std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    // Sort-and-sweep state, kept between steps so the sort stays nearly linear
+    struct SweepBounds {
+        double min[3];
+        double max[3];
     };
     
-    std::vector<std::vector<std::vector<SpatialCell>>> spatialGrid;
-    float cellSize;
-    Position gridBounds;
+    std::vector<uint32_t> sweepOrder;       // Body slots ordered by min on sweepAxis
+    std::vector<SweepBounds> sweepBounds;   // Indexed by body slot
+    std::vector<uint8_t> sweepListed;       // Whether a slot is already in sweepOrder
+    std::vector<uint32_t> sweepPending;     // Slots spawned since the last sweep
+    bool sweepNeedsPrune;                   // Set when a body is destroyed
+    
+    // Active bounds packed in sweep order, sweep axis first
+    struct SweepEntry {
+        double minSweep, maxSweep;
+        double minB, maxB;
+        double minC, maxC;
+    };
+    
+    std::vector<SweepEntry> sweepSorted;
+    std::vector<uint32_t> sweepSortedSlot;  // Body slot of each packed entry
+    int sweepAxis;                          // -1 forces a full sort
+    
+    // Broadphase output, rebuilt once per step
+    std::vector<BodyPair> candidatePairs;
+    std::vector<std::vector<BodyPair>> shapePairBatches;  // Candidates bucketed by shape pair
+    std::vector<BodyPair> contactPairs;
+    ContactManager contactManager;  // Persists across steps for Enter/Stay/Exit
+    bool runningCallbacks;                // Collision callbacks are on the stack
+    std::vector<BodyHandle> deferredDestroys;  // Destroyed from a callback, freed once it returns
+    ContactSolver contactSolver;
+    PhysicsStepStats lastStepStats;
+    
+    // Island grouping scratch, indexed by body slot
+    std::vector<uint32_t> islandParent;
+    std::vector<uint8_t> islandCanSleep;
+    
+    // Continuous collision: slots of fast-moving bodies and where each began the step
+    std::vector<uint32_t> fastBodies;
+    std::vector<Position> fastBodyStarts;
+    
+    // Ray query scratch. Bodies seen in an earlier cell of the same ray carry
+    // its stamp, so large bodies spanning several cells are tested once.
+    RaySphereCandidates rayCandidates;
+    std::vector<uint32_t> rayStamps;  // Indexed by body slot
+    uint32_t rayStamp;
+    bool queryGridStale;  // Bodies moved since the grid was last refreshed
     
 public:
-    PhysicsSystem();
+    explicit PhysicsSystem(BroadphaseType broadphase = BroadphaseType::UNIFORM_GRID);
     ~PhysicsSystem();
     
     // Core physics loop
     void update(float deltaTime);
     void simulatePhysics(float deltaTime);
+    void buildCandidatePairs();
     void detectCollisions();
     void resolveCollisions();
+    void updateSleeping(float deltaTime);
+    void sweepFastBodies();
     
-    // Body management
-    std::shared_ptr<PhysicsBody> createBody(const Position& position, float mass = 1.0f);
-    void addBody(std::shared_ptr<PhysicsBody> body);
-    void removeBody(std::shared_ptr<PhysicsBody> body);
+    // Body management. A body destroyed from inside a collision callback
+    // stays valid until the step's callbacks have all run.
+    BodyHandle spawnBody(const Position& position, float mass = 1.0f);
+    void destroyBody(BodyHandle handle);
+    PhysicsBody* getBody(BodyHandle handle) { return bodies.get(handle); }
+    bool isBodyValid(BodyHandle handle) const { return bodies.contains(handle); }
     void clearAllBodies();
     
+    // Compatibility shim for shared_ptr callers. The returned pointers are
+    // views into the pool: they do not keep a body alive and must not be
+    // used after removeBody() or after the PhysicsSystem is destroyed.
+    std::shared_ptr<PhysicsBody> createBody(const Position& position, float mass = 1.0f);
+    std::shared_ptr<PhysicsBody> addBody(const std::shared_ptr<PhysicsBody>& body);
+    void removeBody(const std::shared_ptr<PhysicsBody>& body);
+    
     // Collision detection
     bool checkCollision(const PhysicsBody* body1, const PhysicsBody* body2) const;
     std::vector<std::shared_ptr<PhysicsBody>> getBodiesInRadius(const Position& center, float radius);
     
-    // Physics queries
+    // Physics queries. Rays walk the spatial grid cell by cell and report the
+    // nearest body they enter; bodies containing the ray origin are ignored.
+    bool raycast(const Ray& ray, RayHit& hit);
+    void raycastBatch(const std::vector<Ray>& rays, std::vector<RayHit>& hits);
     bool raycast(const Position& start, const Position& direction, float maxDistance, 
                  std::shared_ptr<PhysicsBody>& hitBody, Position& hitPoint);
     bool lineOfSight(const Position& start, const Position& end);
     
-    // Spatial partitioning
+    // Allocation-free area queries through the spatial grid. A body matches
+    // when its position lies inside the area. The buffer variants clear the
+    // caller's vector and reuse its capacity; visitors get each PhysicsBody&
+    // and must not spawn or destroy bodies.
+    size_t queryBodiesInRadius(const Position& center, float radius, std::vector<BodyHandle>& results);
+    size_t queryBodiesInAABB(const Position& min, const Position& max, std::vector<BodyHandle>& results);
+    template <typename Visitor>
+    void forEachBodyInRadius(const Position& center, float radius, Visitor&& visitor);
+    template <typename Visitor>
+    void forEachBodyInAABB(const Position& min, const Position& max, Visitor&& visitor);
+    
+    // Spatial partitioning (the grid is unbounded; bounds are accepted for compatibility)
     void updateSpatialGrid();
-    void setGridParameters(float cellSize, const Position& bounds);
+    void setGridParameters(float cellSize, const Position& bounds = Position());
+    const SpatialHash& getSpatialHash() const { return spatialHash; }
     
     // Utility methods
     void setGravity(float gravity) { GRAVITY = gravity; }
     void setMaxVelocity(float maxVel) { MAX_VELOCITY = maxVel; }
     size_t getBodyCount() const { return bodies.size(); }
+    BroadphaseType getBroadphaseType() const { return broadphaseType; }
+    void setJobPool(JobPool* pool) { jobPool = pool; }  // Not owned; nullptr runs single-threaded
+    JobPool* getJobPool() const { return jobPool; }
+    const std::vector<BodyPair>& getCandidatePairs() const { return candidatePairs; }
+    const ContactManager& getContactManager() const { return contactManager; }
+    void setSolverIterations(int iterations) { contactSolver.setIterations(iterations); }
+    void setWarmStartingEnabled(bool enabled) { contactSolver.setWarmStarting(enabled); }
+    const ContactSolver& getContactSolver() const { return contactSolver; }
+    const PhysicsStepStats& getLastStepStats() const { return lastStepStats; }
     
     // Additional utility methods
     std::vector<std::shared_ptr<PhysicsBody>> getBodiesInAABB(const Position& min, const Position& max);
     std::vector<std::shared_ptr<PhysicsBody>> getBodiesAtPosition(const Position& position, float tolerance = 0.1f);
     bool isPositionOccupied(const Position& position, float radius = 1.0f);
-    void applyImpulse(std::shared_ptr<PhysicsBody> body, const Position& impulse);
-    void setBodyCollider(std::shared_ptr<PhysicsBody> body, std::shared_ptr<Collider> collider);
-    void setBodyType(std::shared_ptr<PhysicsBody> body, BodyType type);
-    void setBodyMass(std::shared_ptr<PhysicsBody> body, float mass);
+    void applyImpulse(BodyHandle handle, const Position& impulse);
+    void setBodyShape(BodyHandle handle, const ColliderShape& shape);
+    void setBodyCollider(BodyHandle handle, std::shared_ptr<Collider> collider);
+    void setBodyType(BodyHandle handle, BodyType type);
+    void setBodyMass(BodyHandle handle, float mass);
+    void setBodyFastMoving(BodyHandle handle, bool fastMoving);
+    
+    // Sleeping. Writing a body's velocity directly does not wake it; use
+    // applyImpulse() or wakeBody().
+    void wakeBody(BodyHandle handle);
+    bool isBodySleeping(BodyHandle handle) const;
+    void setSleepingEnabled(bool enabled);
+    void applyImpulse(const std::shared_ptr<PhysicsBody>& body, const Position& impulse);
+    void setBodyCollider(const std::shared_ptr<PhysicsBody>& body, std::shared_ptr<Collider> collider);
+    void setBodyType(const std::shared_ptr<PhysicsBody>& body, BodyType type);
+    void setBodyMass(const std::shared_ptr<PhysicsBody>& body, float mass);
     
 private:
     // Helper methods
-    void integrateVelocity(std::shared_ptr<PhysicsBody> body, float deltaTime);
-    void applyForces(std::shared_ptr<PhysicsBody> body, float deltaTime);
-    void clampVelocity(std::shared_ptr<PhysicsBody> body);
-    void updateBodyTransform(std::shared_ptr<PhysicsBody> body, float deltaTime);
+    void integrateVelocity(PhysicsBody& body, float deltaTime);
+    void applyForces(PhysicsBody& body, float deltaTime);
+    void clampVelocity(PhysicsBody& body);
+    std::shared_ptr<PhysicsBody> makeBodyView(PhysicsBody& body) const;
+    void integrateBodies(size_t begin, size_t end, float deltaTime);
+    void destroyDeferredBodies();
+    void wakeBody(PhysicsBody& body);
+    uint32_t findIsland(uint32_t slot);
     
     // Spatial partitioning helpers
-    void addBodyToGrid(std::shared_ptr<PhysicsBody> body);
-    void removeBodyFromGrid(std::shared_ptr<PhysicsBody> body);
-    std::vector<std::tuple<int, int, int>> getGridIndices(const Position& position, float radius);
+    void addBodyToGrid(uint32_t slot);
+    
+    // Ray query helpers
+    void refreshQueryGrid();
+    void castRay(const Ray& ray, RayHit& hit);
+    void castRayThroughAll(const Position& origin, const Position& direction, double maxDistance, RayHit& hit);
+    void gatherRayCandidate(uint32_t slot, const Position& origin, const Position& direction,
+                            double maxDistance, RayHit& hit);
+    void flushRayCandidates(const Position& direction, double maxDistance, RayHit& hit);
+    
+    // Area query helper, calls fn(PhysicsBody&) once per active body registered
+    // in the cells overlapping [min, max]
+    template <typename Fn>
+    void forEachQueryCandidate(const Position& min, const Position& max, Fn&& fn);
+    
+    // Parallel helpers
+    void runRanges(size_t count, size_t grainSize, const std::function<void(size_t, size_t, size_t)>& function);
+    void collectPairs(size_t count, size_t grainSize, std::vector<BodyPair>& output,
+                      const std::function<void(size_t, size_t, std::vector<BodyPair>&)>& emit);
+    
+    // Broadphase helpers
+    void buildGridPairs();
+    void buildSweepPairs();
+    void updateSweepOrder();
+    void emitCellPairs(const SpatialHash::Cell& cell, std::vector<BodyPair>& output);
+    void emitSweepPairs(size_t begin, size_t end, std::vector<BodyPair>& output);
 };
 
+template <typename Visitor>
+void PhysicsSystem::forEachBodyInRadius(const Position& center, float radius, Visitor&& visitor) {
+    Position extent(radius, radius, radius);
+    double radiusSquared = static_cast<double>(radius) * radius;
+    
+    forEachQueryCandidate(center - extent, center + extent, [&](PhysicsBody& body) {
+        double dx = body.position.getX() - center.getX();
+        double dy = body.position.getY() - center.getY();
+        double dz = body.position.getZ() - center.getZ();
+        if (dx * dx + dy * dy + dz * dz <= radiusSquared) visitor(body);
+    });
+}
+
+template <typename Visitor>
+void PhysicsSystem::forEachBodyInAABB(const Position& min, const Position& max, Visitor&& visitor) {
+    forEachQueryCandidate(min, max, [&](PhysicsBody& body) {
+        const Position& position = body.position;
+        if (position.getX() >= min.getX() && position.getX() <= max.getX() &&
+            position.getY() >= min.getY() && position.getY() <= max.getY() &&
+            position.getZ() >= min.getZ() && position.getZ() <= max.getZ()) {
+            visitor(body);
+        }
+    });
+}
+
+template <typename Fn>
+void PhysicsSystem::forEachQueryCandidate(const Position& min, const Position& max, Fn&& fn) {
+    refreshQueryGrid();
+    
+    // A cell lookup costs about as much as testing a dozen bodies, so large
+    // areas in small worlds are cheaper to scan
+    const double CELL_LOOKUP_COST = 16.0;
+    CellRange range = spatialHash.getCellRange(min, max);
+    double cellCount = static_cast<double>(range.maxX - range.minX + 1) *
+                       static_cast<double>(range.maxY - range.minY + 1) *
+                       static_cast<double>(range.maxZ - range.minZ + 1);
+    if (cellCount * CELL_LOOKUP_COST > static_cast<double>(bodies.size())) {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (bodies[i].isActive) fn(bodies[i]);
+        }
+        return;
+    }
+    
+    for (int z = range.minZ; z <= range.maxZ; ++z) {
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                const SpatialHash::Cell* cell = spatialHash.findCell(x, y, z);
+                if (!cell) continue;
+                
+                for (uint32_t slot : cell->ids) {
+                    // Report a body only from the first cell it shares with the area
+                    const CellRange& proxy = spatialHash.getProxyRange(slot);
+                    if (std::max(proxy.minX, range.minX) != x ||
+                        std::max(proxy.minY, range.minY) != y ||
+                        std::max(proxy.minZ, range.minZ) != z) {
+                        continue;
+                    }
+                    
+                    PhysicsBody& body = bodies.atSlot(slot);
+                    if (body.isActive) fn(body);
+                }
+            }
+        }
+    }
+}
+
 #endif // PHYSICS_SYSTEM_H
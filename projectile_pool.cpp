@@ -0,0 +1,336 @@
+#include "projectile_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROJECTILE_POOL_SSE2 1
+#endif
+
+namespace {
+    // Below this drag * time the closed forms lose precision to cancellation;
+    // their Taylor series are used instead
+    const double SMALL_DRAG_TIME = 1e-4;
+    const int GROUND_SOLVE_ITERATIONS = 60;
+    const double GROUND_SOLVE_TOLERANCE = 1e-9;
+
+    // Height and vertical velocity after time along a ballistic arc
+    void heightAt(double z, double vz, double gravity, double drag, double time, double& height, double& climb) {
+        BallisticStep step(drag, time);
+        height = z + vz * step.span - gravity * step.fall;
+        climb = vz * step.decay - gravity * step.span;
+    }
+
+    // First time in (0, horizon] the arc comes down through z = 0, or
+    // infinity. Vertical velocity only ever moves towards terminal velocity,
+    // so the arc rises at most once: past the apex height only falls, and
+    // the root is found by Newton's method kept inside a shrinking bracket.
+    float solveGroundTime(double z, double vz, double gravity, double drag, double horizon) {
+        const float never = std::numeric_limits<float>::infinity();
+
+        double apex = 0.0;
+        if (vz > 0.0) {
+            if (gravity <= 0.0) return never;
+            apex = drag * vz / gravity < SMALL_DRAG_TIME ? vz / gravity
+                                                         : std::log1p(drag * vz / gravity) / drag;
+        } else if (vz == 0.0 && gravity <= 0.0) {
+            return never;
+        }
+        if (apex > horizon) return never;
+
+        double height, climb;
+        heightAt(z, vz, gravity, drag, apex, height, climb);
+        if (height <= 0.0) return static_cast<float>(apex);
+        heightAt(z, vz, gravity, drag, horizon, height, climb);
+        if (height > 0.0) return never;
+
+        // Start from where the arc would land without drag
+        double low = apex, high = horizon;
+        double time = gravity > 0.0 ? (vz + std::sqrt(vz * vz + 2.0 * gravity * z)) / gravity : -z / vz;
+        if (!(time > low && time < high)) time = high;
+        for (int i = 0; i < GROUND_SOLVE_ITERATIONS; i++) {
+            heightAt(z, vz, gravity, drag, time, height, climb);
+            if (height > 0.0) low = time; else high = time;
+            double next = climb < 0.0 ? time - height / climb : 0.5 * (low + high);
+            if (next < low || next > high) next = 0.5 * (low + high);
+            bool converged = std::abs(next - time) < GROUND_SOLVE_TOLERANCE;
+            time = next;
+            if (converged) break;
+        }
+        return static_cast<float>(time);
+    }
+}
+
+BallisticStep::BallisticStep(double drag, double time) {
+    double x = drag * time;
+    decay = std::exp(-x);
+    if (std::abs(x) < SMALL_DRAG_TIME) {
+        span = time * (1.0 - x / 2.0 + x * x / 6.0);
+        fall = time * time * (0.5 - x / 6.0 + x * x / 24.0);
+    } else {
+        span = -std::expm1(-x) / drag;
+        fall = (time - span) / drag;
+    }
+}
+
+ProjectilePool::ProjectilePool(size_t capacity) : count(0), stepDeltaTime(0.0f) {
+    reserve(capacity);
+}
+
+void ProjectilePool::resizeColumns(size_t capacity) {
+    positionX.resize(capacity);
+    positionY.resize(capacity);
+    positionZ.resize(capacity);
+    previousX.resize(capacity);
+    previousY.resize(capacity);
+    previousZ.resize(capacity);
+    velocityX.resize(capacity);
+    velocityY.resize(capacity);
+    velocityZ.resize(capacity);
+    timeAlive.resize(capacity);
+    maxLifetime.resize(capacity);
+    groundTime.resize(capacity);
+    gravity.resize(capacity);
+    drag.resize(capacity);
+    radius.resize(capacity);
+    flags.resize(capacity);
+    sourceAbility.resize(capacity);
+    caster.resize(capacity);
+    indexSlot.resize(capacity);
+    stepDecay.resize(capacity);
+    stepSpan.resize(capacity);
+    stepFall.resize(capacity);
+}
+
+void ProjectilePool::reserve(size_t capacity) {
+    size_t oldCapacity = slotGeneration.size();
+    if (capacity <= oldCapacity) return;
+
+    resizeColumns(capacity);
+    slotGeneration.resize(capacity, 0);
+    slotIndex.resize(capacity, NO_SLOT_INDEX);
+
+    // Lowest slots on top of the stack, so a fresh pool hands out 0, 1, 2...
+    std::vector<uint32_t> added;
+    added.reserve(capacity - oldCapacity);
+    for (size_t slot = capacity; slot > oldCapacity; --slot) {
+        added.push_back(static_cast<uint32_t>(slot - 1));
+    }
+    freeSlots.insert(freeSlots.begin(), added.begin(), added.end());
+}
+
+ProjectileId ProjectilePool::spawn(const ProjectileInstance& projectile) {
+    if (freeSlots.empty()) return ProjectileId();
+
+    uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    size_t index = count++;
+    slotIndex[slot] = static_cast<uint32_t>(index);
+    indexSlot[index] = slot;
+
+    positionX[index] = projectile.currentPos.getX();
+    positionY[index] = projectile.currentPos.getY();
+    positionZ[index] = projectile.currentPos.getZ();
+    previousX[index] = positionX[index];
+    previousY[index] = positionY[index];
+    previousZ[index] = positionZ[index];
+    velocityX[index] = projectile.velocity.getX();
+    velocityY[index] = projectile.velocity.getY();
+    velocityZ[index] = projectile.velocity.getZ();
+    timeAlive[index] = projectile.timeAlive;
+    maxLifetime[index] = projectile.maxLifetime;
+    gravity[index] = projectile.gravity;
+    drag[index] = projectile.drag;
+    radius[index] = projectile.radius;
+    flags[index] = 0;
+    sourceAbility[index] = projectile.sourceAbility;
+    caster[index] = projectile.caster;
+
+    groundTime[index] = projectile.timeAlive +
+        solveGroundTime(projectile.currentPos.getZ(), projectile.velocity.getZ(), projectile.gravity,
+                        projectile.drag, projectile.maxLifetime - projectile.timeAlive);
+    setStep(index, stepDeltaTime);
+
+    return ProjectileId(slot, slotGeneration[slot]);
+}
+
+bool ProjectilePool::remove(ProjectileId id) {
+    size_t index = indexOf(id);
+    if (index == NO_INDEX) return false;
+
+    size_t last = count - 1;
+    if (index != last) moveIndex(last, index);
+    count--;
+
+    slotIndex[id.index] = NO_SLOT_INDEX;
+    slotGeneration[id.index]++;
+    freeSlots.push_back(id.index);
+    return true;
+}
+
+void ProjectilePool::clear() {
+    for (size_t index = 0; index < count; ++index) {
+        uint32_t slot = indexSlot[index];
+        slotIndex[slot] = NO_SLOT_INDEX;
+        slotGeneration[slot]++;
+        freeSlots.push_back(slot);
+    }
+    count = 0;
+}
+
+size_t ProjectilePool::indexOf(ProjectileId id) const {
+    if (id.index >= slotGeneration.size() || slotGeneration[id.index] != id.generation) return NO_INDEX;
+    uint32_t index = slotIndex[id.index];
+    return index == NO_SLOT_INDEX ? NO_INDEX : index;
+}
+
+ProjectileId ProjectilePool::idAt(size_t index) const {
+    uint32_t slot = indexSlot[index];
+    return ProjectileId(slot, slotGeneration[slot]);
+}
+
+ProjectileInstance ProjectilePool::get(size_t index) const {
+    ProjectileInstance projectile(Position(positionX[index], positionY[index], positionZ[index]),
+                                  Position(velocityX[index], velocityY[index], velocityZ[index]),
+                                  sourceAbility[index], caster[index], maxLifetime[index], radius[index]);
+    projectile.timeAlive = timeAlive[index];
+    projectile.gravity = gravity[index];
+    projectile.drag = drag[index];
+    projectile.isActive = flags[index] == 0;
+    return projectile;
+}
+
+Position ProjectilePool::predictPosition(size_t index, double time) const {
+    BallisticStep step(drag[index], time);
+    return Position(positionX[index] + velocityX[index] * step.span,
+                    positionY[index] + velocityY[index] * step.span,
+                    positionZ[index] + velocityZ[index] * step.span - gravity[index] * step.fall);
+}
+
+void ProjectilePool::setStep(size_t index, float deltaTime) {
+    BallisticStep step(drag[index], deltaTime);
+    stepDecay[index] = step.decay;
+    stepSpan[index] = step.span;
+    stepFall[index] = step.fall;
+}
+
+void ProjectilePool::age(float deltaTime, size_t index) {
+    timeAlive[index] += deltaTime;
+    uint8_t expired = timeAlive[index] >= maxLifetime[index] ? ProjectileFlag::EXPIRED : 0;
+    uint8_t grounded = timeAlive[index] >= groundTime[index] ? ProjectileFlag::GROUNDED : 0;
+    flags[index] |= expired | grounded;
+}
+
+void ProjectilePool::integrateScalar(float deltaTime, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        previousX[i] = positionX[i];
+        previousY[i] = positionY[i];
+        previousZ[i] = positionZ[i];
+        positionX[i] += velocityX[i] * stepSpan[i];
+        positionY[i] += velocityY[i] * stepSpan[i];
+        positionZ[i] += velocityZ[i] * stepSpan[i] - gravity[i] * stepFall[i];
+        velocityX[i] *= stepDecay[i];
+        velocityY[i] *= stepDecay[i];
+        velocityZ[i] = velocityZ[i] * stepDecay[i] - gravity[i] * stepSpan[i];
+
+        age(deltaTime, i);
+    }
+}
+
+void ProjectilePool::integrate(float deltaTime) {
+    prepareStep(deltaTime);
+    integrateRange(deltaTime, 0, count);
+}
+
+void ProjectilePool::prepareStep(float deltaTime) {
+    // Step coefficients only change with the timestep
+    if (deltaTime == stepDeltaTime) return;
+    stepDeltaTime = deltaTime;
+    for (size_t index = 0; index < count; ++index) {
+        setStep(index, deltaTime);
+    }
+}
+
+void ProjectilePool::integrateRange(float deltaTime, size_t begin, size_t end) {
+    size_t i = begin;
+
+#ifdef PROJECTILE_POOL_SSE2
+    for (; i + 2 <= end; i += 2) {
+        __m128d decay = _mm_loadu_pd(&stepDecay[i]);
+        __m128d span = _mm_loadu_pd(&stepSpan[i]);
+        __m128d g = _mm_loadu_pd(&gravity[i]);
+        __m128d vx = _mm_loadu_pd(&velocityX[i]);
+        __m128d vy = _mm_loadu_pd(&velocityY[i]);
+        __m128d vz = _mm_loadu_pd(&velocityZ[i]);
+        __m128d px = _mm_loadu_pd(&positionX[i]);
+        __m128d py = _mm_loadu_pd(&positionY[i]);
+        __m128d pz = _mm_loadu_pd(&positionZ[i]);
+        _mm_storeu_pd(&previousX[i], px);
+        _mm_storeu_pd(&previousY[i], py);
+        _mm_storeu_pd(&previousZ[i], pz);
+
+        __m128d dropZ = _mm_mul_pd(g, _mm_loadu_pd(&stepFall[i]));
+        _mm_storeu_pd(&positionX[i], _mm_add_pd(px, _mm_mul_pd(vx, span)));
+        _mm_storeu_pd(&positionY[i], _mm_add_pd(py, _mm_mul_pd(vy, span)));
+        _mm_storeu_pd(&positionZ[i], _mm_sub_pd(_mm_add_pd(pz, _mm_mul_pd(vz, span)), dropZ));
+        _mm_storeu_pd(&velocityX[i], _mm_mul_pd(vx, decay));
+        _mm_storeu_pd(&velocityY[i], _mm_mul_pd(vy, decay));
+        _mm_storeu_pd(&velocityZ[i], _mm_sub_pd(_mm_mul_pd(vz, decay), _mm_mul_pd(g, span)));
+
+        age(deltaTime, i);
+        age(deltaTime, i + 1);
+    }
+#endif
+
+    integrateScalar(deltaTime, i, end);
+}
+
+size_t ProjectilePool::removeDead() {
+    size_t removed = 0;
+    // Walking down, the projectile pulled into a gap has already been kept
+    for (size_t index = count; index > 0; --index) {
+        size_t current = index - 1;
+        if (flags[current] == 0) continue;
+
+        uint32_t slot = indexSlot[current];
+        size_t last = count - 1;
+        if (current != last) moveIndex(last, current);
+        count--;
+
+        slotIndex[slot] = NO_SLOT_INDEX;
+        slotGeneration[slot]++;
+        freeSlots.push_back(slot);
+        removed++;
+    }
+    return removed;
+}
+
+void ProjectilePool::moveIndex(size_t from, size_t to) {
+    positionX[to] = positionX[from];
+    positionY[to] = positionY[from];
+    positionZ[to] = positionZ[from];
+    previousX[to] = previousX[from];
+    previousY[to] = previousY[from];
+    previousZ[to] = previousZ[from];
+    velocityX[to] = velocityX[from];
+    velocityY[to] = velocityY[from];
+    velocityZ[to] = velocityZ[from];
+    timeAlive[to] = timeAlive[from];
+    maxLifetime[to] = maxLifetime[from];
+    groundTime[to] = groundTime[from];
+    gravity[to] = gravity[from];
+    drag[to] = drag[from];
+    radius[to] = radius[from];
+    flags[to] = flags[from];
+    sourceAbility[to] = sourceAbility[from];
+    caster[to] = caster[from];
+    stepDecay[to] = stepDecay[from];
+    stepSpan[to] = stepSpan[from];
+    stepFall[to] = stepFall[from];
+
+    uint32_t slot = indexSlot[from];
+    indexSlot[to] = slot;
+    slotIndex[slot] = static_cast<uint32_t>(to);
+}
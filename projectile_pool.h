@@ -0,0 +1,146 @@
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+#include "position.h"
+#include "slot_map.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Ability;
+class Character;
+
+// One projectile as spawned, and as read back from the pool for debugging
+struct ProjectileInstance {
+    Position currentPos;
+    Position velocity;          // Units per second
+    float timeAlive;           // Time since spawn in seconds
+    float maxLifetime;         // Max time before projectile expires
+    const Ability* sourceAbility;
+    Character* caster;
+    bool isActive;
+    float radius;              // Collision radius
+
+    // Optional physics properties
+    float gravity;             // Downward acceleration (units/s²)
+    float drag;                // Air resistance coefficient
+
+    ProjectileInstance(const Position& startPos, const Position& vel, const Ability* ability,
+                      Character* casterPtr, float lifetime = 10.0f, float collisionRadius = 0.5f)
+        : currentPos(startPos), velocity(vel), timeAlive(0.0f), maxLifetime(lifetime),
+          sourceAbility(ability), caster(casterPtr), isActive(true), radius(collisionRadius),
+          gravity(0.0f), drag(0.0f) {}
+};
+
+// Exact motion over a span of time under gravity g along -Z and linear drag
+// k, for a projectile at position p with velocity v:
+//   v' = v * decay            p' = p + v * span             (X and Y)
+//   v' = v * decay - g * span  p' = p + v * span - g * fall  (Z)
+struct BallisticStep {
+    double decay;   // e^(-k t)
+    double span;    // (1 - decay) / k; t without drag
+    double fall;    // (t - span) / k; t^2 / 2 without drag
+
+    BallisticStep(double drag, double time);
+};
+
+struct ProjectileRecord;
+using ProjectileId = Handle<ProjectileRecord>;
+
+// Why a projectile is done this step; any set flag removes it in removeDead()
+namespace ProjectileFlag {
+    const uint8_t EXPIRED = 1u << 0;   // Outlived maxLifetime
+    const uint8_t GROUNDED = 1u << 1;  // Came down through z = 0
+    const uint8_t HIT = 1u << 2;       // Struck a target
+}
+
+// Fixed-capacity projectile storage in structure-of-arrays layout. Live
+// projectiles are packed into indices 0..size()-1 of every column, so a step
+// is one straight pass over contiguous arrays. Removal moves the last
+// projectile into the gap; ids go through a slot table with a free list, so
+// a ProjectileId stays valid until its projectile is removed and a reused
+// slot never resolves an old id. Nothing allocates after construction or
+// reserve.
+class ProjectilePool {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+
+    // Hot columns, read by systems and written by integrate()
+    std::vector<double> positionX, positionY, positionZ;
+    std::vector<double> previousX, previousY, previousZ;  // Position before the last integrate()
+    std::vector<double> velocityX, velocityY, velocityZ;
+    std::vector<double> gravity;
+    std::vector<double> drag;
+    std::vector<float> timeAlive;
+    std::vector<float> maxLifetime;
+    std::vector<float> groundTime;       // timeAlive at which it comes down through z = 0; infinity if not within maxLifetime
+    std::vector<float> radius;
+    std::vector<uint8_t> flags;
+    // Cold columns, only touched on a hit
+    std::vector<const Ability*> sourceAbility;
+    std::vector<Character*> caster;
+
+private:
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> slotIndex;     // Dense index of each slot, NO_SLOT_INDEX when free
+    std::vector<uint32_t> indexSlot;     // Slot of each dense index
+    std::vector<uint32_t> freeSlots;
+    size_t count;
+
+    // BallisticStep of each projectile for stepDeltaTime, so integrate()
+    // does no transcendental math while the timestep stays the same
+    std::vector<double> stepDecay, stepSpan, stepFall;
+    float stepDeltaTime;
+
+public:
+    explicit ProjectilePool(size_t capacity = DEFAULT_CAPACITY);
+    ProjectilePool(const ProjectilePool&) = delete;
+    ProjectilePool& operator=(const ProjectilePool&) = delete;
+
+    // Invalid id when the pool is full
+    ProjectileId spawn(const ProjectileInstance& projectile);
+    bool remove(ProjectileId id);
+    void clear();
+
+    // Grows the pool to hold capacity projectiles; ids stay valid
+    void reserve(size_t capacity);
+    size_t getCapacity() const { return slotGeneration.size(); }
+    size_t size() const { return count; }
+    bool isFull() const { return count == slotGeneration.size(); }
+
+    bool isAlive(ProjectileId id) const { return indexOf(id) != NO_INDEX; }
+    size_t indexOf(ProjectileId id) const;
+    ProjectileId idAt(size_t index) const;
+    ProjectileInstance get(size_t index) const;
+
+    // Where the projectile will be in time seconds if nothing stops it; a
+    // negative time looks back along the arc it came in on
+    Position predictPosition(size_t index, double time) const;
+
+    // Ages every projectile and moves it along its exact trajectory under
+    // constant gravity (-Z) and linear drag, so the path does not depend on
+    // the tick rate. Flags those past their lifetime or their groundTime,
+    // which is solved once at spawn. The position it started from is kept
+    // in the previous columns for swept hit tests. Uses SSE2 two projectiles
+    // at a time where available, scalar code otherwise.
+    void integrate(float deltaTime);
+    // integrate() in pieces: prepareStep() once, then integrateRange() over
+    // disjoint index ranges, which may run on different threads
+    void prepareStep(float deltaTime);
+    void integrateRange(float deltaTime, size_t begin, size_t end);
+
+    // Removes every flagged projectile and returns how many went
+    size_t removeDead();
+
+private:
+    static constexpr uint32_t NO_SLOT_INDEX = 0xFFFFFFFFu;
+
+    void resizeColumns(size_t capacity);
+    void setStep(size_t index, float deltaTime);
+    void integrateScalar(float deltaTime, size_t begin, size_t end);
+    void age(float deltaTime, size_t index);
+    void moveIndex(size_t from, size_t to);
+};
+
+#endif // PROJECTILE_POOL_H
@@ -0,0 +1,47 @@
+#ifndef PROJECTILE_SWEEP_H
+#define PROJECTILE_SWEEP_H
+
+#include "position.h"
+#include <algorithm>
+#include <cmath>
+
+// Swept hit tests over one projectile step, from where the projectile was
+// at the start of the step to where it is at the end. Each returns the
+// earliest fraction of the step in [0, 1] at which the projectile touches
+// the target, or NO_SWEEP_HIT if it never does during the step.
+const double NO_SWEEP_HIT = -1.0;
+
+// A point moving along the segment against a sphere around center. Starting
+// inside counts as touching at 0.
+inline double sweepSphere(const Position& start, const Position& end, const Position& center, double radius) {
+    Position step = end - start;
+    Position offset = start - center;
+    double c = offset.dot(offset) - radius * radius;
+    if (c <= 0.0) return 0.0;
+
+    // Solve |offset + step * t| = radius for the smaller root
+    double a = step.dot(step);
+    double b = offset.dot(step);
+    if (a == 0.0 || b >= 0.0) return NO_SWEEP_HIT;  // Still, or moving away
+    double discriminant = b * b - a * c;
+    if (discriminant < 0.0) return NO_SWEEP_HIT;
+    double t = (-b - std::sqrt(discriminant)) / a;
+    return t <= 1.0 ? t : NO_SWEEP_HIT;
+}
+
+// Area shapes (cones, lines) with no closed form: runs test(position) at
+// evenly spaced points no more than spacing apart, ending at end. The start
+// is skipped since the previous step already tested it, so a step shorter
+// than spacing is a single test at end.
+template <typename Test>
+double sweepSampled(const Position& start, const Position& end, double spacing, Test test) {
+    Position step = end - start;
+    int samples = std::max(1, static_cast<int>(std::ceil(step.length() / spacing)));
+    for (int k = 1; k <= samples; ++k) {
+        double t = static_cast<double>(k) / samples;
+        if (test(start + step * t)) return t;
+    }
+    return NO_SWEEP_HIT;
+}
+
+#endif // PROJECTILE_SWEEP_H
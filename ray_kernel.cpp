@@ -0,0 +1,147 @@
+#include "ray_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAY_KERNEL_SSE2 1
+#endif
+
+void RaySphereCandidates::clear() {
+    slots.clear();
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void RaySphereCandidates::add(uint32_t slot, float x, float y, float z, float sphereRadius) {
+    slots.push_back(slot);
+    centerX.push_back(x);
+    centerY.push_back(y);
+    centerZ.push_back(z);
+    radius.push_back(sphereRadius);
+}
+
+int findNearestSphereHit(const RaySphereCandidates& candidates, float directionX, float directionY,
+                         float directionZ, float maxDistance, float& distance) {
+    const size_t count = candidates.size();
+    size_t i = 0;
+    int best = -1;
+    float bestDistance = maxDistance;
+
+#ifdef RAY_KERNEL_SSE2
+    const __m128 dx = _mm_set1_ps(directionX);
+    const __m128 dy = _mm_set1_ps(directionY);
+    const __m128 dz = _mm_set1_ps(directionZ);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 four = _mm_set1_ps(4.0f);
+
+    __m128 laneBest = _mm_set1_ps(maxDistance);
+    __m128 laneIndex = _mm_set1_ps(-1.0f);
+    __m128 index = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(&candidates.centerX[i]);
+        __m128 cy = _mm_loadu_ps(&candidates.centerY[i]);
+        __m128 cz = _mm_loadu_ps(&candidates.centerZ[i]);
+        __m128 r = _mm_loadu_ps(&candidates.radius[i]);
+
+        // Projection of the center on the ray and squared distance outside the surface
+        __m128 projection = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, dx), _mm_mul_ps(cy, dy)), _mm_mul_ps(cz, dz));
+        __m128 centerSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy)), _mm_mul_ps(cz, cz));
+        __m128 outside = _mm_sub_ps(centerSquared, _mm_mul_ps(r, r));
+        __m128 discriminant = _mm_sub_ps(_mm_mul_ps(projection, projection), outside);
+
+        __m128 t = _mm_sub_ps(projection, _mm_sqrt_ps(_mm_max_ps(discriminant, zero)));
+        __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(discriminant, zero), _mm_cmpgt_ps(outside, zero)),
+                                _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, laneBest)));
+
+        laneBest = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, laneBest));
+        laneIndex = _mm_or_ps(_mm_and_ps(hit, index), _mm_andnot_ps(hit, laneIndex));
+        index = _mm_add_ps(index, four);
+    }
+
+    // Lowest index wins ties, as in the scalar loop
+    float lanes[4];
+    float indices[4];
+    _mm_storeu_ps(lanes, laneBest);
+    _mm_storeu_ps(indices, laneIndex);
+    for (int lane = 0; lane < 4; ++lane) {
+        if (indices[lane] < 0.0f) continue;
+        int candidate = static_cast<int>(indices[lane]);
+        if (lanes[lane] < bestDistance || (lanes[lane] == bestDistance && candidate < best)) {
+            bestDistance = lanes[lane];
+            best = candidate;
+        }
+    }
+#endif
+
+    float tailDistance = bestDistance;
+    int tail = findNearestSphereHitScalar(candidates, i, directionX, directionY, directionZ, bestDistance, tailDistance);
+    if (tail >= 0 && (best < 0 || tailDistance < bestDistance)) {
+        best = tail;
+        bestDistance = tailDistance;
+    }
+
+    if (best >= 0) distance = bestDistance;
+    return best;
+}
+
+int findNearestSphereHitScalar(const RaySphereCandidates& candidates, size_t begin, float directionX,
+                               float directionY, float directionZ, float maxDistance, float& distance) {
+    int best = -1;
+    float bestDistance = maxDistance;
+
+    for (size_t i = begin; i < candidates.size(); ++i) {
+        float cx = candidates.centerX[i];
+        float cy = candidates.centerY[i];
+        float cz = candidates.centerZ[i];
+        float r = candidates.radius[i];
+
+        float projection = cx * directionX + cy * directionY + cz * directionZ;
+        float outside = cx * cx + cy * cy + cz * cz - r * r;
+        float discriminant = projection * projection - outside;
+        if (discriminant < 0.0f || outside <= 0.0f) continue;
+
+        float t = projection - std::sqrt(discriminant);
+        if (t > 0.0f && t < bestDistance) {
+            bestDistance = t;
+            best = static_cast<int>(i);
+        }
+    }
+
+    if (best >= 0) distance = bestDistance;
+    return best;
+}
+
+double intersectRayBox(double centerX, double centerY, double centerZ,
+                       double halfX, double halfY, double halfZ,
+                       double directionX, double directionY, double directionZ, double maxDistance) {
+    const double center[3] = {centerX, centerY, centerZ};
+    const double half[3] = {halfX, halfY, halfZ};
+    const double direction[3] = {directionX, directionY, directionZ};
+
+    // Slab test: the ray is inside the box where it is inside all three slabs
+    double enter = -std::numeric_limits<double>::infinity();
+    double exit = std::numeric_limits<double>::infinity();
+    for (int axis = 0; axis < 3; ++axis) {
+        double low = center[axis] - half[axis];
+        double high = center[axis] + half[axis];
+        if (direction[axis] == 0.0) {
+            if (low > 0.0 || high < 0.0) return -1.0;
+            continue;
+        }
+        double inverse = 1.0 / direction[axis];
+        double slabEnter = low * inverse;
+        double slabExit = high * inverse;
+        if (slabEnter > slabExit) std::swap(slabEnter, slabExit);
+        enter = std::max(enter, slabEnter);
+        exit = std::min(exit, slabExit);
+        if (enter > exit) return -1.0;
+    }
+
+    if (enter <= 0.0 || enter > maxDistance) return -1.0;
+    return enter;
+}
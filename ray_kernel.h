@@ -0,0 +1,39 @@
+#ifndef RAY_KERNEL_H
+#define RAY_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sphere candidates of one ray in structure-of-arrays layout. Centers are
+// stored relative to the ray origin, so single precision is enough even far
+// from the world origin.
+struct RaySphereCandidates {
+    std::vector<uint32_t> slots;  // Body pool slot of each candidate
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> radius;
+
+    size_t size() const { return slots.size(); }
+    void clear();
+    void add(uint32_t slot, float x, float y, float z, float sphereRadius);
+};
+
+// Finds the nearest sphere the ray enters within maxDistance. The direction
+// must be unit length. Spheres containing the origin are not hits. Returns the
+// candidate index or -1, and the hit distance through distance.
+// Tests four spheres at a time with SSE2 where available.
+int findNearestSphereHit(const RaySphereCandidates& candidates, float directionX, float directionY,
+                         float directionZ, float maxDistance, float& distance);
+
+// Scalar reference version, also used for the tail of the SIMD loop
+int findNearestSphereHitScalar(const RaySphereCandidates& candidates, size_t begin, float directionX,
+                               float directionY, float directionZ, float maxDistance, float& distance);
+
+// Distance at which a ray enters an axis-aligned box centered relative to the
+// origin, or a negative value if it misses, starts inside or only gets there
+// beyond maxDistance
+double intersectRayBox(double centerX, double centerY, double centerZ,
+                       double halfX, double halfY, double halfZ,
+                       double directionX, double directionY, double directionZ, double maxDistance);
+
+#endif // RAY_KERNEL_H
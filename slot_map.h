@@ -0,0 +1,158 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Generational handle into a SlotMap<T>.
+// A handle goes stale when its object is erased, even if the slot is reused.
+template <typename T>
+struct Handle {
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index;       // Slot index
+    uint32_t generation;  // Must match the slot's generation to resolve
+
+    Handle() : index(INVALID_INDEX), generation(0) {}
+    Handle(uint32_t slotIndex, uint32_t slotGeneration) : index(slotIndex), generation(slotGeneration) {}
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+// Pool of T with stable addresses and O(1) insert/erase/lookup.
+// Objects live in fixed-size chunks and never move, so pointers stay valid
+// until the object is erased. A dense array of live objects is kept for
+// iteration and compacted with swap-and-pop on erase.
+template <typename T, size_t CHUNK_SIZE = 256>
+class SlotMap {
+private:
+    static constexpr uint32_t NOT_LIVE = 0xFFFFFFFFu;
+
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    struct Slot {
+        uint32_t generation;
+        uint32_t denseIndex;  // NOT_LIVE when the slot is free
+    };
+
+    std::vector<std::unique_ptr<Storage[]>> chunks;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<T*> denseObjects;     // Live objects in iteration order
+    std::vector<uint32_t> denseSlots; // Slot index of each dense entry
+
+public:
+    SlotMap() = default;
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+    ~SlotMap() { clear(); }
+
+    template <typename... Args>
+    Handle<T> emplace(Args&&... args) {
+        uint32_t slotIndex;
+        if (!freeSlots.empty()) {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, NOT_LIVE});
+            if (slotIndex / CHUNK_SIZE >= chunks.size()) {
+                chunks.emplace_back(new Storage[CHUNK_SIZE]);
+            }
+        }
+
+        T* object = new (storageFor(slotIndex)) T(std::forward<Args>(args)...);
+        slots[slotIndex].denseIndex = static_cast<uint32_t>(denseObjects.size());
+        denseObjects.push_back(object);
+        denseSlots.push_back(slotIndex);
+
+        return Handle<T>(slotIndex, slots[slotIndex].generation);
+    }
+
+    Handle<T> insert(const T& value) { return emplace(value); }
+
+    bool erase(Handle<T> handle) {
+        if (!contains(handle)) return false;
+
+        Slot& slot = slots[handle.index];
+        uint32_t denseIndex = slot.denseIndex;
+        denseObjects[denseIndex]->~T();
+
+        // Swap-and-pop keeps the dense array packed
+        uint32_t lastIndex = static_cast<uint32_t>(denseObjects.size() - 1);
+        if (denseIndex != lastIndex) {
+            denseObjects[denseIndex] = denseObjects[lastIndex];
+            denseSlots[denseIndex] = denseSlots[lastIndex];
+            slots[denseSlots[denseIndex]].denseIndex = denseIndex;
+        }
+        denseObjects.pop_back();
+        denseSlots.pop_back();
+
+        slot.denseIndex = NOT_LIVE;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    void clear() {
+        for (T* object : denseObjects) {
+            object->~T();
+        }
+        for (uint32_t slotIndex : denseSlots) {
+            slots[slotIndex].denseIndex = NOT_LIVE;
+            slots[slotIndex].generation++;
+            freeSlots.push_back(slotIndex);
+        }
+        denseObjects.clear();
+        denseSlots.clear();
+    }
+
+    // Lookups
+    bool contains(Handle<T> handle) const {
+        return handle.index < slots.size() &&
+               slots[handle.index].generation == handle.generation &&
+               slots[handle.index].denseIndex != NOT_LIVE;
+    }
+
+    T* get(Handle<T> handle) { return contains(handle) ? denseObjects[slots[handle.index].denseIndex] : nullptr; }
+    const T* get(Handle<T> handle) const { return contains(handle) ? denseObjects[slots[handle.index].denseIndex] : nullptr; }
+
+    // Slot-level access for callers that key side tables by slot index
+    bool isSlotLive(uint32_t slotIndex) const { return slotIndex < slots.size() && slots[slotIndex].denseIndex != NOT_LIVE; }
+    T& atSlot(uint32_t slotIndex) { return *denseObjects[slots[slotIndex].denseIndex]; }
+    const T& atSlot(uint32_t slotIndex) const { return *denseObjects[slots[slotIndex].denseIndex]; }
+    Handle<T> handleForSlot(uint32_t slotIndex) const { return Handle<T>(slotIndex, slots[slotIndex].generation); }
+    size_t getSlotCapacity() const { return slots.size(); }
+
+    // Dense iteration
+    size_t size() const { return denseObjects.size(); }
+    bool empty() const { return denseObjects.empty(); }
+    T& operator[](size_t denseIndex) { return *denseObjects[denseIndex]; }
+    const T& operator[](size_t denseIndex) const { return *denseObjects[denseIndex]; }
+    uint32_t slotAt(size_t denseIndex) const { return denseSlots[denseIndex]; }
+    Handle<T> handleAt(size_t denseIndex) const { return handleForSlot(denseSlots[denseIndex]); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (T* object : denseObjects) fn(*object);
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const T* object : denseObjects) fn(*object);
+    }
+
+private:
+    void* storageFor(uint32_t slotIndex) {
+        return &chunks[slotIndex / CHUNK_SIZE][slotIndex % CHUNK_SIZE];
+    }
+};
+
+#endif // SLOT_MAP_H
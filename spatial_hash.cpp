@@ -0,0 +1,256 @@
+#include "spatial_hash.h"
+#include "hash_mix.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Cell coordinates are packed as three biased 21-bit fields
+    const int COORD_BITS = 21;
+    const int COORD_BIAS = 1 << (COORD_BITS - 1);
+    const uint64_t COORD_MASK = (1ull << COORD_BITS) - 1;
+    const size_t INITIAL_TABLE_SIZE = 64;
+}
+
+SpatialHash::SpatialHash(float cellSize)
+    : cellSize(cellSize), invCellSize(1.0f / cellSize), occupiedSlots(0) {
+    table.assign(INITIAL_TABLE_SIZE, Slot{EMPTY_KEY, 0});
+}
+
+void SpatialHash::insert(uint32_t id, const Position& min, const Position& max) {
+    if (id >= proxies.size()) {
+        proxies.resize(id + 1);
+    }
+    if (proxies[id].registered) {
+        update(id, min, max);
+        return;
+    }
+
+    proxies[id].registered = true;
+    proxies[id].range = getCellRange(min, max);
+    addToCells(id);
+}
+
+void SpatialHash::update(uint32_t id, const Position& min, const Position& max) {
+    if (!contains(id)) {
+        insert(id, min, max);
+        return;
+    }
+
+    // Bodies usually stay inside the same cells from one step to the next
+    CellRange range = getCellRange(min, max);
+    if (range == proxies[id].range) return;
+
+    removeFromCells(id);
+    proxies[id].range = range;
+    addToCells(id);
+}
+
+void SpatialHash::remove(uint32_t id) {
+    if (!contains(id)) return;
+
+    removeFromCells(id);
+    proxies[id].registered = false;
+}
+
+void SpatialHash::clear() {
+    table.assign(INITIAL_TABLE_SIZE, Slot{EMPTY_KEY, 0});
+    occupiedSlots = 0;
+    cells.clear();
+    freeCells.clear();
+    proxies.clear();
+}
+
+CellRange SpatialHash::getCellRange(const Position& min, const Position& max) const {
+    CellRange range;
+    range.minX = toCell(min.getX());
+    range.minY = toCell(min.getY());
+    range.minZ = toCell(min.getZ());
+    range.maxX = toCell(max.getX());
+    range.maxY = toCell(max.getY());
+    range.maxZ = toCell(max.getZ());
+    return range;
+}
+
+const SpatialHash::Cell* SpatialHash::findCell(int x, int y, int z) const {
+    size_t slotIndex = findSlot(packKey(x, y, z));
+    if (slotIndex == table.size()) return nullptr;
+    return &cells[table[slotIndex].cell];
+}
+
+void SpatialHash::setCellSize(float size) {
+    // Existing ranges are meaningless at a new resolution, so start over
+    clear();
+    cellSize = size;
+    invCellSize = 1.0f / size;
+}
+
+size_t SpatialHash::getMemoryUsage() const {
+    size_t bytes = table.capacity() * sizeof(Slot) +
+                   cells.capacity() * sizeof(Cell) +
+                   freeCells.capacity() * sizeof(uint32_t) +
+                   proxies.capacity() * sizeof(Proxy);
+    for (const Cell& cell : cells) {
+        bytes += cell.ids.capacity() * sizeof(uint32_t);
+    }
+    for (const Proxy& proxy : proxies) {
+        bytes += proxy.memberships.capacity() * sizeof(Membership);
+    }
+    return bytes;
+}
+
+uint64_t SpatialHash::packKey(int x, int y, int z) {
+    return (static_cast<uint64_t>(x + COORD_BIAS) & COORD_MASK) |
+           ((static_cast<uint64_t>(y + COORD_BIAS) & COORD_MASK) << COORD_BITS) |
+           ((static_cast<uint64_t>(z + COORD_BIAS) & COORD_MASK) << (2 * COORD_BITS));
+}
+
+int SpatialHash::toCell(double coordinate) const {
+    double cell = std::floor(coordinate * invCellSize);
+    double limit = static_cast<double>(COORD_BIAS - 1);
+    return static_cast<int>(std::max(-limit, std::min(cell, limit)));
+}
+
+uint32_t SpatialHash::acquireCell(int x, int y, int z) {
+    uint64_t key = packKey(x, y, z);
+    size_t slotIndex = findSlot(key);
+    if (slotIndex != table.size()) {
+        return table[slotIndex].cell;
+    }
+
+    // Keep the load factor at or below one half
+    if ((occupiedSlots + 1) * 2 > table.size()) {
+        growTable();
+    }
+
+    uint32_t cellIndex;
+    if (!freeCells.empty()) {
+        cellIndex = freeCells.back();
+        freeCells.pop_back();
+    } else {
+        cellIndex = static_cast<uint32_t>(cells.size());
+        cells.emplace_back();
+    }
+
+    Cell& cell = cells[cellIndex];
+    cell.key = key;
+    cell.x = x;
+    cell.y = y;
+    cell.z = z;
+
+    size_t mask = table.size() - 1;
+    size_t index = mixHash(key) & mask;
+    while (table[index].key != EMPTY_KEY) {
+        index = (index + 1) & mask;
+    }
+    table[index].key = key;
+    table[index].cell = cellIndex;
+    occupiedSlots++;
+
+    return cellIndex;
+}
+
+void SpatialHash::releaseCell(uint32_t cellIndex) {
+    Cell& cell = cells[cellIndex];
+    size_t slotIndex = findSlot(cell.key);
+    if (slotIndex != table.size()) {
+        eraseSlot(slotIndex);
+    }
+
+    // The id vector keeps its capacity for the next cell that reuses it
+    cell.key = EMPTY_KEY;
+    cell.ids.clear();
+    freeCells.push_back(cellIndex);
+}
+
+size_t SpatialHash::findSlot(uint64_t key) const {
+    size_t mask = table.size() - 1;
+    size_t index = mixHash(key) & mask;
+
+    while (table[index].key != EMPTY_KEY) {
+        if (table[index].key == key) return index;
+        index = (index + 1) & mask;
+    }
+    return table.size();
+}
+
+void SpatialHash::eraseSlot(size_t slotIndex) {
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    size_t mask = table.size() - 1;
+    size_t hole = slotIndex;
+    size_t index = slotIndex;
+
+    while (true) {
+        index = (index + 1) & mask;
+        if (table[index].key == EMPTY_KEY) break;
+
+        size_t home = mixHash(table[index].key) & mask;
+        bool homeBetween = (hole <= index) ? (hole < home && home <= index)
+                                           : (hole < home || home <= index);
+        if (!homeBetween) {
+            table[hole] = table[index];
+            hole = index;
+        }
+    }
+
+    table[hole].key = EMPTY_KEY;
+    occupiedSlots--;
+}
+
+void SpatialHash::growTable() {
+    std::vector<Slot> oldTable;
+    oldTable.swap(table);
+    table.assign(oldTable.size() * 2, Slot{EMPTY_KEY, 0});
+
+    size_t mask = table.size() - 1;
+    for (const Slot& slot : oldTable) {
+        if (slot.key == EMPTY_KEY) continue;
+
+        size_t index = mixHash(slot.key) & mask;
+        while (table[index].key != EMPTY_KEY) {
+            index = (index + 1) & mask;
+        }
+        table[index] = slot;
+    }
+}
+
+void SpatialHash::addToCells(uint32_t id) {
+    Proxy& proxy = proxies[id];
+    const CellRange& range = proxy.range;
+    proxy.memberships.clear();
+
+    for (int x = range.minX; x <= range.maxX; ++x) {
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int z = range.minZ; z <= range.maxZ; ++z) {
+                uint32_t cellIndex = acquireCell(x, y, z);
+                std::vector<uint32_t>& ids = cells[cellIndex].ids;
+                proxy.memberships.push_back(Membership{cellIndex, static_cast<uint32_t>(ids.size())});
+                ids.push_back(id);
+            }
+        }
+    }
+}
+
+void SpatialHash::removeFromCells(uint32_t id) {
+    for (const Membership& membership : proxies[id].memberships) {
+        std::vector<uint32_t>& ids = cells[membership.cell].ids;
+
+        // Swap-and-pop, then point the moved proxy at its new position
+        uint32_t movedId = ids.back();
+        ids[membership.position] = movedId;
+        ids.pop_back();
+
+        if (movedId != id) {
+            for (Membership& moved : proxies[movedId].memberships) {
+                if (moved.cell == membership.cell) {
+                    moved.position = membership.position;
+                    break;
+                }
+            }
+        }
+
+        if (ids.empty()) {
+            releaseCell(membership.cell);
+        }
+    }
+    proxies[id].memberships.clear();
+}
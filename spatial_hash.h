@@ -0,0 +1,114 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "position.h"
+#include <cstdint>
+#include <vector>
+
+// Inclusive range of grid cells overlapped by a proxy
+struct CellRange {
+    int minX, minY, minZ;
+    int maxX, maxY, maxZ;
+
+    bool operator==(const CellRange& other) const {
+        return minX == other.minX && minY == other.minY && minZ == other.minZ &&
+               maxX == other.maxX && maxY == other.maxY && maxZ == other.maxZ;
+    }
+    bool operator!=(const CellRange& other) const { return !(*this == other); }
+};
+
+// Sparse uniform grid over an unbounded world.
+// Only occupied cells exist; they are found through an open-addressing table
+// keyed by the packed cell coordinates. Proxies are identified by small dense
+// ids chosen by the caller and may overlap several cells.
+class SpatialHash {
+public:
+    // One occupied cell and the proxies registered in it
+    struct Cell {
+        uint64_t key;
+        int x, y, z;
+        std::vector<uint32_t> ids;
+    };
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~0ull;
+
+    // Open-addressing table entry pointing at a cell
+    struct Slot {
+        uint64_t key;
+        uint32_t cell;
+    };
+
+    // Where a proxy sits inside one of its cells
+    struct Membership {
+        uint32_t cell;
+        uint32_t position;  // Index into Cell::ids
+    };
+
+    struct Proxy {
+        CellRange range;
+        bool registered;
+        std::vector<Membership> memberships;
+
+        Proxy() : range(), registered(false) {}
+    };
+
+    float cellSize;
+    float invCellSize;
+
+    std::vector<Slot> table;           // Power-of-two sized, linear probing
+    size_t occupiedSlots;
+    std::vector<Cell> cells;           // Cell storage, reused through freeCells
+    std::vector<uint32_t> freeCells;
+    std::vector<Proxy> proxies;        // Indexed by proxy id
+
+public:
+    explicit SpatialHash(float cellSize = 10.0f);
+
+    // Proxy management
+    void insert(uint32_t id, const Position& min, const Position& max);
+    void update(uint32_t id, const Position& min, const Position& max);
+    void remove(uint32_t id);
+    void clear();
+    bool contains(uint32_t id) const { return id < proxies.size() && proxies[id].registered; }
+
+    // Cell lookups
+    CellRange getCellRange(const Position& min, const Position& max) const;
+    const CellRange& getProxyRange(uint32_t id) const { return proxies[id].range; }
+    const Cell* findCell(int x, int y, int z) const;
+    int getCellCoordinate(double coordinate) const { return toCell(coordinate); }
+
+    // Iterates occupied cells as fn(const Cell&)
+    template <typename Fn>
+    void forEachCell(Fn&& fn) const {
+        for (const Cell& cell : cells) {
+            if (!cell.ids.empty()) fn(cell);
+        }
+    }
+
+    // Cell storage by index, for splitting the cells into ranges. A cell
+    // with no ids is unoccupied and waiting to be reused.
+    size_t getCellStorageSize() const { return cells.size(); }
+    const Cell& getCellAt(size_t index) const { return cells[index]; }
+
+    // Configuration and statistics
+    void setCellSize(float size);
+    float getCellSize() const { return cellSize; }
+    size_t getOccupiedCellCount() const { return occupiedSlots; }
+    size_t getMemoryUsage() const;
+
+private:
+    static uint64_t packKey(int x, int y, int z);
+    int toCell(double coordinate) const;
+
+    uint32_t acquireCell(int x, int y, int z);
+    void releaseCell(uint32_t cellIndex);
+    size_t findSlot(uint64_t key) const;
+    void eraseSlot(size_t slotIndex);
+    void growTable();
+
+    void addToCells(uint32_t id);
+    void removeFromCells(uint32_t id);
+};
+
+#endif // SPATIAL_HASH_H
@@ -286,7 +286,7 @@ void StatusEffect::applyEffectToCharacter(Character& target) {
                 float currentSpeed = target.getStats().getMovementSpeed();
                 float newSpeed = currentSpeed * (1.0f - (magnitude / 100.0f)); // magnitude as percentage
                 if (newSpeed < 0.1f) newSpeed = 0.1f; // Minimum 10% speed
-                target.getStatsRef().setMovementSpeed(newSpeed);
+                target.setMovementSpeed(newSpeed);
                 std::cout << target.getName() << "'s movement speed reduced to " << (newSpeed * 100) << "%!" << std::endl;
             }
             break;
@@ -295,7 +295,7 @@ void StatusEffect::applyEffectToCharacter(Character& target) {
                 float currentSpeed = target.getStats().getAttackSpeed();
                 float newSpeed = currentSpeed * (1.0f - (magnitude / 100.0f)); // magnitude as percentage
                 if (newSpeed < 0.1f) newSpeed = 0.1f; // Minimum 10% speed
-                target.getStatsRef().setAttackSpeed(newSpeed);
+                target.setAttackSpeed(newSpeed);
                 std::cout << target.getName() << "'s attack speed reduced to " << (newSpeed * 100) << "%!" << std::endl;
             }
             break;
@@ -305,7 +305,7 @@ void StatusEffect::applyEffectToCharacter(Character& target) {
             {
                 float currentMultiplier = target.getStats().getDamageMultiplier();
                 float newMultiplier = currentMultiplier * (1.0f + (magnitude / 100.0f)); // magnitude as percentage
-                target.getStatsRef().setDamageMultiplier(newMultiplier);
+                target.setDamageMultiplier(newMultiplier);
                 std::cout << target.getName() << " takes " << (newMultiplier * 100) << "% damage (vulnerable)!" << std::endl;
             }
             break;
@@ -314,7 +314,7 @@ void StatusEffect::applyEffectToCharacter(Character& target) {
                 float currentMultiplier = target.getStats().getDamageMultiplier();
                 float newMultiplier = currentMultiplier * (1.0f - (magnitude / 100.0f)); // magnitude as percentage
                 if (newMultiplier < 0.1f) newMultiplier = 0.1f; // Minimum 10% damage
-                target.getStatsRef().setDamageMultiplier(newMultiplier);
+                target.setDamageMultiplier(newMultiplier);
             }
             
         default:
@@ -371,21 +371,21 @@ void StatusEffect::removeEffectFromCharacter(Character& target) {
             
         // Speed modification effects
         case SLOW_MOVEMENT:
-            target.getStatsRef().setMovementSpeed(1.0f); // Reset to normal
+            target.setMovementSpeed(1.0f); // Reset to normal
             std::cout << target.getName() << "'s movement speed restored to normal!" << std::endl;
             break;
         case SLOW_ATTACK:
-            target.getStatsRef().setAttackSpeed(1.0f); // Reset to normal
+            target.setAttackSpeed(1.0f); // Reset to normal
             std::cout << target.getName() << "'s attack speed restored to normal!" << std::endl;
             break;
             
         // Damage modification effects
         case VULNERABILITY:
-            target.getStatsRef().setDamageMultiplier(1.0f); // Reset to normal
+            target.setDamageMultiplier(1.0f); // Reset to normal
             std::cout << target.getName() << "'s damage vulnerability removed!" << std::endl;
             break;
         case RESISTANCE:
-            target.getStatsRef().setDamageMultiplier(1.0f); // Reset to normal
+            target.setDamageMultiplier(1.0f); // Reset to normal
             std::cout << target.getName() << "'s damage resistance removed!" << std::endl;
             break;
             
@@ -443,10 +443,10 @@ void StatusEffect::applyEffectToMob(Mob& target) {
                 if (currentStrength > magnitude) {
                     // Calculate final strength value
                     stattype finalStrength = currentStrength - magnitude;
-                    target.getStatsRef().setStrength(finalStrength);
+                    target.setStrength(finalStrength);
                 } else {
                     // Set to minimum of 1
-                    target.getStatsRef().setStrength(1);
+                    target.setStrength(1);
                 }
                 std::cout << "DEBUG: MOB DEBUFF_STRENGTH - Old: " << currentStrength << ", Reducing by: " << magnitude << ", New: " << target.getStats().getStrength() << std::endl;
             }
@@ -458,10 +458,10 @@ void StatusEffect::applyEffectToMob(Mob& target) {
                 if (currentDexterity > magnitude) {
                     // Calculate final dexterity value
                     stattype finalDexterity = currentDexterity - magnitude;
-                    target.getStatsRef().setDexterity(finalDexterity);
+                    target.setDexterity(finalDexterity);
                 } else {
                     // Set to minimum of 1
-                    target.getStatsRef().setDexterity(1);
+                    target.setDexterity(1);
                 }
                 std::cout << "DEBUG: MOB DEBUFF_DEXTERITY - Old: " << currentDexterity << ", Reducing by: " << magnitude << ", New: " << target.getStats().getDexterity() << std::endl;
             }
@@ -473,10 +473,10 @@ void StatusEffect::applyEffectToMob(Mob& target) {
                 if (currentIntelligence > magnitude) {
                     // Calculate final intelligence value
                     stattype finalIntelligence = currentIntelligence - magnitude;
-                    target.getStatsRef().setIntelligence(finalIntelligence);
+                    target.setIntelligence(finalIntelligence);
                 } else {
                     // Set to minimum of 1
-                    target.getStatsRef().setIntelligence(1);
+                    target.setIntelligence(1);
                 }
                 std::cout << "DEBUG: MOB DEBUFF_INTELLIGENCE - Old: " << currentIntelligence << ", Reducing by: " << magnitude << ", New: " << target.getStats().getIntelligence() << std::endl;
             }
@@ -570,34 +570,34 @@ void StatusEffect::removeEffectFromMob(Mob& target) {
     // Same logic as character removal
     switch (type) {
         case BUFF_STRENGTH:
-            target.getStatsRef().setStrength(target.getStats().getStrength() - magnitude);
+            target.setStrength(target.getStats().getStrength() - magnitude);
             break;
         case BUFF_DEXTERITY:
-            target.getStatsRef().setDexterity(target.getStats().getDexterity() - magnitude);
+            target.setDexterity(target.getStats().getDexterity() - magnitude);
             break;
         case BUFF_INTELLIGENCE:
-            target.getStatsRef().setIntelligence(target.getStats().getIntelligence() - magnitude);
+            target.setIntelligence(target.getStats().getIntelligence() - magnitude);
             break;
         case BUFF_MAX_HEALTH:
-            target.getStatsRef().setMaxHealth(target.getStats().getMaxHealth() - magnitude);
+            target.setMaxHealth(target.getStats().getMaxHealth() - magnitude);
             break;
         case BUFF_MAX_MANA:
-            target.getStatsRef().setMaxMana(target.getStats().getMaxMana() - magnitude);
+            target.setMaxMana(target.getStats().getMaxMana() - magnitude);
             break;
         case DEBUFF_STRENGTH:
-            target.getStatsRef().setStrength(target.getStats().getStrength() + magnitude);
+            target.setStrength(target.getStats().getStrength() + magnitude);
             break;
         case DEBUFF_DEXTERITY:
-            target.getStatsRef().setDexterity(target.getStats().getDexterity() + magnitude);
+            target.setDexterity(target.getStats().getDexterity() + magnitude);
             break;
         case DEBUFF_INTELLIGENCE:
-            target.getStatsRef().setIntelligence(target.getStats().getIntelligence() + magnitude);
+            target.setIntelligence(target.getStats().getIntelligence() + magnitude);
             break;
         case DEBUFF_MAX_HEALTH:
-            target.getStatsRef().setMaxHealth(target.getStats().getMaxHealth() + magnitude);
+            target.setMaxHealth(target.getStats().getMaxHealth() + magnitude);
             break;
         case DEBUFF_MAX_MANA:
-            target.getStatsRef().setMaxMana(target.getStats().getMaxMana() + magnitude);
+            target.setMaxMana(target.getStats().getMaxMana() + magnitude);
             break;
             
         // Crowd control effects
@@ -0,0 +1,80 @@
+#include "system_scheduler.h"
+#include <algorithm>
+#include <chrono>
+
+SystemScheduler::SystemScheduler() : wavesDirty(false), jobPool(nullptr), lastRunMs(0.0) {}
+
+size_t SystemScheduler::addSystem(const std::string& name, ResourceMask reads, ResourceMask writes,
+                                  SystemFunction function) {
+    systems.push_back(System{name, reads, writes, std::move(function)});
+
+    SystemTiming timing;
+    timing.name = name;
+    timings.push_back(timing);
+
+    wavesDirty = true;
+    return systems.size() - 1;
+}
+
+void SystemScheduler::clear() {
+    systems.clear();
+    waves.clear();
+    timings.clear();
+    wavesDirty = false;
+}
+
+bool SystemScheduler::conflicts(ResourceMask readsA, ResourceMask writesA, ResourceMask readsB, ResourceMask writesB) {
+    return (writesA & (readsB | writesB)) != 0 || (writesB & readsA) != 0;
+}
+
+size_t SystemScheduler::getWaveCount() {
+    if (wavesDirty) buildWaves();
+    return waves.size();
+}
+
+void SystemScheduler::buildWaves() {
+    // A system goes one wave after the latest earlier system it conflicts with
+    std::vector<size_t> waveOf(systems.size(), 0);
+    waves.clear();
+    for (size_t i = 0; i < systems.size(); ++i) {
+        size_t wave = 0;
+        for (size_t j = 0; j < i; ++j) {
+            if (conflicts(systems[i].reads, systems[i].writes, systems[j].reads, systems[j].writes)) {
+                wave = std::max(wave, waveOf[j] + 1);
+            }
+        }
+        waveOf[i] = wave;
+        if (wave >= waves.size()) waves.resize(wave + 1);
+        waves[wave].push_back(i);
+        timings[i].wave = wave;
+    }
+    wavesDirty = false;
+}
+
+void SystemScheduler::runSystem(size_t index, float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    systems[index].function(deltaTime);
+    timings[index].milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SystemScheduler::run(float deltaTime) {
+    if (wavesDirty) buildWaves();
+    auto start = std::chrono::steady_clock::now();
+
+    for (const std::vector<size_t>& wave : waves) {
+        if (jobPool && wave.size() > 1) {
+            jobPool->parallelFor(wave.size(), 1, [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    runSystem(wave[i], deltaTime);
+                }
+            });
+        } else {
+            for (size_t index : wave) {
+                runSystem(index, deltaTime);
+            }
+        }
+    }
+
+    lastRunMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,74 @@
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include "job_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// One bit per piece of shared state a system may read or write
+using ResourceMask = uint32_t;
+
+// Time one system took in the last run
+struct SystemTiming {
+    std::string name;
+    double milliseconds = 0.0;
+    size_t wave = 0;         // Systems in the same wave may have run at the same time
+};
+
+// Runs a frame's systems as a task graph. Each system declares the resources
+// it reads and writes. A system waits for every earlier system it conflicts
+// with (one writes what the other reads or writes), which keeps the result the
+// same as running them in registration order. Systems are grouped into waves
+// by that dependency depth; a wave's systems are independent and run
+// concurrently on the job pool.
+class SystemScheduler {
+public:
+    using SystemFunction = std::function<void(float deltaTime)>;
+
+private:
+    struct System {
+        std::string name;
+        ResourceMask reads;
+        ResourceMask writes;
+        SystemFunction function;
+    };
+
+    std::vector<System> systems;
+    std::vector<std::vector<size_t>> waves;  // Indices into systems, rebuilt when systems change
+    bool wavesDirty;
+    JobPool* jobPool;                        // Not owned; null runs systems on the calling thread
+
+    std::vector<SystemTiming> timings;       // Last run, in registration order
+    double lastRunMs;
+
+public:
+    SystemScheduler();
+
+    // Registers a system after all current ones and returns its index
+    size_t addSystem(const std::string& name, ResourceMask reads, ResourceMask writes,
+                     SystemFunction function);
+    void clear();
+
+    void setJobPool(JobPool* pool) { jobPool = pool; }
+    JobPool* getJobPool() const { return jobPool; }
+
+    // Runs every system once
+    void run(float deltaTime);
+
+    size_t getSystemCount() const { return systems.size(); }
+    size_t getWaveCount();
+    static bool conflicts(ResourceMask readsA, ResourceMask writesA, ResourceMask readsB, ResourceMask writesB);
+
+    // Per-system breakdown and wall time of the last run
+    const std::vector<SystemTiming>& getTimings() const { return timings; }
+    double getLastRunMs() const { return lastRunMs; }
+
+private:
+    void buildWaves();
+    void runSystem(size_t index, float deltaTime);
+};
+
+#endif // SYSTEM_SCHEDULER_H
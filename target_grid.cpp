@@ -0,0 +1,127 @@
+#include "target_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Cells allowed per target before the cell edge grows to fit, so a few
+    // far-flung targets cannot blow up the grid
+    const double MAX_CELLS_PER_TARGET = 4.0;
+    const double MIN_CELLS = 64.0;
+}
+
+TargetGrid::TargetGrid(double cellSize) : originX(0.0), originY(0.0), width(0), height(0) {
+    setCellSize(cellSize);
+}
+
+void TargetGrid::setCellSize(double size) {
+    cellSize = size > 0.0 ? size : DEFAULT_CELL_SIZE;
+    builtCellSize = cellSize;
+    invCellSize = 1.0 / cellSize;
+}
+
+void TargetGrid::clear() {
+    pointX.clear();
+    pointY.clear();
+    pointZ.clear();
+    pointCell.clear();
+    sortedIds.clear();
+    width = 0;
+    height = 0;
+}
+
+uint32_t TargetGrid::add(const Position& position) {
+    pointX.push_back(position.getX());
+    pointY.push_back(position.getY());
+    pointZ.push_back(position.getZ());
+    return static_cast<uint32_t>(pointX.size() - 1);
+}
+
+int TargetGrid::toCell(double coordinate, double origin) const {
+    return static_cast<int>(std::floor((coordinate - origin) * invCellSize));
+}
+
+void TargetGrid::build() {
+    const size_t count = pointX.size();
+    if (count == 0) return;
+
+    double minX = pointX[0], maxX = pointX[0];
+    double minY = pointY[0], maxY = pointY[0];
+    for (size_t id = 1; id < count; ++id) {
+        minX = std::min(minX, pointX[id]);
+        maxX = std::max(maxX, pointX[id]);
+        minY = std::min(minY, pointY[id]);
+        maxY = std::max(maxY, pointY[id]);
+    }
+
+    // Grow the cell edge until the grid fits the cell budget
+    double maxCells = std::max(MIN_CELLS, MAX_CELLS_PER_TARGET * count);
+    builtCellSize = cellSize;
+    double cellsX = std::floor((maxX - minX) / builtCellSize) + 1.0;
+    double cellsY = std::floor((maxY - minY) / builtCellSize) + 1.0;
+    while (cellsX * cellsY > maxCells) {
+        builtCellSize *= std::sqrt(cellsX * cellsY / maxCells) * 1.01;
+        cellsX = std::floor((maxX - minX) / builtCellSize) + 1.0;
+        cellsY = std::floor((maxY - minY) / builtCellSize) + 1.0;
+    }
+    invCellSize = 1.0 / builtCellSize;
+    originX = minX;
+    originY = minY;
+    width = static_cast<int>(cellsX);
+    height = static_cast<int>(cellsY);
+    size_t cells = static_cast<size_t>(width) * height;
+
+    // Counting sort: histogram, exclusive prefix sum, scatter. Ids go in
+    // ascending, so each cell's run is sorted too.
+    pointCell.resize(count);
+    cellStart.assign(cells + 1, 0);
+    for (size_t id = 0; id < count; ++id) {
+        int cellX = std::min(toCell(pointX[id], originX), width - 1);
+        int cellY = std::min(toCell(pointY[id], originY), height - 1);
+        uint32_t cell = static_cast<uint32_t>(cellY * width + cellX);
+        pointCell[id] = cell;
+        cellStart[cell + 1]++;
+    }
+    for (size_t cell = 0; cell < cells; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    sortedIds.resize(count);
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t id = 0; id < count; ++id) {
+        sortedIds[cellCursor[pointCell[id]]++] = static_cast<uint32_t>(id);
+    }
+}
+
+void TargetGrid::query(const Position& center, double radius, std::vector<uint32_t>& out) const {
+    if (sortedIds.empty()) return;
+
+    // Compare in floating point first so a huge reach cannot overflow the casts
+    double lowX = std::floor((center.getX() - radius - originX) * invCellSize);
+    double highX = std::floor((center.getX() + radius - originX) * invCellSize);
+    double lowY = std::floor((center.getY() - radius - originY) * invCellSize);
+    double highY = std::floor((center.getY() + radius - originY) * invCellSize);
+    if (highX < 0.0 || highY < 0.0 || lowX >= width || lowY >= height) return;
+    int minX = static_cast<int>(std::max(lowX, 0.0));
+    int minY = static_cast<int>(std::max(lowY, 0.0));
+    int maxX = static_cast<int>(std::min(highX, width - 1.0));
+    int maxY = static_cast<int>(std::min(highY, height - 1.0));
+
+    // The covered cells of one row are adjacent, so each row is one run
+    size_t first = out.size();
+    for (int cellY = minY; cellY <= maxY; ++cellY) {
+        size_t row = static_cast<size_t>(cellY) * width;
+        out.insert(out.end(), sortedIds.begin() + cellStart[row + minX],
+                   sortedIds.begin() + cellStart[row + maxX + 1]);
+    }
+
+    // Runs are sorted only within a cell; candidate lists are short, so insertion sort
+    for (size_t i = first + 1; i < out.size(); ++i) {
+        uint32_t id = out[i];
+        size_t j = i;
+        while (j > first && out[j - 1] > id) {
+            out[j] = out[j - 1];
+            --j;
+        }
+        out[j] = id;
+    }
+}
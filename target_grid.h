@@ -0,0 +1,63 @@
+#ifndef TARGET_GRID_H
+#define TARGET_GRID_H
+
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Point grid over the XY plane, rebuilt from scratch every frame for the
+// projectile hit pass. Targets move every tick, so rather than updating
+// cells incrementally like SpatialHash, build() counting-sorts all points
+// into a dense grid over their bounding box in two linear passes with no
+// per-cell allocation. Cells are stored row by row, so the cells a query
+// covers in one row are a single run of ids.
+// Targets are numbered in the order they were added; queries return those
+// ids in ascending order so callers see them in the same order a full scan
+// would.
+class TargetGrid {
+public:
+    static constexpr double DEFAULT_CELL_SIZE = 4.0;
+
+private:
+    double cellSize;           // Requested cell edge
+    double builtCellSize;      // Edge used by the last build, larger for sparse worlds
+    double invCellSize;
+    double originX, originY;   // Corner of cell (0, 0)
+    int width, height;         // In cells
+
+    // Per target, indexed by id
+    std::vector<double> pointX, pointY, pointZ;
+    std::vector<uint32_t> pointCell;
+
+    // Ids grouped by cell: cell c holds sortedIds[cellStart[c] .. cellStart[c + 1])
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> sortedIds;
+    std::vector<uint32_t> cellCursor;  // Scatter position per cell during build()
+
+public:
+    explicit TargetGrid(double cellSize = DEFAULT_CELL_SIZE);
+
+    void setCellSize(double size);
+    double getCellSize() const { return cellSize; }
+
+    // Start a new frame: drop all targets
+    void clear();
+    // Returns the new target's id
+    uint32_t add(const Position& position);
+    // Buckets the targets added since clear(); call before querying
+    void build();
+
+    // Every target within radius of center in the XY plane is returned,
+    // plus some that are not; callers run their exact test on each. Ids are
+    // appended to out in ascending order.
+    void query(const Position& center, double radius, std::vector<uint32_t>& out) const;
+
+    size_t size() const { return pointX.size(); }
+    Position getPosition(uint32_t id) const { return Position(pointX[id], pointY[id], pointZ[id]); }
+
+private:
+    int toCell(double coordinate, double origin) const;
+};
+
+#endif // TARGET_GRID_H
@@ -0,0 +1,640 @@
+#include "gameengine.h"
+#include "world_host.h"
+#include "job_pool.h"
+#include "projectile_pool.h"
+#include "target_grid.h"
+#include "projectile_sweep.h"
+#include "ability.h"
+#include "character.h"
+#include "class.h"
+#include "race.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    std::cout << "=== Game Engine Test ===" << std::endl;
+
+    int failures = 0;
+    auto check = [&failures](bool condition, const std::string& label) {
+        std::cout << (condition ? "PASS: " : "FAIL: ") << label << std::endl;
+        if (!condition) failures++;
+    };
+
+    // Test the fixed-step accumulator: whole ticks are run, the remainder is
+    // carried as the interpolation alpha and hitches are clamped
+    std::cout << "\n=== Fixed Timestep Test ===" << std::endl;
+    {
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        engine.setTickRate(50.0f);
+        engine.setMaxSubsteps(4);
+
+        check(engine.advance(0.05f) == 2 && engine.getTickCount() == 2, "a frame of 2.5 ticks runs 2 ticks");
+        check(std::abs(engine.getInterpolationAlpha() - 0.5f) < 1e-3f, "the half tick left over is the alpha");
+        check(engine.advance(0.015f) == 1 && std::abs(engine.getInterpolationAlpha() - 0.25f) < 1e-3f,
+              "the remainder carries into the next frame");
+        check(engine.advance(0.001f) == 0 && engine.getTickCount() == 3, "frames shorter than a tick run none");
+
+        uint64_t before = engine.getTickCount();
+        int ticks = engine.advance(1.0f);
+        check(ticks == 4 && engine.getTickCount() == before + 4, "a hitch runs at most maxSubsteps ticks");
+        check(engine.getDroppedTime() > 0.9 && engine.getDroppedTime() < 1.0, "the whole ticks past the clamp are dropped");
+        check(engine.getInterpolationAlpha() >= 0.0f && engine.getInterpolationAlpha() < 1.0f,
+              "alpha stays below one tick after a hitch");
+        check(engine.advance(0.0f) == 0, "dropped time is not run on the next frame");
+
+        engine.setTickRate(25.0f);
+        check(engine.getInterpolationAlpha() >= 0.0f && engine.getInterpolationAlpha() < 1.0f,
+              "changing the tick rate keeps less than one tick banked");
+
+        GameEngine variable(60.0f, false, EngineMode::HEADLESS);
+        check(variable.advance(0.5f) == 1 && variable.getInterpolationAlpha() == 1.0f,
+              "without a fixed timestep every frame is one update");
+    }
+
+    // Test the frame time histogram buckets and percentiles
+    std::cout << "\n=== Frame Time Histogram Test ===" << std::endl;
+    {
+        FrameTimeHistogram histogram(1.0, 10.0);
+        histogram.record(0.5);
+        histogram.record(1.5);
+        histogram.record(2.5);
+        histogram.record(50.0);
+        check(histogram.getCount() == 4 && histogram.getMax() == 50.0, "every sample is counted and the max is exact");
+        check(histogram.getBuckets().back() == 1, "samples past the range land in the overflow bucket");
+        check(histogram.getPercentile(0.5) == 2.0, "percentiles report the upper edge of their bucket");
+        check(histogram.getPercentile(1.0) == 50.0, "the top percentile is the exact max");
+        check(histogram.countAbove(2.0) == 2, "countAbove counts whole buckets above the value");
+        histogram.clear();
+        check(histogram.getCount() == 0 && histogram.getPercentile(0.99) == 0.0, "clear empties the histogram");
+    }
+
+    // Test the frame limiter: waits never return early, deadlines do not
+    // drift, and a long frame resynchronises instead of bursting
+    std::cout << "\n=== Frame Pacer Test ===" << std::endl;
+    {
+        using Clock = FramePacer::Clock;
+        FramePacer pacer(200.0f);
+        double period = pacer.getFramePeriod();
+        check(std::abs(period - 0.005) < 1e-6, "the period is one over the target rate");
+
+        const int frames = 20;
+        pacer.start();
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < frames; i++) {
+            pacer.waitForNextFrame();
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        check(elapsed >= (frames - 1) * period, "waits do not return before their deadline");
+        check(elapsed < (frames + 2) * period, "deadlines advance by whole periods without drift");
+        check(pacer.getFrameTimeHistogram().getCount() == static_cast<uint64_t>(frames), "every frame is recorded");
+
+        pacer.resetStats();
+        std::this_thread::sleep_for(std::chrono::duration<double>(period * 3.0));
+        float overrun = pacer.waitForNextFrame();
+        check(overrun >= 3.0f * period, "a long frame reports its whole length");
+        check(pacer.getMissedDeadlines() == 1 && pacer.getResyncs() == 1 && pacer.getLoad() >= 3.0,
+              "a frame over a period late is a missed deadline and a resync");
+
+        start = Clock::now();
+        pacer.waitForNextFrame();
+        double next = std::chrono::duration<double>(Clock::now() - start).count();
+        check(next >= period * 0.5 && pacer.getMissedDeadlines() == 1,
+              "after a resync the next frame waits instead of catching up");
+    }
+
+    // Test the adaptive tick rate: sustained overload lowers it towards the
+    // minimum, sustained headroom raises it back to the nominal rate
+    std::cout << "\n=== Adaptive Tick Rate Test ===" << std::endl;
+    {
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        engine.setTickRate(60.0f);
+        engine.adaptTickRate(2.0);
+        check(engine.getTickRate() > 59.99f, "the rate does not adapt until enabled");
+
+        engine.setAdaptiveTickRate(true, 30.0f);
+        for (int i = 0; i < 29; i++) engine.adaptTickRate(1.0);
+        check(engine.getTickRate() > 59.99f, "brief overload does not lower the rate");
+        engine.adaptTickRate(1.0);
+        check(engine.getTickRate() < 55.0f, "sustained overload lowers the rate");
+        for (int i = 0; i < 1000; i++) engine.adaptTickRate(1.0);
+        check(std::abs(engine.getTickRate() - 30.0f) < 1e-3f, "the rate stops at the minimum");
+
+        engine.adaptTickRate(0.7);
+        for (int i = 0; i < 119; i++) engine.adaptTickRate(0.1);
+        check(std::abs(engine.getTickRate() - 30.0f) < 1e-3f, "brief headroom does not raise the rate");
+        engine.adaptTickRate(0.1);
+        check(engine.getTickRate() > 33.0f, "sustained headroom raises the rate");
+        for (int i = 0; i < 5000; i++) engine.adaptTickRate(0.1);
+        check(std::abs(engine.getTickRate() - 60.0f) < 1e-3f, "the rate climbs back no higher than nominal");
+
+        for (int i = 0; i < 30; i++) engine.adaptTickRate(1.0);
+        engine.setAdaptiveTickRate(false);
+        check(std::abs(engine.getTickRate() - 60.0f) < 1e-3f, "disabling restores the nominal rate");
+    }
+
+    // Test headless mode: no local player, and runTicks advances the world
+    // by whole fixed ticks, flat out or paced to the tick rate
+    std::cout << "\n=== Headless Test ===" << std::endl;
+    {
+        GameEngine engine(20.0f, true, EngineMode::HEADLESS);
+        check(engine.isHeadless() && !engine.hasPlayerController(), "headless engines have no player controller");
+
+        // Adds up the simulated time each tick hands the systems
+        double simulated = 0.0;
+        engine.getScheduler().addSystem("clock", 0, 0, [&simulated](float deltaTime) { simulated += deltaTime; });
+        double rate = engine.runTicks(20);
+        check(engine.getIsRunning() && engine.getTickCount() == 20 && rate > 0.0,
+              "runTicks initializes the engine and runs every tick");
+        check(std::abs(simulated - 1.0) < 1e-5, "20 ticks at 20 Hz simulate one second");
+
+        engine.setTickRate(200.0f);
+        engine.setHeadlessPaced(true);
+        auto start = std::chrono::steady_clock::now();
+        engine.runTicks(10);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        check(engine.getTickCount() == 30 && elapsed >= 9 * 0.005, "paced runs wait out each tick period");
+        check(engine.getTicksPerSecond() <= 200.0 * 1.05, "paced runs hold the tick rate");
+    }
+
+    // Test the world host: worlds at different tick rates each run their own
+    // ticks and stay level in simulated time, with or without a job pool
+    std::cout << "\n=== World Host Test ===" << std::endl;
+    {
+        JobPool pool(2);
+        for (JobPool* jobPool : {static_cast<JobPool*>(nullptr), &pool}) {
+            std::string name = jobPool ? "pooled" : "serial";
+            WorldHost host(jobPool, 60.0f);
+            const float rates[] = {30.0f, 60.0f, 120.0f};
+            double simulated[3] = {0.0, 0.0, 0.0};
+            for (size_t i = 0; i < 3; i++) {
+                GameEngine& world = host.getWorld(host.createWorld(rates[i]));
+                double& clock = simulated[i];
+                world.getScheduler().addSystem("clock", 0, 0, [&clock](float deltaTime) { clock += deltaTime; });
+            }
+            size_t paused = host.createWorld(60.0f);
+            host.getWorld(paused).pause();
+
+            for (int i = 0; i < 6; i++) {
+                host.tick();
+            }
+            check(host.getTickCount() == 6, name + ": every host tick is counted");
+            check(host.getWorld(0).getTickCount() == 3 && host.getWorld(1).getTickCount() == 6 &&
+                  host.getWorld(2).getTickCount() == 12, name + ": each world ticks at its own rate");
+            bool level = true;
+            for (size_t i = 0; i < 3; i++) {
+                level = level && std::abs(simulated[i] - 0.1) < 1e-5;
+            }
+            check(level, name + ": worlds at different rates cover the same simulated time");
+            check(host.getWorld(paused).getTickCount() == 0, name + ": paused worlds do not tick");
+
+            // Tick lengths need not divide the host step; the remainder stays banked
+            host.setTickRate(20.0f);
+            check(host.runTicks(5) > 0.0, name + ": runTicks reports the world ticks per second");
+            level = true;
+            for (size_t i = 0; i < 3; i++) {
+                level = level && std::abs(simulated[i] - 0.35) < 1.0 / rates[i];
+            }
+            check(level, name + ": worlds keep level after the host step changes");
+        }
+    }
+
+    // Test the system scheduler: conflicting systems keep registration order,
+    // independent ones share a wave, and a job pool does not change results
+    std::cout << "\n=== System Scheduler Test ===" << std::endl;
+    {
+        const ResourceMask A = 1u << 0, B = 1u << 1, C = 1u << 2;
+        check(!SystemScheduler::conflicts(A, 0, A, 0), "two readers do not conflict");
+        check(SystemScheduler::conflicts(0, A, A, 0) && SystemScheduler::conflicts(A, 0, 0, A),
+              "a writer conflicts with a reader either way round");
+        check(SystemScheduler::conflicts(0, A, 0, A), "two writers conflict");
+        check(!SystemScheduler::conflicts(A, B, C, C), "disjoint resources do not conflict");
+
+        JobPool pool(2);
+        for (JobPool* jobPool : {static_cast<JobPool*>(nullptr), &pool}) {
+            std::string name = jobPool ? "pooled" : "serial";
+            SystemScheduler scheduler;
+            scheduler.setJobPool(jobPool);
+            int a = 0, b = 0, sum = 0, product = 0;
+            scheduler.addSystem("write a", 0, A, [&](float) { a = 2; });
+            scheduler.addSystem("write b", 0, B, [&](float) { b = 3; });
+            scheduler.addSystem("sum", A | B, C, [&](float) { sum = a + b; });
+            scheduler.addSystem("scale a", C, A, [&](float) { a *= sum; });
+            scheduler.addSystem("product", A | B, 0, [&](float) { product = a * b; });
+
+            check(scheduler.getWaveCount() == 4, name + ": waves follow the longest chain of conflicts");
+            scheduler.run(0.0f);
+            const std::vector<SystemTiming>& timings = scheduler.getTimings();
+            check(timings[0].wave == 0 && timings[1].wave == 0, name + ": independent writers share the first wave");
+            check(timings[2].wave == 1 && timings[3].wave == 2 && timings[4].wave == 3,
+                  name + ": each system runs after the systems it conflicts with");
+            check(sum == 5 && a == 10 && product == 30, name + ": results match registration order");
+            check(timings.size() == 5 && timings[2].name == "sum", name + ": timings are kept in registration order");
+
+            scheduler.clear();
+            check(scheduler.getSystemCount() == 0 && scheduler.getWaveCount() == 0, name + ": clear removes every system");
+        }
+
+        // Physics touches nothing the gameplay systems do, so it shares the first wave
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        engine.tick();
+        const std::vector<SystemTiming>& timings = engine.getSystemTimings();
+        check(!timings.empty() && timings[0].name == "physics" && timings[0].wave == 0 && timings[1].wave == 0,
+              "the engine runs physics alongside the first gameplay system");
+        check(timings.size() == 5 && timings[3].wave == timings[4].wave && timings[3].wave > timings[2].wave,
+              "character and mob status effects run together after projectiles");
+    }
+
+    // Test entity handles and the name index: lookups stay O(1) and exact,
+    // and handles to removed entities never resolve, even once their slot is reused
+    std::cout << "\n=== Entity Handle Test ===" << std::endl;
+    {
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        CharacterHandle ayla = engine.addCharacter(Character("Ayla", Race::createHuman(), Class::createWarrior()));
+        CharacterHandle borin = engine.addCharacter(Character("Borin", Race::createHuman(), Class::createWarrior()));
+        Character* borinBefore = engine.getCharacter(borin);
+
+        check(engine.getCharacter("Ayla") == engine.getCharacter(ayla) && engine.findCharacter("Borin") == borin,
+              "names resolve to their character's handle");
+        check(engine.getCharacter("Nobody") == nullptr && !engine.findCharacter("Nobody").isValid(),
+              "unknown names resolve to nothing");
+
+        CharacterHandle twin = engine.addCharacter(Character("Ayla", Race::createHuman(), Class::createWarrior()));
+        check(engine.findCharacter("Ayla") == ayla && engine.getCharacter(twin) != nullptr,
+              "a taken name keeps pointing at the first character");
+        for (int i = 0; i < 64; i++) {
+            engine.addCharacter(Character("Extra" + std::to_string(i), Race::createHuman(), Class::createWarrior()));
+        }
+        check(engine.getCharacter(borin) == borinBefore, "adding characters does not move the others");
+
+        check(engine.removeCharacter(ayla), "removing a live character succeeds");
+        check(engine.getCharacter(ayla) == nullptr && engine.getCharacter("Ayla") == nullptr,
+              "a removed character's handle and name no longer resolve");
+        check(!engine.removeCharacter(ayla), "removing through a stale handle fails");
+        check(engine.getCharacter(borin) == borinBefore && engine.getCharacter(twin)->getName() == "Ayla",
+              "removal leaves other handles valid");
+
+        CharacterHandle reused = engine.addCharacter(Character("Cara", Race::createHuman(), Class::createWarrior()));
+        check(reused.index == ayla.index && reused.generation != ayla.generation && engine.getCharacter(ayla) == nullptr,
+              "a reused slot does not revive the old handle");
+
+        MobHandle wolf = engine.addMob(Mob(Race::createBeast()));
+        MobHandle bear = engine.addMob(Mob(Race::createBeast()));
+        check(engine.removeMob(wolf) && engine.getMob(wolf) == nullptr && engine.getMob(bear) != nullptr,
+              "mob handles go stale on removal and no sooner");
+        check(engine.getMobCount() == 1 && engine.getMob(size_t(0)) == engine.getMob(bear),
+              "the survivor fills the gap in iteration order");
+    }
+
+    // Test the entity store: archetype columns, generational ids and
+    // swap-and-pop removal
+    std::cout << "\n=== Entity Store Test ===" << std::endl;
+    {
+        EntityStore store;
+        const ComponentMask moving = Component::TRANSFORM | Component::VELOCITY;
+        EntityId first = store.create(moving);
+        EntityId second = store.create(moving);
+        EntityId still = store.create(Component::TRANSFORM);
+        *store.getPosition(second) = Position(2.0, 0.0, 0.0);
+        *store.getVelocity(second) = Position(0.0, 1.0, 0.0);
+
+        check(store.size() == 3 && store.getArchetypeCount() == 2, "entities group by component mask");
+        check(store.getVelocity(still) == nullptr && store.getVitals(first) == nullptr,
+              "components outside the mask are not there");
+        check(store.destroy(first) && !store.isAlive(first) && store.getPosition(first) == nullptr,
+              "destroyed ids no longer resolve");
+        check(store.getPosition(second)->getX() == 2.0 && store.getVelocity(second)->getY() == 1.0,
+              "the row moved into the gap keeps its components");
+        EntityId reused = store.create(moving);
+        check(reused.index == first.index && !store.isAlive(first) && store.isAlive(reused),
+              "a reused id slot does not revive the old id");
+
+        store.setMask(second, Component::TRANSFORM | Component::VITALS);
+        check(store.getPosition(second)->getX() == 2.0 && store.getVelocity(second) == nullptr &&
+              store.getVitals(second) != nullptr, "changing the mask keeps shared components");
+        size_t sweeps = 0;
+        store.forEachArchetype(Component::TRANSFORM, [&sweeps](Archetype& archetype) { sweeps += archetype.size(); });
+        check(sweeps == 3, "archetype iteration visits every entity with the components");
+    }
+
+    // Test the Character and Mob façades: once added, hot state lives in the
+    // store, and copies come out detached with the current values
+    std::cout << "\n=== Entity Facade Test ===" << std::endl;
+    {
+        GameEngine engine(60.0f, true, EngineMode::HEADLESS);
+        EntityStore& store = engine.getEntityStore();
+        CharacterHandle hero = engine.addCharacter(Character("Hero", Race::createHuman(), Class::createWarrior()));
+        Character& attached = *engine.getCharacter(hero);
+        check(attached.isAttached() && store.size() == 1, "added characters are attached to the store");
+
+        welltype fullHealth = attached.getStats().getHealth();
+        attached.damage(10);
+        attached.setPosition(3.0, 4.0, 0.0);
+        check(store.getVitals(attached.getEntityId())->health == fullHealth - 10 &&
+              store.getPosition(attached.getEntityId())->getX() == 3.0, "façade writes land in the store");
+        store.getVitals(attached.getEntityId())->health -= 5;
+        check(attached.getStats().getHealth() == fullHealth - 15, "getStats reads health back from the store");
+
+        StatBlock& stats = attached.getStatsRef();
+        check(stats.getHealth() == fullHealth - 15, "getStatsRef pulls the store's vitals first");
+        attached.setMaxHealth(fullHealth + 20);
+        check(store.getVitals(attached.getEntityId())->maxHealth == fullHealth + 20, "max health setters write through");
+
+        Character copy = attached;
+        check(!copy.isAttached() && copy.getStats().getHealth() == fullHealth - 15 && copy.getPosition().getX() == 3.0,
+              "copies start detached with the current hot state");
+        copy.damage(20);
+        copy.setPosition(9.0, 0.0, 0.0);
+        check(attached.getStats().getHealth() == fullHealth - 15 && attached.getPosition().getX() == 3.0,
+              "changing a detached copy leaves the entity alone");
+
+        MobHandle beast = engine.addMob(Mob(Race::createBeast()));
+        Mob& mob = *engine.getMob(beast);
+        mob.setStunned(true);
+        check((*store.getStatus(mob.getEntityId()) & StatusFlag::STUNNED) != 0 && mob.getIsStunned(),
+              "crowd control flags live in the store");
+        check(store.size() == 2 && engine.removeMob(beast) && store.size() == 1, "removing an entity frees its row");
+        check(engine.removeCharacter(hero) && store.size() == 0, "every row is gone once the entities are");
+    }
+
+    // Test the movement system: every mobile entity advances by its velocity,
+    // stunned and rooted ones stay put
+    std::cout << "\n=== Movement Test ===" << std::endl;
+    {
+        GameEngine engine(10.0f, true, EngineMode::HEADLESS);
+        CharacterHandle runner = engine.addCharacter(Character("Runner", Race::createHuman(), Class::createWarrior()));
+        CharacterHandle rooted = engine.addCharacter(Character("Rooted", Race::createHuman(), Class::createWarrior()));
+        MobHandle wolf = engine.addMob(Mob(Race::createBeast()));
+        MobHandle stunned = engine.addMob(Mob(Race::createBeast()));
+        engine.getCharacter(runner)->setVelocity(Position(2.0, 0.0, 0.0));
+        engine.getCharacter(rooted)->setVelocity(Position(2.0, 0.0, 0.0));
+        engine.getCharacter(rooted)->setRooted(true);
+        engine.getMob(wolf)->setPosition(5.0, 5.0, 0.0);
+        engine.getMob(wolf)->setVelocity(Position(0.0, -1.0, 0.5));
+        engine.getMob(stunned)->setVelocity(Position(1.0, 0.0, 0.0));
+        engine.getMob(stunned)->setStunned(true);
+
+        engine.runTicks(5);
+        check(engine.getCharacter(runner)->getPosition().distanceTo(Position(1.0, 0.0, 0.0)) < 1e-6,
+              "characters move by their velocity each tick");
+        check(engine.getMob(wolf)->getPosition().distanceTo(Position(5.0, 4.5, 0.25)) < 1e-6,
+              "mobs move by their velocity each tick");
+        check(engine.getCharacter(rooted)->getPosition().distanceTo(Position(0.0, 0.0, 0.0)) == 0.0 &&
+              engine.getMob(stunned)->getPosition().distanceTo(Position(0.0, 0.0, 0.0)) == 0.0,
+              "rooted and stunned entities stay put");
+
+        engine.getCharacter(rooted)->setRooted(false);
+        engine.runTicks(5);
+        check(engine.getCharacter(rooted)->getPosition().distanceTo(Position(1.0, 0.0, 0.0)) < 1e-6,
+              "entities move again once freed");
+    }
+
+    // Test the projectile pool: ids resolve to their dense index, removal
+    // packs the columns, freed slots are reused and stale ids never resolve
+    std::cout << "\n=== Projectile Pool Test ===" << std::endl;
+    {
+        ProjectilePool pool(3);
+        ProjectileId first = pool.spawn(ProjectileInstance(Position(1.0, 0.0, 1.0), Position(1.0, 0.0, 0.0), nullptr, nullptr));
+        ProjectileId second = pool.spawn(ProjectileInstance(Position(2.0, 0.0, 1.0), Position(1.0, 0.0, 0.0), nullptr, nullptr));
+        ProjectileId third = pool.spawn(ProjectileInstance(Position(3.0, 0.0, 1.0), Position(1.0, 0.0, 0.0), nullptr, nullptr));
+        check(pool.size() == 3 && pool.indexOf(first) == 0 && pool.indexOf(third) == 2 && pool.idAt(1) == second,
+              "ids map to dense indices in spawn order");
+        check(pool.isFull() && !pool.spawn(ProjectileInstance(Position(), Position(), nullptr, nullptr)).isValid(),
+              "a full pool hands out an invalid id");
+
+        check(pool.remove(first) && pool.size() == 2, "removing a live projectile succeeds");
+        check(pool.indexOf(third) == 0 && pool.positionX[0] == 3.0 && pool.indexOf(second) == 1,
+              "the last projectile moves into the gap");
+        check(!pool.isAlive(first) && !pool.remove(first), "a removed id no longer resolves");
+
+        ProjectileId reused = pool.spawn(ProjectileInstance(Position(4.0, 0.0, 1.0), Position(1.0, 0.0, 0.0), nullptr, nullptr));
+        check(reused.index == first.index && reused.generation != first.generation && !pool.isAlive(first) &&
+              pool.indexOf(reused) == 2, "a reused slot does not revive the old id");
+
+        pool.flags[pool.indexOf(second)] = ProjectileFlag::HIT;
+        check(pool.removeDead() == 1 && !pool.isAlive(second) && pool.isAlive(third) && pool.isAlive(reused),
+              "removeDead drops flagged projectiles only");
+        check(pool.get(pool.indexOf(reused)).currentPos.getX() == 4.0, "survivors keep their state through removal");
+
+        pool.reserve(8);
+        check(pool.getCapacity() == 8 && pool.isAlive(third) && pool.isAlive(reused), "reserve keeps ids valid");
+        pool.clear();
+        check(pool.size() == 0 && !pool.isAlive(third) && !pool.isAlive(reused), "clear invalidates every id");
+    }
+
+    // Test the target grid: a query returns every target within reach, in
+    // ascending id order, however the targets are spread
+    std::cout << "\n=== Target Grid Test ===" << std::endl;
+    {
+        TargetGrid grid(2.0);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> coordinate(-30.0, 30.0);
+        for (int i = 0; i < 400; i++) grid.add(Position(coordinate(rng), coordinate(rng), 0.0));
+        grid.add(Position(5000.0, -5000.0, 0.0));  // One far-flung target stretches the cells
+        grid.build();
+
+        bool complete = true, ascending = true;
+        std::vector<uint32_t> found;
+        for (int q = 0; q < 50; q++) {
+            Position center(coordinate(rng), coordinate(rng), 0.0);
+            double radius = 0.5 + q * 0.2;
+            found.clear();
+            grid.query(center, radius, found);
+            for (size_t i = 1; i < found.size(); i++) ascending = ascending && found[i - 1] < found[i];
+            for (uint32_t id = 0; id < grid.size(); id++) {
+                Position target = grid.getPosition(id);
+                double dx = target.getX() - center.getX(), dy = target.getY() - center.getY();
+                if (dx * dx + dy * dy <= radius * radius &&
+                    std::find(found.begin(), found.end(), id) == found.end()) {
+                    complete = false;
+                }
+            }
+        }
+        check(complete, "every target within reach is returned");
+        check(ascending, "ids come back ascending with no repeats");
+
+        found.clear();
+        grid.query(Position(5000.0, -5000.0, 0.0), 1.0, found);
+        check(found.size() == 1 && found[0] == 400, "an outlying target is still found");
+        found.clear();
+        grid.query(Position(-9000.0, 9000.0, 0.0), 1.0, found);
+        check(found.empty(), "a query off the grid finds nothing");
+
+        grid.clear();
+        uint32_t only = grid.add(Position(1.0, 1.0, 0.0));
+        grid.build();
+        found.assign(1, 99);
+        grid.query(Position(1.0, 1.0, 0.0), 0.5, found);
+        check(only == 0 && found.size() == 2 && found[0] == 99 && found[1] == 0,
+              "ids restart after clear and results are appended");
+    }
+
+    // Test the swept sphere test: it reports the fraction of the step at
+    // first contact, or no hit when the segment never reaches the sphere
+    std::cout << "\n=== Swept Hit Test ===" << std::endl;
+    {
+        Position start(0.0, 0.0, 0.0), end(10.0, 0.0, 0.0);
+        check(std::abs(sweepSphere(start, end, Position(5.0, 0.0, 0.0), 1.0) - 0.4) < 1e-12,
+              "a head-on pass touches at the near edge");
+        check(std::abs(sweepSphere(start, end, Position(5.0, 0.6, 0.0), 1.0) - 0.42) < 1e-12,
+              "an offset pass touches where the chord begins");
+        check(sweepSphere(start, end, Position(0.5, 0.0, 0.0), 1.0) == 0.0, "starting inside touches at 0");
+        check(sweepSphere(start, end, Position(5.0, 1.5, 0.0), 1.0) == NO_SWEEP_HIT &&
+              sweepSphere(start, end, Position(11.5, 0.0, 0.0), 1.0) == NO_SWEEP_HIT &&
+              sweepSphere(end, start, Position(11.5, 0.0, 0.0), 1.0) == NO_SWEEP_HIT,
+              "passing wide, stopping short and moving away all miss");
+    }
+
+    // Test that a lobbed shot lands on the same target whatever the tick
+    // rate: the step it hits the ground on is swept up to the impact point
+    std::cout << "\n=== Grounded Sweep Test ===" << std::endl;
+    {
+        Ability bolt("Bolt", "", PHYSICAL, 5, 0, 0, 0, 30, PROJECTILE, DAMAGE, ACTIVE, PROJECTILE_CAST, SINGLE_TARGET, 30.0f, 0.0f);
+        double impact[2] = {-1.0, -1.0};
+        const float rates[2] = {20.0f, 60.0f};
+        for (int r = 0; r < 2; r++) {
+            SlotMap<Character> characters;
+            SlotMap<Mob> mobs;
+            CharacterHandle archer = characters.emplace("Archer", Race::createHuman(), Class::createWarrior());
+            Mob target(Race::createGoblin());
+            target.setPosition(14.0, 0.0, 0.0);
+            mobs.insert(target);
+
+            ProjectileManager manager;
+            ProjectileInstance arrow(Position(0.0, 0.0, 0.9), Position(30.0, 0.0, 0.0), &bolt, characters.get(archer), 5.0f);
+            arrow.gravity = 9.8f;
+            manager.spawnProjectile(arrow);
+            const float deltaTime = 1.0f / rates[r];
+            for (int tick = 0; manager.getProjectileCount() > 0; tick++) {
+                manager.updateProjectiles(deltaTime, characters, mobs);
+                for (const ProjectileHit& hit : manager.getLastHits()) {
+                    if (hit.isMob) impact[r] = tick * deltaTime + hit.time;
+                }
+            }
+        }
+        check(impact[0] > 0.0 && impact[1] > 0.0, "the shot hits the mob it lands beside at 20 Hz and 60 Hz");
+        check(impact[0] > 0.0 && std::abs(impact[0] - impact[1]) < 5e-3, "both rates report about the same impact time");
+    }
+
+    // Test the landing time solved at spawn against the arc integrated in
+    // small RK4 steps, with and without drag, and the arcs that never land
+    std::cout << "\n=== Ground Time Test ===" << std::endl;
+    {
+        struct Arc { double z, vz, gravity, drag; };
+        const Arc arcs[] = {
+            {2.0, 10.0, 9.8, 0.1}, {0.9, 0.0, 9.8, 0.0}, {5.0, -3.0, 9.8, 0.5},
+            {1.0, 20.0, 9.8, 2.0}, {1.0, -1.0, 0.0, 0.0}, {1.0, -1.0, 0.0, 0.5},
+        };
+        ProjectilePool pool(16);
+        bool matches = true;
+        for (const Arc& arc : arcs) {
+            ProjectileInstance projectile(Position(0.0, 0.0, arc.z), Position(3.0, 0.0, arc.vz), nullptr, nullptr, 20.0f);
+            projectile.gravity = static_cast<float>(arc.gravity);
+            projectile.drag = static_cast<float>(arc.drag);
+            float solved = pool.groundTime[pool.indexOf(pool.spawn(projectile))];
+
+            const double step = 1e-4;
+            double z = arc.z, vz = arc.vz, time = 0.0;
+            auto accel = [&arc](double v) { return -arc.gravity - arc.drag * v; };
+            while (z > 0.0) {
+                double k1z = vz, k1v = accel(vz);
+                double k2z = vz + 0.5 * step * k1v, k2v = accel(k2z);
+                double k3z = vz + 0.5 * step * k2v, k3v = accel(k3z);
+                double k4z = vz + step * k3v, k4v = accel(k4z);
+                double nextZ = z + step / 6.0 * (k1z + 2.0 * k2z + 2.0 * k3z + k4z);
+                vz += step / 6.0 * (k1v + 2.0 * k2v + 2.0 * k3v + k4v);
+                if (nextZ <= 0.0) {
+                    time += step * z / (z - nextZ);
+                    break;
+                }
+                z = nextZ;
+                time += step;
+            }
+            if (std::abs(solved - time) > 1e-4) {
+                std::cout << "  arc from z = " << arc.z << ": solved " << solved << ", stepped " << time << std::endl;
+                matches = false;
+            }
+        }
+        check(matches, "ground times match the stepped arcs");
+
+        ProjectileInstance level(Position(0.0, 0.0, 1.0), Position(5.0, 0.0, 0.0), nullptr, nullptr, 20.0f);
+        ProjectileInstance high(Position(0.0, 0.0, 100.0), Position(5.0, 0.0, 0.0), nullptr, nullptr, 1.0f);
+        high.gravity = 9.8f;
+        check(std::isinf(pool.groundTime[pool.indexOf(pool.spawn(level))]) &&
+              std::isinf(pool.groundTime[pool.indexOf(pool.spawn(high))]),
+              "arcs that never come down within their lifetime never ground");
+    }
+
+    // Test hits found on a job pool: they come out in the same order as a
+    // single-threaded update, and name their targets by handle, so they
+    // still point at the right entity after others are removed
+    std::cout << "\n=== Parallel Hits Test ===" << std::endl;
+    {
+        // Buffs, so applying the hits prints nothing
+        std::vector<Ability> abilities = {
+            Ability("Mark", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, BUFF, ACTIVE, PROJECTILE_CAST, SINGLE_TARGET, 30.0f, 0.0f),
+            Ability("Ward", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, BUFF, ACTIVE, PROJECTILE_CAST, CIRCLE, 30.0f, 2.0f),
+            Ability("Gust", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, BUFF, ACTIVE, PROJECTILE_CAST, CONE, 30.0f, 3.0f),
+            Ability("Beam", "", MAGICAL, 5, 0, 0, 0, 30, PROJECTILE, BUFF, ACTIVE, PROJECTILE_CAST, LINE, 30.0f, 4.0f),
+        };
+        SlotMap<Character> characters;
+        SlotMap<Mob> mobs;
+        CharacterHandle caster = characters.emplace("Caster", Race::createHuman(), Class::createMage());
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> coordinate(0.0, 200.0);
+        std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+        for (int i = 0; i < 300; i++) {
+            Mob mob(Race::createGoblin());
+            mob.setPosition(coordinate(rng), coordinate(rng), 1.0);
+            mobs.insert(mob);
+        }
+
+        JobPool jobPool(3);
+        ProjectileManager serial, pooled;
+        pooled.setJobPool(&jobPool);
+        for (ProjectileManager* manager : {&serial, &pooled}) manager->setCapacity(2000);
+        bool sameOrder = true;
+        size_t hitCount = 0;
+        std::vector<ProjectileHit> kept;
+        for (int tick = 0; tick < 10; tick++) {
+            while (serial.getProjectileCount() < 2000) {
+                double theta = angle(rng);
+                ProjectileInstance projectile(Position(coordinate(rng), coordinate(rng), 1.0),
+                                              Position(std::cos(theta) * 40.0, std::sin(theta) * 40.0, 0.0),
+                                              &abilities[rng() % abilities.size()], characters.get(caster), 100.0f);
+                serial.spawnProjectile(projectile);
+                pooled.spawnProjectile(projectile);
+            }
+            serial.updateProjectiles(1.0f / 20.0f, characters, mobs);
+            pooled.updateProjectiles(1.0f / 20.0f, characters, mobs);
+
+            const std::vector<ProjectileHit>& expected = serial.getLastHits();
+            const std::vector<ProjectileHit>& actual = pooled.getLastHits();
+            sameOrder = sameOrder && expected.size() == actual.size();
+            for (size_t i = 0; sameOrder && i < expected.size(); i++) {
+                sameOrder = expected[i].projectile == actual[i].projectile && expected[i].isMob == actual[i].isMob &&
+                            expected[i].character == actual[i].character && expected[i].mob == actual[i].mob &&
+                            expected[i].time == actual[i].time;
+            }
+            hitCount += expected.size();
+            if (kept.empty()) kept = expected;
+        }
+        check(hitCount > 100 && sameOrder, "pooled updates report the serial hits in the same order");
+
+        // Removing the first mob moves the last one into its dense index
+        MobHandle victim = kept.empty() ? MobHandle() : kept[0].mob;
+        const Mob* before = mobs.get(victim);
+        MobHandle first = mobs.handleAt(0);
+        check(before != nullptr && first != victim && mobs.erase(first) && mobs.get(victim) == before,
+              "a hit's target handle survives other entities being removed");
+        check(mobs.erase(victim) && mobs.get(victim) == nullptr, "a removed target's handle no longer resolves");
+    }
+
+    std::cout << "\n=== Test Complete ===" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,609 @@
+#include "physics_system.h"
+#include "spatial_hash.h"
+#include "job_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Counts heap allocations so the query tests can check that they make none
+static size_t allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+template <typename Check>
+void checkBroadphase(BroadphaseType type, const std::string& name, Check& check) {
+    std::cout << "\n=== Broadphase Test: " << name << " ===" << std::endl;
+    PhysicsSystem physics(type);
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f, Position(40.0, 40.0, 8.0));
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> coord(-5.0, 45.0);  // Some bodies leave the grid bounds
+    std::uniform_real_distribution<double> height(0.0, 8.0);
+    std::vector<std::shared_ptr<PhysicsBody>> bodies;
+    for (int i = 0; i < 400; i++) {
+        bodies.push_back(physics.createBody(Position(coord(rng), coord(rng), height(rng))));
+        if (i % 3 == 0) {
+            // Mix in boxes so every shape-pair batch is exercised
+            physics.setBodyShape(bodies.back()->handle, ColliderShape::box(Position(1.5, 0.5, 1.0)));
+        }
+    }
+
+    // Run a few steps so incremental broadphase state is exercised
+    for (int step = 0; step < 3; step++) {
+        for (auto& body : bodies) {
+            body->velocity = Position(coord(rng) * 0.1, coord(rng) * 0.1, 0.0);
+        }
+        physics.update(1.0f / 60.0f);
+    }
+    physics.updateSpatialGrid();
+    physics.buildCandidatePairs();
+    physics.detectCollisions();
+
+    std::set<std::pair<PhysicsBody*, PhysicsBody*>> candidates;
+    bool duplicatePairs = false;
+    for (const BodyPair& pair : physics.getCandidatePairs()) {
+        auto key = std::minmax(pair.first, pair.second);
+        if (!candidates.insert(key).second) duplicatePairs = true;
+    }
+
+    size_t bruteForceContacts = 0;
+    bool missedContact = false;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        for (size_t j = i + 1; j < bodies.size(); j++) {
+            if (physics.checkCollision(bodies[i].get(), bodies[j].get())) {
+                bruteForceContacts++;
+                if (!candidates.count(std::minmax(bodies[i].get(), bodies[j].get()))) missedContact = true;
+            }
+        }
+    }
+
+    const PhysicsStepStats& stats = physics.getLastStepStats();
+    std::cout << "Candidate pairs: " << stats.candidatePairs << " (brute force: "
+              << bodies.size() * (bodies.size() - 1) / 2 << ")" << std::endl;
+    std::cout << "Contacts: " << stats.contacts << " (brute force: " << bruteForceContacts << ")" << std::endl;
+    check(!duplicatePairs, "candidate pairs are unique");
+    check(!missedContact, "every overlapping pair is a candidate");
+    check(stats.contacts == bruteForceContacts, "contact count matches brute force");
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Physics System Test ===" << std::endl;
+
+    int failures = 0;
+    auto check = [&failures](bool condition, const std::string& label) {
+        std::cout << (condition ? "PASS: " : "FAIL: ") << label << std::endl;
+        if (!condition) failures++;
+    };
+
+    // Test both broadphases against a brute-force pair loop
+    checkBroadphase(BroadphaseType::UNIFORM_GRID, "Uniform Grid", check);
+    checkBroadphase(BroadphaseType::SORT_AND_SWEEP, "Sort and Sweep", check);
+
+    // Test the sparse grid over a kilometre-wide, mostly empty zone
+    std::cout << "\n=== Sparse Grid Test ===" << std::endl;
+    SpatialHash hash(10.0f);
+    std::mt19937 hashRng(99);
+    std::uniform_real_distribution<double> zone(-2500.0, 2500.0);
+    std::vector<Position> centers;
+    for (uint32_t id = 0; id < 2000; id++) {
+        centers.emplace_back(zone(hashRng), zone(hashRng), 0.0);
+        hash.insert(id, centers[id] - Position(1, 1, 1), centers[id] + Position(1, 1, 1));
+    }
+    for (uint32_t id = 0; id < 2000; id++) {
+        centers[id] = centers[id] + Position(zone(hashRng) * 0.01, zone(hashRng) * 0.01, 0.0);
+        hash.update(id, centers[id] - Position(1, 1, 1), centers[id] + Position(1, 1, 1));
+    }
+    for (uint32_t id = 0; id < 2000; id += 2) {
+        hash.remove(id);
+    }
+
+    bool registrationsConsistent = true;
+    for (uint32_t id = 0; id < 2000; id++) {
+        CellRange range = hash.getCellRange(centers[id] - Position(1, 1, 1), centers[id] + Position(1, 1, 1));
+        for (int x = range.minX; x <= range.maxX; x++) {
+            for (int y = range.minY; y <= range.maxY; y++) {
+                for (int z = range.minZ; z <= range.maxZ; z++) {
+                    const SpatialHash::Cell* cell = hash.findCell(x, y, z);
+                    bool listed = cell && std::find(cell->ids.begin(), cell->ids.end(), id) != cell->ids.end();
+                    if (listed != (id % 2 == 1)) registrationsConsistent = false;
+                }
+            }
+        }
+    }
+    std::cout << "Occupied cells: " << hash.getOccupiedCellCount()
+              << ", memory: " << hash.getMemoryUsage() / 1024 << " KiB" << std::endl;
+    check(registrationsConsistent, "moved and removed proxies are listed in exactly their cells");
+    check(hash.getOccupiedCellCount() <= 1000 * 8, "only occupied cells are stored");
+    for (uint32_t id = 1; id < 2000; id += 2) {
+        hash.remove(id);
+    }
+    check(hash.getOccupiedCellCount() == 0, "removing every proxy frees every cell");
+
+    PhysicsSystem physics;
+    physics.setGravity(0.0f);
+    physics.setGridParameters(4.0f, Position(40.0, 40.0, 8.0));
+
+    // Test collision callbacks across a cell boundary
+    std::cout << "\n=== Collision Callback Test ===" << std::endl;
+    auto left = physics.createBody(Position(3.6, 2.0, 2.0));
+    auto right = physics.createBody(Position(4.4, 2.0, 2.0));
+    int enterCount = 0;
+    int stayCount = 0;
+    int exitCount = 0;
+    left->onCollisionEnter = [&enterCount](PhysicsBody*) { enterCount++; };
+    left->onCollisionStay = [&stayCount](PhysicsBody*) { stayCount++; };
+    left->onCollisionExit = [&exitCount](PhysicsBody*) { exitCount++; };
+    physics.update(0.0f);
+    check(enterCount == 1, "bodies in neighbouring cells collide");
+    
+    // Test that a lasting contact enters once, stays every step and exits once
+    std::cout << "\n=== Contact Event Test ===" << std::endl;
+    for (int step = 0; step < 4; step++) {
+        physics.update(0.0f);
+    }
+    check(enterCount == 1, "enter fires once for a lasting contact");
+    check(stayCount == 4, "stay fires on every later step");
+    right->position = Position(20.0, 2.0, 2.0);
+    physics.update(0.0f);
+    physics.update(0.0f);
+    check(exitCount == 1 && stayCount == 4, "exit fires once when the bodies separate");
+    
+    right->position = Position(4.4, 2.0, 2.0);
+    physics.update(0.0f);
+    int partnerExits = 0;
+    right->onCollisionExit = [&partnerExits](PhysicsBody*) { partnerExits++; };
+    physics.removeBody(left);
+    physics.update(0.0f);
+    check(enterCount == 2 && partnerExits == 1, "destroying a body ends its contacts once");
+    check(physics.getContactManager().getActiveContacts().empty(), "no contact outlives its bodies");
+
+    // Test that callbacks may destroy bodies, as pickups and projectiles do
+    std::cout << "\n=== Callback Destroy Test ===" << std::endl;
+    PhysicsSystem scripted;
+    scripted.setGravity(0.0f);
+    BodyHandle player = scripted.spawnBody(Position(0.0, 0.0, 0.0));
+    BodyHandle pickup = scripted.spawnBody(Position(1.0, 0.0, 0.0));
+    BodyHandle arrow = scripted.spawnBody(Position(-1.2, 0.0, 0.0));
+    BodyHandle target = scripted.spawnBody(Position(-2.7, 0.0, 0.0));
+    int playerEnters = 0;
+    int playerExits = 0;
+    scripted.getBody(player)->onCollisionEnter = [&playerEnters](PhysicsBody*) { playerEnters++; };
+    scripted.getBody(player)->onCollisionExit = [&playerExits](PhysicsBody*) { playerExits++; };
+    // The pickup destroys itself; the arrow destroys itself and its target
+    scripted.getBody(pickup)->onCollisionEnter = [&scripted, pickup](PhysicsBody*) { scripted.destroyBody(pickup); };
+    scripted.getBody(arrow)->onCollisionEnter = [&scripted, arrow, target](PhysicsBody* other) {
+        if (other->handle == target) scripted.destroyBody(target);
+        scripted.destroyBody(arrow);
+    };
+    scripted.update(0.0f);
+    check(!scripted.isBodyValid(pickup) && !scripted.isBodyValid(arrow) && !scripted.isBodyValid(target),
+          "bodies destroyed from callbacks are gone after the step");
+    check(scripted.isBodyValid(player) && playerEnters == 2, "every enter of the step still fires");
+    check(playerExits == 2, "partners see one exit per destroyed contact");
+    check(scripted.getContactManager().getActiveContacts().empty(), "no contact outlives a body destroyed from a callback");
+    scripted.update(0.0f);
+    check(playerEnters == 2 && playerExits == 2, "no events for destroyed bodies on the next step");
+
+    // Test that resting islands sleep, skip pair tests and wake as a whole
+    std::cout << "\n=== Sleeping Test ===" << std::endl;
+    PhysicsSystem sleepy;
+    sleepy.setGravity(0.0f);
+    std::vector<BodyHandle> chain;
+    for (int i = 0; i < 5; i++) {
+        chain.push_back(sleepy.spawnBody(Position(i * 1.5, 0.0, 0.0)));
+    }
+    BodyHandle loner = sleepy.spawnBody(Position(50.0, 0.0, 0.0));
+    int chainEnters = 0;
+    int chainExits = 0;
+    sleepy.getBody(chain[0])->onCollisionEnter = [&chainEnters](PhysicsBody*) { chainEnters++; };
+    sleepy.getBody(chain[0])->onCollisionExit = [&chainExits](PhysicsBody*) { chainExits++; };
+    for (int step = 0; step < 60; step++) {
+        sleepy.update(1.0f / 60.0f);
+    }
+    check(sleepy.getLastStepStats().sleepingBodies == 6 && sleepy.isBodySleeping(loner), "resting bodies fall asleep");
+    check(sleepy.getLastStepStats().narrowphaseTests == 0, "sleeping pairs are not tested");
+    check(sleepy.getContactManager().getActiveContacts().size() == 4 && chainEnters == 1 && chainExits == 0,
+          "sleeping contacts persist without new events");
+    
+    sleepy.applyImpulse(chain[4], Position(0.5, 0.0, 0.0));
+    sleepy.update(1.0f / 60.0f);
+    check(!sleepy.isBodySleeping(chain[0]) && sleepy.isBodySleeping(loner), "an impulse wakes the whole island");
+    check(chainExits == 0, "waking does not end contacts");
+    
+    for (int step = 0; step < 120; step++) {
+        sleepy.update(1.0f / 60.0f);
+    }
+    BodyHandle striker = sleepy.spawnBody(Position(42.0, 0.0, 0.0));
+    sleepy.getBody(striker)->velocity = Position(20.0, 0.0, 0.0);
+    for (int step = 0; step < 20; step++) {
+        sleepy.update(1.0f / 60.0f);
+    }
+    check(!sleepy.isBodySleeping(loner), "a moving body wakes the body it touches");
+    
+    // Test the shape-pair table against known configurations
+    std::cout << "\n=== Shape Pair Test ===" << std::endl;
+    ColliderShape unitBox = ColliderShape::box(Position(1, 1, 1));
+    check(testShapes(Position(1.5, 0, 0), ColliderShape::sphere(0.6f), Position(0, 0, 0), unitBox), "sphere touching a box face collides");
+    check(!testShapes(Position(1.5, 1.5, 0), ColliderShape::sphere(0.6f), Position(0, 0, 0), unitBox), "sphere beyond a box edge does not");
+    check(testShapes(Position(0, 0, 0), unitBox, Position(1.5, 0, 0), ColliderShape::sphere(0.6f)), "box-sphere order does not matter");
+    check(testShapes(Position(0, 0, 0), unitBox, Position(2, 0, 0), unitBox), "touching boxes collide");
+    check(!testShapes(Position(0, 0, 0), ColliderShape(), Position(0, 0, 0), unitBox), "shapeless bodies never collide");
+    SphereCollider sphereBuilder(Position(0, 0, 3), 1.0f);
+    AABBCollider boxBuilder(Position(-1, -1, 1.5), Position(1, 1, 2.5));
+    check(sphereBuilder.checkCollision(&boxBuilder), "collider builders test through the table");
+    
+    // Test pooled storage: stale handles, slot reuse and swap-and-pop removal
+    std::cout << "\n=== Body Pool Test ===" << std::endl;
+    PhysicsSystem pool(BroadphaseType::SORT_AND_SWEEP);
+    pool.setGravity(0.0f);
+    std::vector<BodyHandle> handles;
+    for (int i = 0; i < 600; i++) {
+        handles.push_back(pool.spawnBody(Position(i * 3.0, 0.0, 0.0)));
+    }
+    PhysicsBody* survivor = pool.getBody(handles[599]);
+    pool.update(1.0f / 60.0f);
+    for (int i = 0; i < 600; i += 3) {
+        pool.destroyBody(handles[i]);
+    }
+    check(pool.getBodyCount() == 400, "destroyed bodies leave the pool");
+    check(!pool.isBodyValid(handles[0]) && pool.getBody(handles[0]) == nullptr, "handles go stale when their body is destroyed");
+    check(pool.getBody(handles[599]) == survivor, "surviving bodies keep their address");
+    
+    BodyHandle reused = pool.spawnBody(Position(0.5, 0.0, 0.0));
+    check(reused.index == handles[597].index && reused != handles[597], "a reused slot gets a new generation");
+    check(pool.getBody(handles[597]) == nullptr, "old handles do not resolve to the slot's new body");
+    
+    int poolEnters = 0;
+    pool.getBody(handles[1])->onCollisionEnter = [&poolEnters](PhysicsBody*) { poolEnters++; };
+    pool.getBody(reused)->position = Position(3.5, 0.0, 0.0);
+    pool.update(0.0f);
+    check(poolEnters == 1, "sort and sweep sees bodies in reused slots");
+    
+    auto view = pool.createBody(Position(100.0, 0.0, 0.0));
+    check(pool.getBody(view->handle) == view.get(), "legacy shared_ptr bodies are views into the pool");
+    pool.removeBody(view);
+    check(pool.getBodyCount() == 401, "legacy removal destroys the pooled body");
+    
+    std::cout << "\n=== Parallel Step Test ===" << std::endl;
+    JobPool workers(3);
+    for (BroadphaseType type : {BroadphaseType::UNIFORM_GRID, BroadphaseType::SORT_AND_SWEEP}) {
+        PhysicsSystem serial(type);
+        PhysicsSystem parallel(type);
+        parallel.setJobPool(&workers);
+        std::mt19937 sceneRng(21);
+        std::uniform_real_distribution<double> placeRoll(0.0, 60.0);
+        std::uniform_real_distribution<double> driftRoll(-3.0, 3.0);
+        std::vector<BodyHandle> serialHandles, parallelHandles;
+        for (int i = 0; i < 3000; i++) {
+            Position start(placeRoll(sceneRng), placeRoll(sceneRng), placeRoll(sceneRng));
+            Position velocity(driftRoll(sceneRng), driftRoll(sceneRng), driftRoll(sceneRng));
+            for (PhysicsSystem* system : {&serial, &parallel}) {
+                system->setGravity(0.0f);
+                BodyHandle handle = system->spawnBody(start, 1.0f);
+                system->getBody(handle)->velocity = velocity;
+                if (i % 3 == 0) system->setBodyShape(handle, ColliderShape::box(Position(1.5, 0.5, 1.0)));
+                (system == &serial ? serialHandles : parallelHandles).push_back(handle);
+            }
+        }
+        bool sameContacts = true;
+        for (int step = 0; step < 20; step++) {
+            serial.update(1.0f / 60.0f);
+            parallel.update(1.0f / 60.0f);
+            
+            const auto& serialContacts = serial.getContactManager().getActiveContacts();
+            const auto& parallelContacts = parallel.getContactManager().getActiveContacts();
+            if (serialContacts.size() != parallelContacts.size()) {
+                sameContacts = false;
+                continue;
+            }
+            for (size_t i = 0; i < serialContacts.size(); i++) {
+                sameContacts = sameContacts && serialContacts[i].key == parallelContacts[i].key;
+            }
+        }
+        bool samePositions = true;
+        for (size_t i = 0; i < serialHandles.size(); i++) {
+            const PhysicsBody* a = serial.getBody(serialHandles[i]);
+            const PhysicsBody* b = parallel.getBody(parallelHandles[i]);
+            samePositions = samePositions && a->position.getX() == b->position.getX() &&
+                            a->position.getY() == b->position.getY() && a->position.getZ() == b->position.getZ();
+        }
+        const char* name = type == BroadphaseType::UNIFORM_GRID ? "grid" : "sort and sweep";
+        std::cout << name << ": " << serial.getContactManager().getActiveContacts().size() << " contacts" << std::endl;
+        check(sameContacts, std::string(name) + " contacts match the single-threaded step in order");
+        check(samePositions, std::string(name) + " positions match the single-threaded step exactly");
+    }
+
+    std::cout << "\n=== Job Pool Test ===" << std::endl;
+    std::atomic<int> rangesRun(0);
+    bool rethrown = false;
+    try {
+        workers.parallelFor(100, 10, [&rangesRun](size_t begin, size_t, size_t) {
+            if (begin == 50) throw std::runtime_error("range failed");
+            rangesRun.fetch_add(1);
+        });
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    check(rethrown && rangesRun.load() == 9, "a throwing range is rethrown after the others finish");
+
+    // Outside threads share a thread index, so no two may hold it at once
+    std::vector<std::atomic<int>> indexUsers(workers.getThreadCount());
+    std::atomic<bool> indexShared(false);
+    auto submit = [&workers, &indexUsers, &indexShared]() {
+        for (int call = 0; call < 200; call++) {
+            workers.parallelFor(64, 8, [&indexUsers, &indexShared](size_t, size_t, size_t thread) {
+                if (indexUsers[thread].fetch_add(1) != 0) indexShared = true;
+                std::this_thread::yield();
+                indexUsers[thread].fetch_sub(1);
+            });
+        }
+    };
+    std::thread firstSubmitter(submit);
+    std::thread secondSubmitter(submit);
+    firstSubmitter.join();
+    secondSubmitter.join();
+    check(!indexShared.load(), "outside callers never share a thread index at the same time");
+
+    std::cout << "\n=== Contact Solver Test ===" << std::endl;
+    PhysicsSystem bounce;
+    bounce.setGravity(0.0f);
+    BodyHandle light = bounce.spawnBody(Position(0.0, 0.0, 0.0), 1.0f);
+    BodyHandle heavy = bounce.spawnBody(Position(1.9, 0.0, 0.0), 3.0f);
+    for (BodyHandle handle : {light, heavy}) {
+        bounce.getBody(handle)->material = PhysicsMaterial(0.0f, 1.0f);
+        bounce.getBody(handle)->linearDamping = 0.0f;
+    }
+    bounce.getBody(light)->velocity = Position(2.0, 0.0, 0.0);
+    bounce.getBody(heavy)->velocity = Position(-2.0, 0.0, 0.0);
+    bounce.update(1.0f / 60.0f);
+    double lightSpeed = bounce.getBody(light)->velocity.getX();
+    double heavySpeed = bounce.getBody(heavy)->velocity.getX();
+    std::cout << "After impact: " << lightSpeed << ", " << heavySpeed << std::endl;
+    check(std::abs(lightSpeed + 4.0) < 1e-3 && std::abs(heavySpeed) < 1e-3, "elastic impact follows mass and restitution");
+    
+    PhysicsSystem ground;
+    ground.setSleepingEnabled(false);
+    BodyHandle floor = ground.spawnBody(Position(0.0, 0.0, 0.0));
+    ground.setBodyType(floor, BodyType::STATIC);
+    ground.setBodyShape(floor, ColliderShape::box(Position(20.0, 20.0, 1.0)));
+    BodyHandle resting = ground.spawnBody(Position(-5.0, 0.0, 2.5));
+    BodyHandle sliding = ground.spawnBody(Position(5.0, 0.0, 2.0));
+    BodyHandle skating = ground.spawnBody(Position(5.0, 8.0, 2.0));
+    ground.getBody(sliding)->velocity = Position(3.0, 0.0, 0.0);
+    ground.getBody(skating)->velocity = Position(3.0, 0.0, 0.0);
+    ground.getBody(skating)->material.friction = 0.0f;
+    for (int step = 0; step < 120; step++) {
+        ground.update(1.0f / 60.0f);
+    }
+    const PhysicsBody* rested = ground.getBody(resting);
+    std::cout << "Resting height: " << rested->position.getZ() << std::endl;
+    check(rested->position.getZ() > 1.95 && rested->position.getZ() < 2.0 && std::abs(rested->velocity.getZ()) < 0.05,
+          "a body rests on a static floor at its radius");
+    check(ground.getBody(floor)->position == Position(0.0, 0.0, 0.0), "static bodies are not moved by the solver");
+    float floorImpulse = 0.0f;
+    for (const ContactManager::Contact& contact : ground.getContactManager().getActiveContacts()) {
+        if (contact.first == rested || contact.second == rested) floorImpulse = contact.normalImpulse;
+    }
+    check(std::abs(floorImpulse - 9.81f / 60.0f) < 0.01f, "resting contacts keep their impulse for warm starting");
+    check(std::abs(ground.getBody(sliding)->velocity.getX()) < 0.01, "friction stops a sliding body");
+    check(ground.getBody(skating)->velocity.getX() > 2.9, "frictionless bodies keep sliding");
+    
+    PhysicsSystem wide;
+    wide.setGravity(0.0f);
+    BodyHandle wideA = wide.spawnBody(Position(0.0, 0.0, 0.0));
+    BodyHandle wideB = wide.spawnBody(Position(3.0, 0.0, 0.0));
+    wide.setBodyShape(wideA, ColliderShape::sphere(2.0f));
+    wide.setBodyShape(wideB, ColliderShape::sphere(2.0f));
+    for (int step = 0; step < 30; step++) {
+        wide.update(1.0f / 60.0f);
+    }
+    double gap = wide.getBody(wideA)->position.distanceTo(wide.getBody(wideB)->position);
+    std::cout << "Separation of radius 2 spheres: " << gap << std::endl;
+    check(gap > 3.95 && gap < 4.0, "separation uses the collider radii");
+    
+    std::cout << "\n=== Raycast Test ===" << std::endl;
+    PhysicsSystem rays;
+    rays.setGravity(0.0f);
+    BodyHandle farBody = rays.spawnBody(Position(20.0, 0.0, 0.0));
+    BodyHandle nearBody = rays.spawnBody(Position(10.0, 0.0, 0.0));
+    BodyHandle crate = rays.spawnBody(Position(0.0, 15.0, 0.0));
+    rays.setBodyShape(crate, ColliderShape::box(Position(1.0, 2.0, 1.0)));
+    RayHit hit;
+    check(rays.raycast(Ray(Position(0.0, 0.0, 0.0), Position(1.0, 0.0, 0.0), 100.0f), hit) && hit.body == nearBody &&
+          std::abs(hit.distance - 9.0f) < 1e-4f, "raycast returns the nearest body, not the first spawned");
+    check(rays.raycast(Ray(Position(0.0, 0.0, 0.0), Position(0.0, 3.0, 0.0), 100.0f), hit) && hit.body == crate &&
+          std::abs(hit.point.getY() - 13.0) < 1e-6, "rays hit boxes at their faces");
+    check(rays.raycast(Ray(Position(10.0, 0.0, 0.0), Position(1.0, 0.0, 0.0), 100.0f), hit) && hit.body == farBody,
+          "the body containing the ray origin is ignored");
+    check(!rays.raycast(Ray(Position(0.0, 0.0, 0.0), Position(1.0, 0.0, 0.0), 8.5f), hit), "hits beyond maxDistance are ignored");
+    check(!rays.lineOfSight(Position(0.0, 0.0, 0.0), Position(30.0, 0.0, 0.0)) &&
+          rays.lineOfSight(Position(0.0, 5.0, 0.0), Position(30.0, 5.0, 0.0)), "line of sight is blocked only by bodies in the way");
+    check(rays.raycast(Ray(Position(-1e6, 0.0, 0.0), Position(1.0, 0.0, 0.0), std::numeric_limits<float>::infinity()), hit) &&
+          hit.body == nearBody, "unbounded rays still find the nearest body");
+    check(rays.raycast(Ray(Position(0.0, 0.0, 0.0), Position(1.0, 0.0, 0.0)), hit) && hit.body == nearBody,
+          "rays built without a distance are unbounded");
+    
+    // Random rays against a brute-force reference, with bodies spanning several cells
+    PhysicsSystem field;
+    field.setGravity(0.0f);
+    field.setGridParameters(2.0f);
+    std::mt19937 rayRng(31);
+    std::uniform_real_distribution<double> fieldRoll(-40.0, 40.0);
+    std::uniform_real_distribution<double> headingRoll(-1.0, 1.0);
+    std::uniform_int_distribution<int> sizeRoll(0, 9);
+    std::vector<BodyHandle> fieldHandles;
+    for (int i = 0; i < 1500; i++) {
+        BodyHandle handle = field.spawnBody(Position(fieldRoll(rayRng), fieldRoll(rayRng), fieldRoll(rayRng) * 0.25));
+        int size = sizeRoll(rayRng);
+        if (size == 0) field.setBodyShape(handle, ColliderShape::sphere(5.0f));
+        if (size == 1) field.setBodyShape(handle, ColliderShape::box(Position(3.0, 0.5, 1.5)));
+        fieldHandles.push_back(handle);
+    }
+    field.update(1.0f / 60.0f);
+    
+    auto referenceCast = [&](const Ray& ray) {
+        Position direction = ray.direction.normalize();
+        double best = ray.maxDistance;
+        bool found = false;
+        for (BodyHandle handle : fieldHandles) {
+            const PhysicsBody* body = field.getBody(handle);
+            Position offset = body->position - ray.origin;
+            double distance = -1.0;
+            if (body->shape.type == ShapeType::SPHERE) {
+                double projection = offset.dot(direction);
+                double outside = offset.dot(offset) - body->shape.radius * body->shape.radius;
+                double discriminant = projection * projection - outside;
+                if (outside > 0.0 && discriminant >= 0.0) distance = projection - std::sqrt(discriminant);
+            } else {
+                const Position& half = body->shape.halfExtents;
+                distance = intersectRayBox(offset.getX(), offset.getY(), offset.getZ(), half.getX(), half.getY(), half.getZ(),
+                                           direction.getX(), direction.getY(), direction.getZ(), ray.maxDistance);
+            }
+            if (distance > 0.0 && distance < best) {
+                best = distance;
+                found = true;
+            }
+        }
+        return found ? best : -1.0;
+    };
+    
+    std::vector<Ray> batch;
+    for (int i = 0; i < 400; i++) {
+        Position heading(headingRoll(rayRng), headingRoll(rayRng), headingRoll(rayRng) * 0.3);
+        batch.emplace_back(Position(fieldRoll(rayRng), fieldRoll(rayRng), 0.0), heading, i % 2 == 0 ? 30.0f : 120.0f);
+    }
+    std::vector<RayHit> batchHits;
+    field.raycastBatch(batch, batchHits);
+    int mismatches = 0;
+    int batchMismatches = 0;
+    int hits = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+        double expected = referenceCast(batch[i]);
+        RayHit single;
+        bool found = field.raycast(batch[i], single);
+        if (found != (expected >= 0.0) || (found && std::abs(single.distance - expected) > 1e-3)) mismatches++;
+        if (batchHits[i].hit != single.hit || (single.hit && !(batchHits[i].body == single.body))) batchMismatches++;
+        if (found) hits++;
+    }
+    std::cout << hits << " of " << batch.size() << " rays hit" << std::endl;
+    check(mismatches == 0, "grid traversal finds the same nearest hits as a full scan");
+    check(batchMismatches == 0, "raycastBatch matches single raycasts");
+    
+    std::cout << "\n=== Area Query Test ===" << std::endl;
+    std::vector<BodyHandle> found;
+    found.reserve(fieldHandles.size());
+    std::uniform_real_distribution<double> areaRoll(1.0, 12.0);
+    int radiusMismatches = 0;
+    int boxMismatches = 0;
+    for (int i = 0; i < 200; i++) {
+        Position center(fieldRoll(rayRng), fieldRoll(rayRng), fieldRoll(rayRng) * 0.25);
+        float radius = static_cast<float>(areaRoll(rayRng));
+        Position corner = center + Position(areaRoll(rayRng), areaRoll(rayRng), areaRoll(rayRng));
+        
+        std::set<uint32_t> expectedRadius, expectedBox;
+        for (BodyHandle handle : fieldHandles) {
+            const Position& position = field.getBody(handle)->position;
+            if (position.distanceTo(center) <= radius) expectedRadius.insert(handle.index);
+            if (position.getX() >= center.getX() && position.getX() <= corner.getX() &&
+                position.getY() >= center.getY() && position.getY() <= corner.getY() &&
+                position.getZ() >= center.getZ() && position.getZ() <= corner.getZ()) {
+                expectedBox.insert(handle.index);
+            }
+        }
+        
+        field.queryBodiesInRadius(center, radius, found);
+        std::set<uint32_t> gotRadius;
+        for (BodyHandle handle : found) gotRadius.insert(handle.index);
+        if (gotRadius != expectedRadius || found.size() != expectedRadius.size()) radiusMismatches++;
+        
+        field.queryBodiesInAABB(center, corner, found);
+        std::set<uint32_t> gotBox;
+        for (BodyHandle handle : found) gotBox.insert(handle.index);
+        if (gotBox != expectedBox || found.size() != expectedBox.size()) boxMismatches++;
+    }
+    check(radiusMismatches == 0, "radius queries match a full scan, each body once");
+    check(boxMismatches == 0, "AABB queries match a full scan, each body once");
+    check(field.getBodiesInRadius(Position(0.0, 0.0, 0.0), 400.0f).size() == fieldHandles.size(),
+          "queries wider than the grid fall back to a scan");
+    
+    field.update(1.0f / 60.0f);
+    field.queryBodiesInRadius(Position(0.0, 0.0, 0.0), 8.0f, found);  // Refreshes the grid after the step
+    size_t allocationsBefore = allocationCount;
+    size_t visited = 0;
+    for (int i = 0; i < 1000; i++) {
+        Position center(fieldRoll(rayRng), fieldRoll(rayRng), 0.0);
+        field.queryBodiesInRadius(center, 8.0f, found);
+        field.queryBodiesInAABB(center, center + Position(6.0, 6.0, 6.0), found);
+        field.forEachBodyInRadius(center, 8.0f, [&visited](PhysicsBody&) { visited++; });
+    }
+    size_t queryAllocations = allocationCount - allocationsBefore;
+    std::cout << "Allocations during 3000 queries: " << queryAllocations
+              << " (" << visited << " bodies visited)" << std::endl;
+    check(queryAllocations == 0, "area queries do not allocate");
+    
+    std::cout << "\n=== Continuous Collision Test ===" << std::endl;
+    for (BroadphaseType type : {BroadphaseType::UNIFORM_GRID, BroadphaseType::SORT_AND_SWEEP}) {
+        PhysicsSystem range(type);
+        range.setGravity(0.0f);
+        range.setMaxVelocity(400.0f);
+        BodyHandle wall = range.spawnBody(Position(2.0, 0.0, 0.0));
+        range.setBodyType(wall, BodyType::STATIC);
+        range.setBodyShape(wall, ColliderShape::box(Position(0.05, 5.0, 5.0)));
+        BodyHandle post = range.spawnBody(Position(2.0, 20.0, 0.0));
+        range.setBodyType(post, BodyType::STATIC);
+        range.setBodyShape(post, ColliderShape::sphere(0.5f));
+        
+        BodyHandle ghost = range.spawnBody(Position(0.0, -3.0, 0.0));
+        BodyHandle arrow = range.spawnBody(Position(0.0, 3.0, 0.0));
+        BodyHandle bolt = range.spawnBody(Position(-4.0, 20.0, 0.0));
+        BodyHandle stray = range.spawnBody(Position(-4.0, 22.0, 0.0));
+        int arrowHits = 0;
+        range.getBody(arrow)->onCollisionEnter = [&arrowHits](PhysicsBody*) { arrowHits++; };
+        for (BodyHandle handle : {ghost, arrow, bolt, stray}) {
+            range.setBodyShape(handle, ColliderShape::sphere(0.25f));
+            range.getBody(handle)->velocity = Position(handle == ghost || handle == arrow ? 100.0 : 300.0, 0.0, 0.0);
+            if (handle != ghost) range.setBodyFastMoving(handle, true);
+        }
+        
+        // 30 Hz: the arrows move over three units per step
+        PhysicsStepStats firstStep;
+        for (int step = 0; step < 3; step++) {
+            range.update(1.0f / 30.0f);
+            if (step == 0) firstStep = range.getLastStepStats();
+        }
+        const char* name = type == BroadphaseType::UNIFORM_GRID ? "grid" : "sort and sweep";
+        check(firstStep.sweptBodies == 3 && firstStep.sweepHits == 2,
+              std::string(name) + ": step stats count swept bodies and their hits");
+        std::cout << name << ": unswept x " << range.getBody(ghost)->position.getX()
+                  << ", swept x " << range.getBody(arrow)->position.getX() << std::endl;
+        check(range.getBody(ghost)->position.getX() > 2.5, std::string(name) + ": unswept bodies tunnel through thin walls");
+        check(range.getBody(arrow)->position.getX() < 2.0 && arrowHits == 1,
+              std::string(name) + ": fast bodies stop at thin walls and report the contact");
+        check(range.getBody(bolt)->position.getX() < 2.0, std::string(name) + ": fast bodies stop at small spheres");
+        check(range.getBody(stray)->position.getX() > 20.0, std::string(name) + ": fast bodies that miss keep going");
+    }
+    
+    std::cout << "\n=== Test Complete ===" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
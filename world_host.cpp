@@ -0,0 +1,85 @@
+#include "world_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    const size_t TASKS_PER_THREAD = 4;  // Spare tasks per thread so stealing can even out uneven worlds
+}
+
+WorldHost::WorldHost(JobPool* pool, float tickRate)
+    : jobPool(pool), tickRate(tickRate > 0.0f ? tickRate : 60.0f), tickCount(0), worldTicksPerSecond(0.0) {}
+
+void WorldHost::setTickRate(float ticksPerSecond) {
+    if (ticksPerSecond <= 0.0f) return;
+    tickRate = ticksPerSecond;
+    for (auto& world : worlds) {
+        fitSubsteps(*world);
+    }
+}
+
+void WorldHost::fitSubsteps(GameEngine& world) const {
+    // The substep guard drops time from frames that overran. A host tick is
+    // always exactly one step of simulated time, so let worlds spend all of it.
+    world.setMaxSubsteps(static_cast<int>(std::ceil(world.getTickRate() / tickRate)) + 1);
+}
+
+size_t WorldHost::createWorld(float tickRate) {
+    auto world = std::make_unique<GameEngine>(tickRate, true, EngineMode::HEADLESS);
+    world->setTickRate(tickRate);
+    fitSubsteps(*world);
+    worlds.push_back(std::move(world));
+    return worlds.size() - 1;
+}
+
+void WorldHost::tick() {
+    float deltaTime = 1.0f / tickRate;
+    auto tickWorlds = [this, deltaTime](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            GameEngine& world = *worlds[i];
+            if (!world.getIsPaused()) {
+                world.advance(deltaTime);
+            }
+        }
+    };
+
+    if (jobPool) {
+        size_t tasks = jobPool->getThreadCount() * TASKS_PER_THREAD;
+        size_t grainSize = std::max<size_t>((worlds.size() + tasks - 1) / tasks, 1);
+        jobPool->parallelFor(worlds.size(), grainSize, tickWorlds);
+    } else {
+        tickWorlds(0, worlds.size(), 0);
+    }
+    ++tickCount;
+}
+
+double WorldHost::runTicks(uint64_t count, bool paced) {
+    if (paced) {
+        pacer.setTargetFPS(tickRate);
+        pacer.resetStats();
+        pacer.start();
+    }
+
+    uint64_t startTicks = 0;
+    for (const auto& world : worlds) {
+        startTicks += world->getTickCount();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        tick();
+        if (paced) {
+            pacer.waitForNextFrame();
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t worldTicks = 0;
+    for (const auto& world : worlds) {
+        worldTicks += world->getTickCount();
+    }
+    worldTicks -= startTicks;
+    worldTicksPerSecond = elapsed > 0.0 ? worldTicks / elapsed : 0.0;
+    return worldTicksPerSecond;
+}
@@ -0,0 +1,60 @@
+#ifndef WORLD_HOST_H
+#define WORLD_HOST_H
+
+#include "gameengine.h"
+#include "job_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Hosts many independent headless worlds in one process, such as the small
+// dungeon instances of a server. A host tick advances every world by the
+// host's step; each world spends it in ticks of its own fixed length through
+// its accumulator, so worlds at different tick rates stay level in simulated
+// time. Worlds share no mutable state, so each one is a separate task
+// on the shared job pool and a world is only ever touched by one thread at a
+// time. A world's PhysicsSystem may be given the same pool, since
+// parallelFor() can be nested.
+class WorldHost {
+private:
+    std::vector<std::unique_ptr<GameEngine>> worlds;
+    JobPool* jobPool;             // Not owned; null ticks every world on the calling thread
+    float tickRate;               // Host ticks per simulated second
+    FramePacer pacer;             // Paces runTicks to the host tick rate
+    uint64_t tickCount;
+    double worldTicksPerSecond;   // Measured by the last runTicks
+
+    void fitSubsteps(GameEngine& world) const;
+
+public:
+    explicit WorldHost(JobPool* pool = nullptr, float tickRate = 60.0f);
+
+    void setJobPool(JobPool* pool) { jobPool = pool; }
+    JobPool* getJobPool() const { return jobPool; }
+
+    // Length of a host tick is 1 / tickRate seconds; worlds keep their own rates
+    void setTickRate(float ticksPerSecond);
+    float getTickRate() const { return tickRate; }
+
+    // Adds a headless, fixed-step world and returns its index
+    size_t createWorld(float tickRate = 60.0f);
+    GameEngine& getWorld(size_t index) { return *worlds[index]; }
+    const GameEngine& getWorld(size_t index) const { return *worlds[index]; }
+    size_t getWorldCount() const { return worlds.size(); }
+    void clearWorlds() { worlds.clear(); }
+
+    // Advances every unpaused world by one host tick. A world at a higher
+    // rate than the host runs several of its ticks, one at a lower rate
+    // runs a tick only once enough host time has built up.
+    void tick();
+
+    // Runs count host ticks, flat out or paced to the host tick rate, and
+    // returns the world ticks per second achieved
+    double runTicks(uint64_t count, bool paced = false);
+
+    uint64_t getTickCount() const { return tickCount; }
+    double getWorldTicksPerSecond() const { return worldTicksPerSecond; }
+};
+
+#endif // WORLD_HOST_H